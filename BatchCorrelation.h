@@ -0,0 +1,102 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef BatchCorrelation_H
+#define BatchCorrelation_H
+
+// STL
+#include <cstddef> // for size_t
+#include <vector>
+
+// Custom
+#include "TypeTraits.h"
+
+namespace Statistics
+{
+
+/** This class correlates one query vector against many candidate vectors of the same length, e.g. matching
+  * a histogram against a database of histograms. When a candidate is added, it is copied into one contiguous
+  * buffer and its mean and norm (the square root of its sum of squared differences from the mean) are computed
+  * and cached. The query is centered once per call, so each correlation is then a single pass over the
+  * candidate (the co-moment) followed by one division by the cached norms. The results are the same (up to rounding)
+  * as Statistics::Correlation(query, candidate). TVector must be a scalar vector type like std::vector<float>.
+  */
+template <typename TVector>
+class BatchCorrelation
+{
+public:
+
+  typedef typename TypeTraits<TVector>::ComponentType ComponentType;
+  typedef typename TypeTraits<TVector>::LargerComponentType CorrelationType;
+
+  BatchCorrelation();
+
+  /** Add every vector in 'candidates'. */
+  BatchCorrelation(const std::vector<TVector>& candidates);
+
+  /** Add a candidate. Every candidate must have the same length as the first one. */
+  void AddCandidate(const TVector& candidate);
+
+  /** Add every vector in 'candidates'. */
+  void AddCandidates(const std::vector<TVector>& candidates);
+
+  /** Remove every candidate. */
+  void Clear();
+
+  /** Get the number of candidates that have been added. */
+  size_t GetNumberOfCandidates() const;
+
+  /** Get the length of the candidates (0 if none have been added yet). */
+  size_t GetLength() const;
+
+  /** Get the cached mean of a candidate. */
+  double GetMean(const size_t candidateId) const;
+
+  /** Get the cached norm of a candidate. */
+  double GetNorm(const size_t candidateId) const;
+
+  /** Correlate 'query' with one candidate. */
+  CorrelationType CorrelateCandidate(const TVector& query, const size_t candidateId) const;
+
+  /** Correlate 'query' with every candidate, using 'numberOfThreads' threads (0 means every core).
+    * Element i of the result is the correlation with candidate i. */
+  std::vector<CorrelationType> Correlate(const TVector& query, const unsigned int numberOfThreads = 0) const;
+
+private:
+
+  /** Compute the differences of 'query' from its mean, and their norm. */
+  void CenterQuery(const TVector& query, std::vector<double>& centeredQuery, double& queryNorm) const;
+
+  /** Correlate a query that has already been centered with one candidate. */
+  CorrelationType CorrelateCentered(const std::vector<double>& centeredQuery, const double queryNorm,
+                                    const size_t candidateId) const;
+
+  size_t Length;
+
+  /** The candidates, one after the other. */
+  std::vector<ComponentType> Values;
+
+  std::vector<double> Means;
+  std::vector<double> Norms;
+};
+
+} // end namespace
+
+#include "BatchCorrelation.hpp"
+
+#endif
@@ -0,0 +1,233 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef BatchCorrelation_HPP
+#define BatchCorrelation_HPP
+
+// Custom
+#include "BatchCorrelation.h"
+#include "Parallel.h"
+#include "Statistics.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Statistics
+{
+
+template <typename TVector>
+BatchCorrelation<TVector>::BatchCorrelation() : Length(0)
+{
+}
+
+template <typename TVector>
+BatchCorrelation<TVector>::BatchCorrelation(const std::vector<TVector>& candidates) : Length(0)
+{
+  AddCandidates(candidates);
+}
+
+template <typename TVector>
+void BatchCorrelation<TVector>::AddCandidate(const TVector& candidate)
+{
+  if(candidate.size() == 0)
+  {
+    throw std::runtime_error("BatchCorrelation: candidates must not be empty!");
+  }
+
+  if(this->Means.empty())
+  {
+    this->Length = candidate.size();
+  }
+  else if(candidate.size() != this->Length)
+  {
+    throw std::runtime_error("BatchCorrelation: all candidates must have the same length!");
+  }
+
+  // One pass relative to the first value, so that large offsets do not cancel catastrophically.
+  const double shift = candidate[0];
+  double sum = 0.0;
+  double sumOfSquares = 0.0;
+  for(size_t i = 0; i < this->Length; ++i)
+  {
+    const double difference = candidate[i] - shift;
+    sum += difference;
+    sumOfSquares += difference * difference;
+  }
+
+  const double count = static_cast<double>(this->Length);
+  this->Means.push_back(shift + sum / count);
+  this->Norms.push_back(sqrt(std::max(0.0, sumOfSquares - sum * sum / count)));
+  this->Values.insert(this->Values.end(), candidate.begin(), candidate.end());
+}
+
+template <typename TVector>
+void BatchCorrelation<TVector>::AddCandidates(const std::vector<TVector>& candidates)
+{
+  if(!candidates.empty())
+  {
+    this->Values.reserve(this->Values.size() + candidates.size() * candidates[0].size());
+  }
+
+  for(size_t candidateId = 0; candidateId < candidates.size(); ++candidateId)
+  {
+    AddCandidate(candidates[candidateId]);
+  }
+}
+
+template <typename TVector>
+void BatchCorrelation<TVector>::Clear()
+{
+  this->Length = 0;
+  this->Values.clear();
+  this->Means.clear();
+  this->Norms.clear();
+}
+
+template <typename TVector>
+size_t BatchCorrelation<TVector>::GetNumberOfCandidates() const
+{
+  return this->Means.size();
+}
+
+template <typename TVector>
+size_t BatchCorrelation<TVector>::GetLength() const
+{
+  return this->Length;
+}
+
+template <typename TVector>
+double BatchCorrelation<TVector>::GetMean(const size_t candidateId) const
+{
+  return this->Means.at(candidateId);
+}
+
+template <typename TVector>
+double BatchCorrelation<TVector>::GetNorm(const size_t candidateId) const
+{
+  return this->Norms.at(candidateId);
+}
+
+template <typename TVector>
+typename BatchCorrelation<TVector>::CorrelationType
+BatchCorrelation<TVector>::CorrelateCandidate(const TVector& query, const size_t candidateId) const
+{
+  if(candidateId >= GetNumberOfCandidates())
+  {
+    throw std::runtime_error("BatchCorrelation: candidateId is out of range!");
+  }
+
+  std::vector<double> centeredQuery;
+  double queryNorm = 0.0;
+  CenterQuery(query, centeredQuery, queryNorm);
+
+  return CorrelateCentered(centeredQuery, queryNorm, candidateId);
+}
+
+template <typename TVector>
+std::vector<typename BatchCorrelation<TVector>::CorrelationType>
+BatchCorrelation<TVector>::Correlate(const TVector& query, const unsigned int numberOfThreads) const
+{
+  const size_t numberOfCandidates = GetNumberOfCandidates();
+  std::vector<CorrelationType> correlations(numberOfCandidates);
+  if(numberOfCandidates == 0)
+  {
+    return correlations;
+  }
+
+  std::vector<double> centeredQuery;
+  double queryNorm = 0.0;
+  CenterQuery(query, centeredQuery, queryNorm);
+
+  unsigned int numberOfBlocks = Helpers::GetNumberOfThreads(numberOfThreads);
+  if(numberOfCandidates * this->Length < MinimumParallelLength)
+  {
+    numberOfBlocks = 1;
+  }
+
+  Helpers::ParallelForBlocks(numberOfCandidates, numberOfBlocks,
+                             [&](const size_t blockBegin, const size_t blockEnd, const unsigned int)
+  {
+    for(size_t candidateId = blockBegin; candidateId < blockEnd; ++candidateId)
+    {
+      correlations[candidateId] = CorrelateCentered(centeredQuery, queryNorm, candidateId);
+    }
+  });
+
+  return correlations;
+}
+
+template <typename TVector>
+void BatchCorrelation<TVector>::CenterQuery(const TVector& query, std::vector<double>& centeredQuery,
+                                            double& queryNorm) const
+{
+  if(query.size() != this->Length)
+  {
+    throw std::runtime_error("BatchCorrelation: the query must have the same length as the candidates!");
+  }
+
+  double sum = 0.0;
+  for(size_t i = 0; i < this->Length; ++i)
+  {
+    sum += query[i];
+  }
+  const double mean = sum / static_cast<double>(this->Length);
+
+  centeredQuery.resize(this->Length);
+  double sumOfSquares = 0.0;
+  for(size_t i = 0; i < this->Length; ++i)
+  {
+    centeredQuery[i] = query[i] - mean;
+    sumOfSquares += centeredQuery[i] * centeredQuery[i];
+  }
+
+  queryNorm = sqrt(sumOfSquares);
+}
+
+template <typename TVector>
+typename BatchCorrelation<TVector>::CorrelationType
+BatchCorrelation<TVector>::CorrelateCentered(const std::vector<double>& centeredQuery, const double queryNorm,
+                                             const size_t candidateId) const
+{
+  const ComponentType* candidate = &this->Values[candidateId * this->Length];
+  const double mean = this->Means[candidateId];
+
+  // Four independent sums so that consecutive multiply-adds do not wait on each other.
+  double products[4] = {0.0, 0.0, 0.0, 0.0};
+  size_t i = 0;
+  for(; i + 4 <= this->Length; i += 4)
+  {
+    products[0] += centeredQuery[i] * (candidate[i] - mean);
+    products[1] += centeredQuery[i + 1] * (candidate[i + 1] - mean);
+    products[2] += centeredQuery[i + 2] * (candidate[i + 2] - mean);
+    products[3] += centeredQuery[i + 3] * (candidate[i + 3] - mean);
+  }
+  for(; i < this->Length; ++i)
+  {
+    products[0] += centeredQuery[i] * (candidate[i] - mean);
+  }
+
+  const double coMoment = (products[0] + products[1]) + (products[2] + products[3]);
+
+  return static_cast<CorrelationType>(coMoment / (queryNorm * this->Norms[candidateId]));
+}
+
+} // end namespace
+
+#endif
@@ -26,6 +26,12 @@
 namespace Helpers
 {
 
+// Views over existing buffers (defined in StridedView.h). They are declared here so that the length()
+// overloads below are visible to every template that calls Helpers::length().
+template <typename T> class StridedView;
+template <typename T> class PixelView;
+template <typename T> class StridedPixelView;
+
 /** Allow a scalar to be treated as the 0th component of a vector.
   * Return a reference. */
 template<typename T>
@@ -56,6 +62,18 @@ length(const T& t);
 template<typename T>
 unsigned int length(const std::vector<T>& v);
 
+/** The number of elements in a view. */
+template<typename T>
+unsigned int length(const StridedView<T>& v);
+
+/** The number of channels of a single multi-channel element of a view. */
+template<typename T>
+unsigned int length(const PixelView<T>& v);
+
+/** The number of (multi-channel) elements in a view. */
+template<typename T>
+unsigned int length(const StridedPixelView<T>& v);
+
 /** This sets every element of a vector (or the only element if TVector is really a scalar) to zero. */
 template<typename TVector>
 void SetToZero(TVector& v);
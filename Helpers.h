@@ -21,6 +21,7 @@
 
 // STL
 #include <cmath>
+#include <iterator>
 #include <limits> // for epsilon()
 #include <queue>
 #include <string>
@@ -29,7 +30,10 @@
 #include <vector>
 
 // Custom
+#include "Parallel.h"
+#include "Summation.h"
 #include "TypeTraits.h"
+#include "ValidityScan.h"
 
 namespace Helpers
 {
@@ -112,14 +116,51 @@ int RandomInt(const int minValue, const int maxValue);
 template <class T>
 bool IsValidRGB(const T r, const T g, const T b);
 
-/** Determine the index at which the container has the smallest element. */
+/** The smallest and largest elements of a container, and the positions of their first occurrences. */
+template <typename T>
+struct MinMaxResult
+{
+  T Min;
+  T Max;
+  size_t Argmin;
+  size_t Argmax;
+};
+
+/** Find the smallest and largest elements of 'vec', and their (first) positions, in a single pass.
+  * NaNs are ignored, unless every element is NaN (then element 0 is both the minimum and the maximum).
+  * Each block of elements is reduced with independent lanes, which the compiler turns into SIMD
+  * min/max (or compare and blend) instructions; a block is only searched for the position of its
+  * minimum or maximum when it improves on the best one so far. Throws if 'vec' is empty. */
+template <class T>
+MinMaxResult<typename T::value_type> MinMaxWithIndex(const T& vec);
+
+/** Find the smallest and largest of elements [begin, end) of 'vec', as above. */
+template <class T>
+MinMaxResult<typename T::value_type> MinMaxWithIndex(const T& vec, const size_t begin, const size_t end);
+
+/** Find the smallest and largest elements of 'vec' using 'numberOfThreads' threads (0 means every core).
+  * The result is the same as that of the serial version. */
+template <class T>
+MinMaxResult<typename T::value_type> MinMaxWithIndex(const T& vec, const unsigned int numberOfThreads);
+
+/** Determine the index at which the container has the smallest element (0 if it is empty). */
 template <class T>
 unsigned int Argmin(const T& vec);
 
-/** Determine the index at which the container has the largest element. */
+/** Determine the index at which the container has the largest element (0 if it is empty). */
 template <class T>
 unsigned int Argmax(const T& vec);
 
+/** Argmin, using the execution 'policy' (see Parallel.h). */
+template <class TPolicy, class T>
+typename std::enable_if<IsExecutionPolicy<TPolicy>::value, unsigned int>::type
+Argmin(const TPolicy& policy, const T& vec);
+
+/** Argmax, using the execution 'policy' (see Parallel.h). */
+template <class TPolicy, class T>
+typename std::enable_if<IsExecutionPolicy<TPolicy>::value, unsigned int>::type
+Argmax(const TPolicy& policy, const T& vec);
+
 /** Determine the value of the smallest element of a specified 'index' of a collection of multicomponent objects. */
 template <class TContainer>
 typename TypeTraits<typename TContainer::value_type>::ComponentType
@@ -156,14 +197,52 @@ template <class TContainer, typename TOutput>
 void MaxOfAllIndices(const TContainer& container, TOutput& output,
                      typename std::enable_if<std::is_pod<TOutput>::value >::type* = 0);
 
-/** Determine the value of the smallest element. */
+/** Determine both the smallest and the largest value of each index of a collection of multicomponent objects
+  * (e.g. to normalize each channel to its own range) in a single pass. 'minimum' and 'maximum' must be
+  * pre-sized, as for MinOfAllIndices. */
+template <class TContainer, typename TOutput>
+void MinMaxOfAllIndices(const TContainer& container, TOutput& minimum, TOutput& maximum,
+                        typename std::enable_if<!std::is_pod<TOutput>::value >::type* = 0);
+
+/** This is the special version for scalar TOutput. */
+template <class TContainer, typename TOutput>
+void MinMaxOfAllIndices(const TContainer& container, TOutput& minimum, TOutput& maximum,
+                        typename std::enable_if<std::is_pod<TOutput>::value >::type* = 0);
+
+/** Compute the smallest and/or the largest value of each index (into whichever of 'minimum' and 'maximum'
+  * is not null) of a collection of multicomponent objects, reading the container once and allocating nothing.
+  * NaNs are ignored, as in MinMaxWithIndex. Throws if the container is empty. */
+template <class TContainer, typename TOutput>
+void RangeOfAllIndices(const TContainer& container, TOutput* const minimum, TOutput* const maximum);
+
+/** This version of RangeOfAllIndices is used for objects with NumberOfComponents components. It keeps the
+  * running values in local arrays so that the compiler can keep them in (SIMD) registers. */
+template <unsigned int NumberOfComponents, class TContainer, typename TOutput>
+void RangeOfFixedIndices(const TContainer& container, TOutput* const minimum, TOutput* const maximum);
+
+/** This version of RangeOfAllIndices is used for any number of components, and keeps the running values
+  * in the outputs. */
+template <class TContainer, typename TOutput>
+void RangeOfDynamicIndices(const TContainer& container, TOutput* const minimum, TOutput* const maximum);
+
+/** Determine the value of the smallest element. Throws if 'vec' is empty. */
 template <class T>
 typename T::value_type Min(const T& vec);
 
-/** Determine the value of the largest element. */
+/** Determine the value of the largest element. Throws if 'vec' is empty. */
 template <class T>
 typename T::value_type Max(const T& vec);
 
+/** Min, using the execution 'policy' (see Parallel.h). */
+template <class TPolicy, class T>
+typename std::enable_if<IsExecutionPolicy<TPolicy>::value, typename T::value_type>::type
+Min(const TPolicy& policy, const T& vec);
+
+/** Max, using the execution 'policy' (see Parallel.h). */
+template <class TPolicy, class T>
+typename std::enable_if<IsExecutionPolicy<TPolicy>::value, typename T::value_type>::type
+Max(const TPolicy& policy, const T& vec);
+
 /** Divide every element of a vector by the sum of the vector. TVector must model std::vector. */
 template<typename TVector>
 void NormalizeVectorInPlace(TVector& v);
@@ -177,14 +256,32 @@ NormalizeVector(const std::vector<T>& v);
 template<typename T>
 typename T::value_type VectorMedian(T v);
 
-/** Sum the scalar elements in a container. */
+/** Sum the scalar elements in a container. The sum is accumulated (and returned) in the
+  * TypeTraits<>::SumType of the elements, so integers are summed exactly, and floating point values are
+  * summed with AccumulateSum (see Summation.h) using 'method'. */
 template<typename TForwardIterator>
-float Sum(const TForwardIterator first, const TForwardIterator last);
-
-/** Sum the corresponding differences of elements in two containers. */
+typename TypeTraits<typename std::iterator_traits<TForwardIterator>::value_type>::SumType
+Sum(const TForwardIterator first, const TForwardIterator last,
+    const SummationMethod method = SUMMATION_PAIRWISE);
+
+/** Sum, using the execution 'policy' (see Parallel.h). Integer and pairwise sums are identical for every
+  * policy; compensated sums may differ in the last bit. */
+template<typename TPolicy, typename TForwardIterator>
+typename std::enable_if<IsExecutionPolicy<TPolicy>::value,
+  typename TypeTraits<typename std::iterator_traits<TForwardIterator>::value_type>::SumType>::type
+Sum(const TPolicy& policy, const TForwardIterator first, const TForwardIterator last,
+    const SummationMethod method = SUMMATION_PAIRWISE);
+
+/** Sum the absolute differences of corresponding elements in two containers. The differences are
+  * computed and pairwise summed in double precision. */
 template<typename TVector>
 float VectorSumOfAbsoluteDifferences(const TVector& a, const TVector& b);
 
+/** VectorSumOfAbsoluteDifferences, using the execution 'policy' (see Parallel.h). */
+template<typename TPolicy, typename TVector>
+typename std::enable_if<IsExecutionPolicy<TPolicy>::value, float>::type
+VectorSumOfAbsoluteDifferences(const TPolicy& policy, const TVector& a, const TVector& b);
+
 /** Write the elements of 'v' to a space delimited text file called 'filename'. */
 template<typename T>
 void WriteVectorToFile(const std::vector<T> &v, const std::string& filename);
@@ -213,6 +310,11 @@ std::vector<T1> ExtractFirst(const std::vector<std::pair<T1, T2> >& vec);
 template <typename T>
 bool Contains(const std::vector<T>& vec, const T& value);
 
+/** Contains, using the execution 'policy' (see Parallel.h). The threads stop as soon as one finds 'value'. */
+template <typename TPolicy, typename T>
+typename std::enable_if<IsExecutionPolicy<TPolicy>::value, bool>::type
+Contains(const TPolicy& policy, const std::vector<T>& vec, const T& value);
+
 /** Output all of the elements in the vector. */
 template <typename TVector>
 void Output(const TVector& vec);
@@ -226,9 +328,23 @@ unsigned int ClosestIndex(const std::vector<T>& vec, const T& value);
 template <class T>
 bool IsNaN(const T a);
 
-/** Determine if a container contains any NaN values. */
+/** Determine if a container contains any NaN values. Vectors of float and double are scanned with the
+  * vectorized ContainsInvalid (see ValidityScan.h). */
+template <class T>
+bool ContainsNaN(const T& a);
+
+/** ContainsNaN, using the execution 'policy' (see Parallel.h). The threads stop as soon as one finds a NaN. */
+template <class TPolicy, class T>
+typename std::enable_if<IsExecutionPolicy<TPolicy>::value, bool>::type
+ContainsNaN(const TPolicy& policy, const T& a);
+
+/** This version of ContainsNaN is used for containers with a vectorized scan. */
+template <class T>
+bool ContainsNaN(const T& a, const unsigned int numberOfThreads, std::true_type);
+
+/** This version of ContainsNaN is used for other containers. */
 template <class T>
-bool ContainsNaN(const T a);
+bool ContainsNaN(const T& a, const unsigned int numberOfThreads, std::false_type);
 
 /** Keep the top N elements of a priority queue.*/
 template <class TPriorityQueue>
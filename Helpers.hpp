@@ -24,11 +24,13 @@
 #include <cassert>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <limits>
 #include <stdexcept>
 
 #include "TypeTraits.h"
 #include "ContainerInterface.h"
+#include "Parallel.h"
 
 namespace Helpers
 {
@@ -77,53 +79,260 @@ bool IsNaN(const T a)
 }
 
 template <class T>
-bool ContainsNaN(const T a)
+bool ContainsNaN(const T& a)
+{
+  return ContainsNaN(Sequential, a);
+}
+
+template <class TPolicy, class T>
+typename std::enable_if<IsExecutionPolicy<TPolicy>::value, bool>::type
+ContainsNaN(const TPolicy& policy, const T& a)
 {
   static_assert(std::numeric_limits<typename T::value_type>::has_quiet_NaN,
                 "ContainsNaN can only be used with containers whose element type has a NaN value defined!");
 
-  for(unsigned int i = 0; i < a.size(); ++i)
+  return ContainsNaN(a, GetNumberOfThreads(policy), HasValidityKernel<T>());
+}
+
+template <class T>
+bool ContainsNaN(const T& a, const unsigned int numberOfThreads, std::true_type)
+{
+  return ContainsInvalid(a.data(), a.size(), INVALID_NAN, numberOfThreads);
+}
+
+template <class T>
+bool ContainsNaN(const T& a, const unsigned int numberOfThreads, std::false_type)
+{
+  auto rangeContainsNaN = [&a](const size_t begin, const size_t end)
   {
-    if(IsNaN(a[i]))
+    for(size_t i = begin; i < end; ++i)
     {
-      return true;
+      if(IsNaN(a[i]))
+      {
+        return true;
+      }
     }
+    return false;
+  };
+
+  if(a.size() < MinimumParallelLength || GetNumberOfThreads(numberOfThreads) == 1)
+  {
+    return rangeContainsNaN(0, a.size());
   }
-  return false;
+
+  return ParallelAnyOf(a.size(), GetNumberOfThreads(numberOfThreads), rangeContainsNaN);
 }
 
 template <class T>
-unsigned int Argmin(const T& vec)
+MinMaxResult<typename T::value_type> MinMaxWithIndex(const T& vec)
 {
-  typename T::value_type minValue = std::numeric_limits<typename T::value_type>::max();
-  unsigned int minLocation = 0;
-  for(unsigned int i = 0; i < vec.size(); ++i)
+  if(vec.size() == 0)
+  {
+    throw std::runtime_error("MinMaxWithIndex: the container is empty!");
+  }
+
+  return MinMaxWithIndex(vec, 0, vec.size());
+}
+
+template <class T>
+MinMaxResult<typename T::value_type> MinMaxWithIndex(const T& vec, const size_t begin, const size_t end)
+{
+  typedef typename T::value_type ValueType;
+
+  if(end <= begin)
+  {
+    throw std::runtime_error("MinMaxWithIndex: the range is empty!");
+  }
+
+  // Start from the first element that compares equal to itself (i.e. is not a NaN). Every comparison
+  // with a NaN is false, so from then on NaNs are never taken as the minimum or maximum.
+  size_t start = begin;
+  while(start < end && !(vec[start] == vec[start]))
+  {
+    ++start;
+  }
+
+  MinMaxResult<ValueType> result;
+  if(start == end)
+  {
+    result.Min = vec[begin];
+    result.Max = vec[begin];
+    result.Argmin = begin;
+    result.Argmax = begin;
+    return result;
+  }
+
+  result.Min = vec[start];
+  result.Max = vec[start];
+  result.Argmin = start;
+  result.Argmax = start;
+
+  const size_t blockSize = 1024;
+  const unsigned int numberOfLanes = 16;
+
+  for(size_t blockBegin = start + 1; blockBegin < end; blockBegin += blockSize)
+  {
+    const size_t blockEnd = std::min(blockBegin + blockSize, end);
+
+    ValueType minima[numberOfLanes];
+    ValueType maxima[numberOfLanes];
+    for(unsigned int lane = 0; lane < numberOfLanes; ++lane)
+    {
+      minima[lane] = result.Min;
+      maxima[lane] = result.Max;
+    }
+
+    // The lanes are independent, so this loop has no serial dependency chain and can be vectorized.
+    const size_t vectorizedEnd = blockEnd - (blockEnd - blockBegin) % numberOfLanes;
+    for(size_t i = blockBegin; i < vectorizedEnd; i += numberOfLanes)
+    {
+      for(unsigned int lane = 0; lane < numberOfLanes; ++lane)
+      {
+        const ValueType value = vec[i + lane];
+        minima[lane] = value < minima[lane] ? value : minima[lane];
+        maxima[lane] = maxima[lane] < value ? value : maxima[lane];
+      }
+    }
+
+    for(size_t i = vectorizedEnd; i < blockEnd; ++i)
+    {
+      const ValueType value = vec[i];
+      minima[0] = value < minima[0] ? value : minima[0];
+      maxima[0] = maxima[0] < value ? value : maxima[0];
+    }
+
+    ValueType blockMin = minima[0];
+    ValueType blockMax = maxima[0];
+    for(unsigned int lane = 1; lane < numberOfLanes; ++lane)
+    {
+      blockMin = minima[lane] < blockMin ? minima[lane] : blockMin;
+      blockMax = blockMax < maxima[lane] ? maxima[lane] : blockMax;
+    }
+
+    // Only a block that strictly improves on the best value so far can contain the first occurrence of it.
+    if(blockMin < result.Min)
+    {
+      size_t i = blockBegin;
+      while(!(vec[i] == blockMin))
+      {
+        ++i;
+      }
+      result.Min = vec[i];
+      result.Argmin = i;
+    }
+
+    if(result.Max < blockMax)
     {
-    if(vec[i] < minValue)
+      size_t i = blockBegin;
+      while(!(vec[i] == blockMax))
       {
-      minValue = vec[i];
-      minLocation = i;
+        ++i;
       }
+      result.Max = vec[i];
+      result.Argmax = i;
     }
+  }
 
-  return minLocation;
+  return result;
 }
 
 template <class T>
-unsigned int Argmax(const T& vec)
+MinMaxResult<typename T::value_type> MinMaxWithIndex(const T& vec, const unsigned int numberOfThreads)
 {
-  typename T::value_type maxValue = std::numeric_limits<typename T::value_type>::min();
-  unsigned int maxLocation = 0;
-  for(unsigned int i = 0; i < vec.size(); ++i)
+  typedef typename T::value_type ValueType;
+
+  const size_t numberOfElements = vec.size();
+  const unsigned int numberOfBlocks = GetNumberOfThreads(numberOfThreads);
+  if(numberOfElements < MinimumParallelLength || numberOfBlocks == 1)
+  {
+    return MinMaxWithIndex(vec);
+  }
+
+  std::vector<MinMaxResult<ValueType> > blockResults(numberOfBlocks);
+  ParallelForBlocks(numberOfElements, numberOfBlocks,
+                    [&](const size_t blockBegin, const size_t blockEnd, const unsigned int blockId)
+  {
+    blockResults[blockId] = MinMaxWithIndex(vec, blockBegin, blockEnd);
+  });
+
+  // Combine the blocks in order, replacing the result only on a strict improvement, so that (as in the
+  // serial version) the first occurrence wins. Blocks that are entirely NaN compare false and are skipped,
+  // but one of them can only be the starting point if every block is.
+  unsigned int firstBlock = 0;
+  while(firstBlock + 1 < numberOfBlocks && !(blockResults[firstBlock].Min == blockResults[firstBlock].Min))
+  {
+    ++firstBlock;
+  }
+
+  MinMaxResult<ValueType> result = blockResults[firstBlock];
+  if(!(result.Min == result.Min))
+  {
+    // Every element is NaN.
+    return blockResults[0];
+  }
+
+  for(unsigned int blockId = firstBlock + 1; blockId < numberOfBlocks; ++blockId)
+  {
+    if(blockResults[blockId].Min < result.Min)
     {
-    if(vec[i] > maxValue)
-      {
-      maxValue = vec[i];
-      maxLocation = i;
-      }
+      result.Min = blockResults[blockId].Min;
+      result.Argmin = blockResults[blockId].Argmin;
     }
 
-  return maxLocation;
+    if(result.Max < blockResults[blockId].Max)
+    {
+      result.Max = blockResults[blockId].Max;
+      result.Argmax = blockResults[blockId].Argmax;
+    }
+  }
+
+  return result;
+}
+
+template <class T>
+unsigned int Argmin(const T& vec)
+{
+  if(vec.size() == 0)
+  {
+    return 0;
+  }
+
+  return MinMaxWithIndex(vec).Argmin;
+}
+
+template <class T>
+unsigned int Argmax(const T& vec)
+{
+  if(vec.size() == 0)
+  {
+    return 0;
+  }
+
+  return MinMaxWithIndex(vec).Argmax;
+}
+
+template <class TPolicy, class T>
+typename std::enable_if<IsExecutionPolicy<TPolicy>::value, unsigned int>::type
+Argmin(const TPolicy& policy, const T& vec)
+{
+  if(vec.size() == 0)
+  {
+    return 0;
+  }
+
+  return MinMaxWithIndex(vec, GetNumberOfThreads(policy)).Argmin;
+}
+
+template <class TPolicy, class T>
+typename std::enable_if<IsExecutionPolicy<TPolicy>::value, unsigned int>::type
+Argmax(const TPolicy& policy, const T& vec)
+{
+  if(vec.size() == 0)
+  {
+    return 0;
+  }
+
+  return MinMaxWithIndex(vec, GetNumberOfThreads(policy)).Argmax;
 }
 
 template<typename TVector>
@@ -170,29 +379,46 @@ typename T::value_type VectorMedian(T v)
 }
 
 template<typename TForwardIterator>
-float Sum(const TForwardIterator first, const TForwardIterator last)
+typename TypeTraits<typename std::iterator_traits<TForwardIterator>::value_type>::SumType
+Sum(const TForwardIterator first, const TForwardIterator last, const SummationMethod method)
 {
-  float sum = 0.0f;
-  for(TForwardIterator iter = first; iter != last; ++iter)
-  {
-    sum += *iter;
-  }
+  typedef typename TypeTraits<typename std::iterator_traits<TForwardIterator>::value_type>::SumType SumType;
 
-  return sum;
+  return AccumulateSum<SumType>(first, last, method);
+}
+
+template<typename TPolicy, typename TForwardIterator>
+typename std::enable_if<IsExecutionPolicy<TPolicy>::value,
+  typename TypeTraits<typename std::iterator_traits<TForwardIterator>::value_type>::SumType>::type
+Sum(const TPolicy& policy, const TForwardIterator first, const TForwardIterator last, const SummationMethod method)
+{
+  typedef typename TypeTraits<typename std::iterator_traits<TForwardIterator>::value_type>::SumType SumType;
+
+  return AccumulateSum<SumType>(first, last, method, GetNumberOfThreads(policy));
 }
 
 template<typename TVector>
 float VectorSumOfAbsoluteDifferences(const TVector& a, const TVector& b)
+{
+  return VectorSumOfAbsoluteDifferences(Sequential, a, b);
+}
+
+template<typename TPolicy, typename TVector>
+typename std::enable_if<IsExecutionPolicy<TPolicy>::value, float>::type
+VectorSumOfAbsoluteDifferences(const TPolicy& policy, const TVector& a, const TVector& b)
 {
   assert(a.size() == b.size());
 
-  float sum = 0.0f;
-  for(unsigned int i = 0; i < a.size(); ++i)
+  // Sum the differences as they are computed, rather than storing them first.
+  auto absoluteDifference = [&a, &b](const size_t i)
   {
-    sum += fabs(a[i] - b[i]);
-  }
+    return std::abs(static_cast<double>(a[i]) - static_cast<double>(b[i]));
+  };
+  typedef FunctionIterator<decltype(absoluteDifference), double> DifferenceIterator;
 
-  return sum;
+  return static_cast<float>(AccumulateSum<double>(DifferenceIterator(&absoluteDifference, 0),
+                                                  DifferenceIterator(&absoluteDifference, a.size()),
+                                                  SUMMATION_PAIRWISE, GetNumberOfThreads(policy)));
 }
 
 template<typename T>
@@ -256,6 +482,22 @@ bool Contains(const std::vector<T>& vec, const T& value)
   return false;
 }
 
+template <typename TPolicy, typename T>
+typename std::enable_if<IsExecutionPolicy<TPolicy>::value, bool>::type
+Contains(const TPolicy& policy, const std::vector<T>& vec, const T& value)
+{
+  const unsigned int numberOfThreads = GetNumberOfThreads(policy);
+  if(vec.size() < MinimumParallelLength || numberOfThreads == 1)
+  {
+    return Contains(vec, value);
+  }
+
+  return ParallelAnyOf(vec.size(), numberOfThreads, [&vec, &value](const size_t begin, const size_t end)
+  {
+    return std::find(vec.begin() + begin, vec.begin() + end, value) != vec.begin() + end;
+  });
+}
+
 template <typename TVector>
 void Output(const TVector& vec)
 {
@@ -312,45 +554,81 @@ unsigned int ClosestIndex(const std::vector<T>& vec, const T& value)
 template <class T>
 typename T::value_type Min(const T& v)
 {
-  auto minmax = std::minmax_element(v.begin(), v.end());
-
-  return *(minmax.first);
+  return MinMaxWithIndex(v).Min;
 }
 
 template <class T>
 typename T::value_type Max(const T& v)
 {
-  auto minmax = std::minmax_element(v.begin(), v.end());
+  return MinMaxWithIndex(v).Max;
+}
 
-  return *(minmax.second);
+template <class TPolicy, class T>
+typename std::enable_if<IsExecutionPolicy<TPolicy>::value, typename T::value_type>::type
+Min(const TPolicy& policy, const T& vec)
+{
+  return MinMaxWithIndex(vec, GetNumberOfThreads(policy)).Min;
+}
+
+template <class TPolicy, class T>
+typename std::enable_if<IsExecutionPolicy<TPolicy>::value, typename T::value_type>::type
+Max(const TPolicy& policy, const T& vec)
+{
+  return MinMaxWithIndex(vec, GetNumberOfThreads(policy)).Max;
 }
 
 template <class TContainer>
 typename TypeTraits<typename TContainer::value_type>::ComponentType MinOfIndex(const TContainer& container, const unsigned int index)
 {
-  // Create a container for the single component
-  std::vector<typename TypeTraits<typename TContainer::value_type>::ComponentType> componentContainer(container.size());
+  if(container.size() == 0)
+  {
+    throw std::runtime_error("MinOfIndex: the container is empty!");
+  }
 
-  for(size_t i = 0; i < container.size(); ++i)
+  typedef typename TypeTraits<typename TContainer::value_type>::ComponentType ComponentType;
+
+  // Read the component in place rather than copying it out first. Start from its first non-NaN value,
+  // as MinMaxWithIndex does.
+  size_t start = 0;
+  while(start + 1 < container.size() && !(container[start][index] == container[start][index]))
   {
-    componentContainer[i] = container[i][index];
+    ++start;
   }
 
-  return Min(componentContainer);
+  ComponentType minimum = container[start][index];
+  for(size_t i = start + 1; i < container.size(); ++i)
+  {
+    const ComponentType value = container[i][index];
+    minimum = value < minimum ? value : minimum;
+  }
+
+  return minimum;
 }
 
 template <class TContainer>
 typename TypeTraits<typename TContainer::value_type>::ComponentType MaxOfIndex(const TContainer& container, const unsigned int index)
 {
-  // Create a container for the single component
-  std::vector<typename TypeTraits<typename TContainer::value_type>::ComponentType> componentContainer(container.size());
+  if(container.size() == 0)
+  {
+    throw std::runtime_error("MaxOfIndex: the container is empty!");
+  }
+
+  typedef typename TypeTraits<typename TContainer::value_type>::ComponentType ComponentType;
+
+  size_t start = 0;
+  while(start + 1 < container.size() && !(container[start][index] == container[start][index]))
+  {
+    ++start;
+  }
 
-  for(size_t i = 0; i < container.size(); ++i)
+  ComponentType maximum = container[start][index];
+  for(size_t i = start + 1; i < container.size(); ++i)
   {
-    componentContainer[i] = container[i][index];
+    const ComponentType value = container[i][index];
+    maximum = maximum < value ? value : maximum;
   }
 
-  return Max(componentContainer);
+  return maximum;
 }
 
 template <class TPriorityQueue>
@@ -485,11 +763,7 @@ template <typename TContainer, typename TOutput>
 void MinOfAllIndices(const TContainer& container, TOutput& output,
                      typename std::enable_if<!std::is_pod<TOutput>::value >::type*)
 {
-  // Create a container for a single component
-  for(unsigned int component = 0; component < length(container[0]); ++component)
-  {
-    output[component] = MinOfIndex(container, component);
-  }
+  RangeOfAllIndices(container, &output, static_cast<TOutput*>(nullptr));
 }
 
 template <typename TContainer, typename TOutput>
@@ -505,12 +779,7 @@ void MaxOfAllIndices(const TContainer& container, TOutput& output,
 {
   // We cannot return the 'output' because it must be pre-sized and passed in because the
   // sizing procedure is very different for different containers (std::vector, itk::CovariantVector, etc)
-
-  // Create a container for a single component
-  for(unsigned int component = 0; component < length(container[0]); ++component)
-  {
-    output[component] = MaxOfIndex(container, component);
-  }
+  RangeOfAllIndices(container, static_cast<TOutput*>(nullptr), &output);
 }
 
 template <typename TContainer, typename TOutput>
@@ -520,6 +789,141 @@ void MaxOfAllIndices(const TContainer& container, TOutput& output,
   output = Max(container);
 }
 
+template <typename TContainer, typename TOutput>
+void MinMaxOfAllIndices(const TContainer& container, TOutput& minimum, TOutput& maximum,
+                        typename std::enable_if<!std::is_pod<TOutput>::value >::type*)
+{
+  RangeOfAllIndices(container, &minimum, &maximum);
+}
+
+template <typename TContainer, typename TOutput>
+void MinMaxOfAllIndices(const TContainer& container, TOutput& minimum, TOutput& maximum,
+                        typename std::enable_if<std::is_pod<TOutput>::value >::type*)
+{
+  MinMaxResult<typename TContainer::value_type> result = MinMaxWithIndex(container);
+  minimum = result.Min;
+  maximum = result.Max;
+}
+
+template <class TContainer, typename TOutput>
+void RangeOfAllIndices(const TContainer& container, TOutput* const minimum, TOutput* const maximum)
+{
+  if(container.size() == 0)
+  {
+    throw std::runtime_error("RangeOfAllIndices: the container is empty!");
+  }
+
+  switch(length(container[0]))
+  {
+    case 1:
+      RangeOfFixedIndices<1>(container, minimum, maximum);
+      break;
+    case 2:
+      RangeOfFixedIndices<2>(container, minimum, maximum);
+      break;
+    case 3:
+      RangeOfFixedIndices<3>(container, minimum, maximum);
+      break;
+    case 4:
+      RangeOfFixedIndices<4>(container, minimum, maximum);
+      break;
+    default:
+      RangeOfDynamicIndices(container, minimum, maximum);
+      break;
+  }
+}
+
+template <unsigned int NumberOfComponents, class TContainer, typename TOutput>
+void RangeOfFixedIndices(const TContainer& container, TOutput* const minimum, TOutput* const maximum)
+{
+  typedef typename TypeTraits<typename TContainer::value_type>::ComponentType ComponentType;
+
+  const size_t numberOfElements = container.size();
+
+  // Start each component from its first non-NaN value; every comparison with a NaN is false, so from then on
+  // NaNs are never taken.
+  ComponentType minima[NumberOfComponents];
+  ComponentType maxima[NumberOfComponents];
+  for(unsigned int component = 0; component < NumberOfComponents; ++component)
+  {
+    size_t start = 0;
+    while(start + 1 < numberOfElements && !(container[start][component] == container[start][component]))
+    {
+      ++start;
+    }
+    minima[component] = container[start][component];
+    maxima[component] = container[start][component];
+  }
+
+  // Both are always computed (the second comparison is free next to the memory traffic), so that this
+  // loop does not depend on which outputs were requested.
+  for(size_t i = 0; i < numberOfElements; ++i)
+  {
+    const typename TContainer::value_type& element = container[i];
+    for(unsigned int component = 0; component < NumberOfComponents; ++component)
+    {
+      const ComponentType value = element[component];
+      minima[component] = value < minima[component] ? value : minima[component];
+      maxima[component] = maxima[component] < value ? value : maxima[component];
+    }
+  }
+
+  for(unsigned int component = 0; component < NumberOfComponents; ++component)
+  {
+    if(minimum)
+    {
+      (*minimum)[component] = minima[component];
+    }
+    if(maximum)
+    {
+      (*maximum)[component] = maxima[component];
+    }
+  }
+}
+
+template <class TContainer, typename TOutput>
+void RangeOfDynamicIndices(const TContainer& container, TOutput* const minimum, TOutput* const maximum)
+{
+  typedef typename TypeTraits<typename TContainer::value_type>::ComponentType ComponentType;
+
+  const size_t numberOfElements = container.size();
+  const unsigned int numberOfComponents = length(container[0]);
+
+  for(unsigned int component = 0; component < numberOfComponents; ++component)
+  {
+    size_t start = 0;
+    while(start + 1 < numberOfElements && !(container[start][component] == container[start][component]))
+    {
+      ++start;
+    }
+    if(minimum)
+    {
+      (*minimum)[component] = container[start][component];
+    }
+    if(maximum)
+    {
+      (*maximum)[component] = container[start][component];
+    }
+  }
+
+  for(size_t i = 0; i < numberOfElements; ++i)
+  {
+    const typename TContainer::value_type& element = container[i];
+    for(unsigned int component = 0; component < numberOfComponents; ++component)
+    {
+      const ComponentType value = element[component];
+      if(minimum && value < (*minimum)[component])
+      {
+        (*minimum)[component] = value;
+      }
+      if(maximum && (*maximum)[component] < value)
+      {
+        (*maximum)[component] = value;
+      }
+    }
+  }
+}
+
 }// end Helpers namespace
 
 template <typename TComponent>
@@ -0,0 +1,206 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "Histogram.h"
+
+// STL
+#include <stdexcept>
+
+namespace Statistics
+{
+
+Histogram::Histogram(const unsigned int numberOfBins, const double minimum, const double maximum,
+                     const unsigned int numberOfChannels)
+{
+  if(numberOfBins == 0 || !(maximum > minimum))
+  {
+    throw std::runtime_error("Histogram: there must be at least one bin, and maximum must be larger than minimum!");
+  }
+
+  std::vector<double> edges(numberOfBins + 1);
+  for(unsigned int edge = 0; edge <= numberOfBins; ++edge)
+  {
+    edges[edge] = minimum + (maximum - minimum) * static_cast<double>(edge) / static_cast<double>(numberOfBins);
+  }
+
+  this->Edges.assign(numberOfChannels, edges);
+  this->FixedWidth.assign(numberOfChannels, true);
+  Initialize();
+}
+
+Histogram::Histogram(const std::vector<double>& edges, const unsigned int numberOfChannels)
+{
+  this->Edges.assign(numberOfChannels, edges);
+  this->FixedWidth.assign(numberOfChannels, false);
+  Initialize();
+}
+
+Histogram::Histogram(const std::vector<std::vector<double> >& edges)
+{
+  this->Edges = edges;
+  this->FixedWidth.assign(edges.size(), false);
+  Initialize();
+}
+
+void Histogram::Initialize()
+{
+  const unsigned int numberOfChannels = this->Edges.size();
+  if(numberOfChannels == 0)
+  {
+    throw std::runtime_error("Histogram: there must be at least one channel!");
+  }
+
+  this->Scale.assign(numberOfChannels, 0.0);
+  this->Strides.assign(numberOfChannels, 1);
+
+  size_t numberOfBins = 1;
+  for(int channel = numberOfChannels - 1; channel >= 0; --channel)
+  {
+    const std::vector<double>& edges = this->Edges[channel];
+    if(edges.size() < 2)
+    {
+      throw std::runtime_error("Histogram: every channel needs at least 2 edges!");
+    }
+
+    for(size_t edge = 1; edge < edges.size(); ++edge)
+    {
+      if(!(edges[edge] > edges[edge - 1]))
+      {
+        throw std::runtime_error("Histogram: the edges must be strictly increasing!");
+      }
+    }
+
+    if(this->FixedWidth[channel])
+    {
+      this->Scale[channel] = static_cast<double>(edges.size() - 1) / (edges.back() - edges.front());
+    }
+
+    // The last channel varies fastest.
+    this->Strides[channel] = numberOfBins;
+    numberOfBins *= edges.size() - 1;
+  }
+
+  this->Counts.assign(numberOfBins, 0.0);
+  this->Total = 0.0;
+  this->NumberOfOutliers = 0;
+}
+
+void Histogram::Merge(const Histogram& other)
+{
+  if(!HasSameBins(other))
+  {
+    throw std::runtime_error("Histogram::Merge: the histograms must have the same bins!");
+  }
+
+  for(size_t bin = 0; bin < this->Counts.size(); ++bin)
+  {
+    this->Counts[bin] += other.Counts[bin];
+  }
+  this->Total += other.Total;
+  this->NumberOfOutliers += other.NumberOfOutliers;
+}
+
+void Histogram::Clear()
+{
+  this->Counts.assign(this->Counts.size(), 0.0);
+  this->Total = 0.0;
+  this->NumberOfOutliers = 0;
+}
+
+unsigned int Histogram::GetNumberOfChannels() const
+{
+  return this->Edges.size();
+}
+
+size_t Histogram::GetNumberOfBins() const
+{
+  return this->Counts.size();
+}
+
+unsigned int Histogram::GetNumberOfBins(const unsigned int channel) const
+{
+  return this->Edges.at(channel).size() - 1;
+}
+
+const std::vector<double>& Histogram::GetEdges(const unsigned int channel) const
+{
+  return this->Edges.at(channel);
+}
+
+const Histogram::CountVectorType& Histogram::GetCounts() const
+{
+  return this->Counts;
+}
+
+double Histogram::GetCount(const size_t bin) const
+{
+  return this->Counts.at(bin);
+}
+
+Histogram::CountVectorType Histogram::GetNormalizedCounts() const
+{
+  if(this->Total <= 0.0)
+  {
+    throw std::runtime_error("Histogram: cannot normalize an empty histogram!");
+  }
+
+  CountVectorType normalizedCounts(this->Counts.size());
+  for(size_t bin = 0; bin < this->Counts.size(); ++bin)
+  {
+    normalizedCounts[bin] = this->Counts[bin] / this->Total;
+  }
+  return normalizedCounts;
+}
+
+double Histogram::GetTotal() const
+{
+  return this->Total;
+}
+
+size_t Histogram::GetNumberOfOutliers() const
+{
+  return this->NumberOfOutliers;
+}
+
+bool Histogram::HasSameBins(const Histogram& other) const
+{
+  return this->Edges == other.Edges;
+}
+
+double CompareHistograms(const Histogram& a, const Histogram& b, const HistogramComparisonMethod method)
+{
+  if(!a.HasSameBins(b))
+  {
+    throw std::runtime_error("CompareHistograms: the histograms must have the same bins!");
+  }
+
+  if(method == HISTOGRAM_EARTH_MOVERS)
+  {
+    if(a.GetNumberOfChannels() != 1)
+    {
+      throw std::runtime_error("CompareHistograms: the earth mover's distance is only defined for 1 channel histograms!");
+    }
+
+    // The totals are already known, so this only needs one pass.
+    return EarthMoversDistance(a.GetCounts(), b.GetCounts(), a.GetTotal(), b.GetTotal());
+  }
+
+  return CompareHistograms(a.GetCounts(), b.GetCounts(), method);
+}
+
+} // end namespace
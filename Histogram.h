@@ -0,0 +1,178 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef Histogram_H
+#define Histogram_H
+
+// STL
+#include <cstddef> // for size_t
+#include <type_traits>
+#include <vector>
+
+namespace Statistics
+{
+
+/** The ways two histograms can be compared with CompareHistograms. These follow OpenCV's compareHist:
+  * http://docs.opencv.org/doc/tutorials/imgproc/histograms/histogram_comparison/histogram_comparison.html
+  */
+enum HistogramComparisonMethod
+{
+  /** The Pearson correlation of the bin counts (1 is a perfect match). */
+  HISTOGRAM_CORRELATION,
+
+  /** sum_i (a_i - b_i)^2 / a_i over the bins where a_i > 0 (0 is a perfect match). */
+  HISTOGRAM_CHI_SQUARE,
+
+  /** sum_i min(a_i, b_i) (larger is a better match). */
+  HISTOGRAM_INTERSECTION,
+
+  /** sqrt(1 - sum_i sqrt(a_i b_i) / sqrt(sum_i a_i sum_i b_i)) (0 is a perfect match). */
+  HISTOGRAM_BHATTACHARYYA,
+
+  /** The 1D earth mover's distance between the normalized histograms, measured in bins:
+    * sum_i |A_i - B_i|, where A and B are the cumulative sums of the normalized histograms. */
+  HISTOGRAM_EARTH_MOVERS
+};
+
+/** This class counts how many values fall into each bin. The bins of each channel are either 'numberOfBins'
+  * bins of equal width over [minimum, maximum], or are given by a sorted list of edges (bin i is
+  * [edges[i], edges[i+1]) ). The last bin also includes its upper edge, and values outside of the edges
+  * (and NaNs) are counted as outliers rather than being put in a bin.
+  * With more than one channel, the histogram is joint: each multi-component value (e.g. an RGB pixel)
+  * is put in the one bin given by the bins of all of its components, so there are the product of the
+  * per-channel bin counts bins in total. The bins are stored with the last channel varying fastest.
+  */
+class Histogram
+{
+public:
+
+  typedef std::vector<double> CountVectorType;
+
+  /** Create 'numberOfBins' bins of equal width over [minimum, maximum] for each of 'numberOfChannels' channels. */
+  Histogram(const unsigned int numberOfBins, const double minimum, const double maximum,
+            const unsigned int numberOfChannels = 1);
+
+  /** Create bins with the same 'edges' (sorted, at least 2) for each of 'numberOfChannels' channels. */
+  Histogram(const std::vector<double>& edges, const unsigned int numberOfChannels = 1);
+
+  /** Create bins with different edges for each channel (one list of edges per channel). */
+  Histogram(const std::vector<std::vector<double> >& edges);
+
+  /** Count every value in 'data'. The values may be scalars (for a 1 channel histogram) or multi-component
+    * values with GetNumberOfChannels() components. The data is split across 'numberOfThreads' threads
+    * (0 means every core), each of which counts into its own histogram, and these are added at the end.
+    * unsigned char data uses a lookup table from each of the 256 possible values to its bin. */
+  template <typename TVector>
+  void Add(const TVector& data, const unsigned int numberOfThreads = 0);
+
+  /** Add the counts of 'other', which must have the same bins. */
+  void Merge(const Histogram& other);
+
+  /** Set every count to 0. */
+  void Clear();
+
+  /** Get the number of channels. */
+  unsigned int GetNumberOfChannels() const;
+
+  /** Get the total number of bins. */
+  size_t GetNumberOfBins() const;
+
+  /** Get the number of bins of one channel. */
+  unsigned int GetNumberOfBins(const unsigned int channel) const;
+
+  /** Get the edges of the bins of one channel. */
+  const std::vector<double>& GetEdges(const unsigned int channel) const;
+
+  /** Determine which bin of 'channel' a value falls into, or -1 if it is outside of the edges (or is NaN). */
+  inline int GetBinIndex(const unsigned int channel, const double value) const;
+
+  /** Get the count of every bin. */
+  const CountVectorType& GetCounts() const;
+
+  /** Get the count of one bin. */
+  double GetCount(const size_t bin) const;
+
+  /** Get the counts divided by their total, so that they sum to 1. */
+  CountVectorType GetNormalizedCounts() const;
+
+  /** Get the number of values that were put in a bin. */
+  double GetTotal() const;
+
+  /** Get the number of values that were outside of the edges. */
+  size_t GetNumberOfOutliers() const;
+
+  /** Determine if 'other' has the same bins as this histogram. */
+  bool HasSameBins(const Histogram& other) const;
+
+private:
+
+  /** Compute the strides and the fixed-width scale factors, and allocate the counts. */
+  void Initialize();
+
+  /** Count the values [begin, end) of 'data' into 'counts'. */
+  template <typename TVector>
+  void CountValues(const TVector& data, const size_t begin, const size_t end,
+                   std::vector<size_t>& counts, size_t& numberOfOutliers, std::false_type) const;
+
+  /** Count the unsigned char values [begin, end) of 'data' into 'counts' with a lookup table. */
+  template <typename TVector>
+  void CountValues(const TVector& data, const size_t begin, const size_t end,
+                   std::vector<size_t>& counts, size_t& numberOfOutliers, std::true_type) const;
+
+  /** Split the values of 'data' across threads and count them with the CountValues for 'isByte'. */
+  template <typename TVector, typename TIsByte>
+  void AddInternal(const TVector& data, const unsigned int numberOfThreads, TIsByte isByte);
+
+  /** The edges of the bins of each channel. */
+  std::vector<std::vector<double> > Edges;
+
+  /** Whether the bins of each channel all have the same width (so the bin can be computed directly). */
+  std::vector<bool> FixedWidth;
+
+  /** For fixed width channels, the number of bins divided by (maximum - minimum). */
+  std::vector<double> Scale;
+
+  /** How far apart consecutive bins of each channel are in Counts. */
+  std::vector<size_t> Strides;
+
+  CountVectorType Counts;
+
+  double Total;
+
+  size_t NumberOfOutliers;
+};
+
+/** Compare two histograms with 'method'. They must have the same bins. */
+double CompareHistograms(const Histogram& a, const Histogram& b, const HistogramComparisonMethod method);
+
+/** Compare two histograms that are stored as vectors of counts with 'method'. They must have the same length.
+  * Each method is computed in a single pass over the counts, except HISTOGRAM_EARTH_MOVERS, which
+  * needs the totals of both histograms first. */
+template <typename TVector>
+double CompareHistograms(const TVector& a, const TVector& b, const HistogramComparisonMethod method);
+
+/** Compute the 1D earth mover's distance (in bins) between two histograms whose totals are already known,
+  * in a single pass. */
+template <typename TVector>
+double EarthMoversDistance(const TVector& a, const TVector& b, const double totalA, const double totalB);
+
+} // end namespace
+
+#include "Histogram.hpp"
+
+#endif
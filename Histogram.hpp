@@ -0,0 +1,315 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef Histogram_HPP
+#define Histogram_HPP
+
+// Custom
+#include "Histogram.h"
+#include "ContainerInterface.h"
+#include "Parallel.h"
+#include "Statistics.h"
+#include "TypeTraits.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Statistics
+{
+
+inline int Histogram::GetBinIndex(const unsigned int channel, const double value) const
+{
+  const std::vector<double>& edges = this->Edges[channel];
+
+  // Written this way so that NaN is an outlier too.
+  if(!(value >= edges.front() && value <= edges.back()))
+  {
+    return -1;
+  }
+
+  const int lastBin = static_cast<int>(edges.size()) - 2;
+  int bin = 0;
+  if(this->FixedWidth[channel])
+  {
+    bin = static_cast<int>((value - edges.front()) * this->Scale[channel]);
+  }
+  else
+  {
+    bin = static_cast<int>(std::upper_bound(edges.begin(), edges.end(), value) - edges.begin()) - 1;
+  }
+
+  // The maximum is in the last bin.
+  return std::min(bin, lastBin);
+}
+
+template <typename TVector>
+void Histogram::Add(const TVector& data, const unsigned int numberOfThreads)
+{
+  if(Helpers::length(data) == 0)
+  {
+    return;
+  }
+
+  if(Helpers::length(data[0]) != GetNumberOfChannels())
+  {
+    throw std::runtime_error("Histogram: the values must have one component per channel!");
+  }
+
+  typedef typename TypeTraits<typename TVector::value_type>::ComponentType ComponentType;
+  AddInternal(data, numberOfThreads, std::is_same<ComponentType, unsigned char>());
+}
+
+template <typename TVector, typename TIsByte>
+void Histogram::AddInternal(const TVector& data, const unsigned int numberOfThreads, TIsByte isByte)
+{
+  const size_t numberOfValues = Helpers::length(data);
+  unsigned int numberOfBlocks = Helpers::GetNumberOfThreads(numberOfThreads);
+  if(numberOfValues < MinimumParallelLength)
+  {
+    numberOfBlocks = 1;
+  }
+
+  // Each block counts into its own histogram, so the threads never write to the same memory.
+  std::vector<std::vector<size_t> > blockCounts(numberOfBlocks);
+  std::vector<size_t> blockOutliers(numberOfBlocks, 0);
+  Helpers::ParallelForBlocks(numberOfValues, numberOfBlocks,
+                             [&](const size_t blockBegin, const size_t blockEnd, const unsigned int blockId)
+  {
+    blockCounts[blockId].assign(this->Counts.size(), 0);
+    CountValues(data, blockBegin, blockEnd, blockCounts[blockId], blockOutliers[blockId], isByte);
+  });
+
+  for(unsigned int blockId = 0; blockId < numberOfBlocks; ++blockId)
+  {
+    // Blocks that ParallelForBlocks did not need (too few values) were never assigned.
+    for(size_t bin = 0; bin < blockCounts[blockId].size(); ++bin)
+    {
+      this->Counts[bin] += blockCounts[blockId][bin];
+    }
+    this->NumberOfOutliers += blockOutliers[blockId];
+  }
+
+  this->Total = 0.0;
+  for(size_t bin = 0; bin < this->Counts.size(); ++bin)
+  {
+    this->Total += this->Counts[bin];
+  }
+}
+
+template <typename TVector>
+void Histogram::CountValues(const TVector& data, const size_t begin, const size_t end,
+                            std::vector<size_t>& counts, size_t& numberOfOutliers, std::false_type) const
+{
+  const unsigned int numberOfChannels = GetNumberOfChannels();
+  for(size_t i = begin; i < end; ++i)
+  {
+    size_t bin = 0;
+    bool inside = true;
+    for(unsigned int channel = 0; channel < numberOfChannels; ++channel)
+    {
+      const int channelBin = GetBinIndex(channel, Helpers::index(data[i], channel));
+      if(channelBin < 0)
+      {
+        inside = false;
+        break;
+      }
+      bin += channelBin * this->Strides[channel];
+    }
+
+    if(inside)
+    {
+      counts[bin]++;
+    }
+    else
+    {
+      numberOfOutliers++;
+    }
+  }
+}
+
+template <typename TVector>
+void Histogram::CountValues(const TVector& data, const size_t begin, const size_t end,
+                            std::vector<size_t>& counts, size_t& numberOfOutliers, std::true_type) const
+{
+  // Look up the offset into the counts of every possible value of every channel (-1 for outliers),
+  // so that no value needs a division or a search.
+  const unsigned int numberOfChannels = GetNumberOfChannels();
+  std::vector<ptrdiff_t> lookup(numberOfChannels * 256);
+  for(unsigned int channel = 0; channel < numberOfChannels; ++channel)
+  {
+    for(unsigned int value = 0; value < 256; ++value)
+    {
+      const int channelBin = GetBinIndex(channel, value);
+      lookup[channel * 256 + value] = (channelBin < 0) ? -1 : channelBin * static_cast<ptrdiff_t>(this->Strides[channel]);
+    }
+  }
+
+  if(numberOfChannels == 1)
+  {
+    // Runs of equal values (common in images) would make every increment wait on the previous one,
+    // so alternate between four copies of the counts and add them up at the end.
+    const size_t numberOfBins = counts.size();
+    std::vector<size_t> partialCounts(4 * numberOfBins, 0);
+    std::vector<size_t> partialOutliers(4, 0);
+    for(size_t i = begin; i < end; ++i)
+    {
+      const unsigned int copy = i & 3;
+      const ptrdiff_t bin = lookup[Helpers::index(data[i], 0)];
+      if(bin >= 0)
+      {
+        partialCounts[copy * numberOfBins + bin]++;
+      }
+      else
+      {
+        partialOutliers[copy]++;
+      }
+    }
+
+    for(unsigned int copy = 0; copy < 4; ++copy)
+    {
+      for(size_t bin = 0; bin < numberOfBins; ++bin)
+      {
+        counts[bin] += partialCounts[copy * numberOfBins + bin];
+      }
+      numberOfOutliers += partialOutliers[copy];
+    }
+    return;
+  }
+
+  for(size_t i = begin; i < end; ++i)
+  {
+    ptrdiff_t bin = 0;
+    bool inside = true;
+    for(unsigned int channel = 0; channel < numberOfChannels; ++channel)
+    {
+      const ptrdiff_t channelOffset = lookup[channel * 256 + Helpers::index(data[i], channel)];
+      if(channelOffset < 0)
+      {
+        inside = false;
+        break;
+      }
+      bin += channelOffset;
+    }
+
+    if(inside)
+    {
+      counts[bin]++;
+    }
+    else
+    {
+      numberOfOutliers++;
+    }
+  }
+}
+
+template <typename TVector>
+double CompareHistograms(const TVector& a, const TVector& b, const HistogramComparisonMethod method)
+{
+  const size_t numberOfBins = Helpers::length(a);
+  if(Helpers::length(b) != numberOfBins)
+  {
+    throw std::runtime_error("CompareHistograms: the histograms must have the same number of bins!");
+  }
+
+  switch(method)
+  {
+    case HISTOGRAM_CORRELATION:
+    {
+      return Correlation(a, b);
+    }
+    case HISTOGRAM_CHI_SQUARE:
+    {
+      double chiSquare = 0.0;
+      for(size_t bin = 0; bin < numberOfBins; ++bin)
+      {
+        const double countA = a[bin];
+        if(countA > 0.0)
+        {
+          const double difference = countA - b[bin];
+          chiSquare += difference * difference / countA;
+        }
+      }
+      return chiSquare;
+    }
+    case HISTOGRAM_INTERSECTION:
+    {
+      double intersection = 0.0;
+      for(size_t bin = 0; bin < numberOfBins; ++bin)
+      {
+        intersection += std::min(static_cast<double>(a[bin]), static_cast<double>(b[bin]));
+      }
+      return intersection;
+    }
+    case HISTOGRAM_BHATTACHARYYA:
+    {
+      double totalA = 0.0;
+      double totalB = 0.0;
+      double coefficient = 0.0;
+      for(size_t bin = 0; bin < numberOfBins; ++bin)
+      {
+        const double countA = a[bin];
+        const double countB = b[bin];
+        totalA += countA;
+        totalB += countB;
+        coefficient += sqrt(countA * countB);
+      }
+      // Rounding can make the coefficient very slightly larger than 1 for identical histograms.
+      return sqrt(std::max(0.0, 1.0 - coefficient / sqrt(totalA * totalB)));
+    }
+    case HISTOGRAM_EARTH_MOVERS:
+    {
+      double totalA = 0.0;
+      double totalB = 0.0;
+      for(size_t bin = 0; bin < numberOfBins; ++bin)
+      {
+        totalA += a[bin];
+        totalB += b[bin];
+      }
+      return EarthMoversDistance(a, b, totalA, totalB);
+    }
+    default:
+      throw std::runtime_error("CompareHistograms: unknown comparison method!");
+  }
+}
+
+template <typename TVector>
+double EarthMoversDistance(const TVector& a, const TVector& b, const double totalA, const double totalB)
+{
+  if(totalA <= 0.0 || totalB <= 0.0)
+  {
+    throw std::runtime_error("EarthMoversDistance: the histograms must not be empty!");
+  }
+
+  // The mass that has to cross the boundary after each bin is the difference of the cumulative sums.
+  double cumulativeA = 0.0;
+  double cumulativeB = 0.0;
+  double distance = 0.0;
+  for(size_t bin = 0; bin < Helpers::length(a); ++bin)
+  {
+    cumulativeA += a[bin] / totalA;
+    cumulativeB += b[bin] / totalB;
+    distance += std::abs(cumulativeA - cumulativeB);
+  }
+  return distance;
+}
+
+} // end namespace
+
+#endif
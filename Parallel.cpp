@@ -0,0 +1,215 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "Parallel.h"
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace Helpers
+{
+
+unsigned int GetNumberOfThreads(const unsigned int requestedNumberOfThreads)
+{
+  if(requestedNumberOfThreads > 0)
+  {
+    return requestedNumberOfThreads;
+  }
+
+  // hardware_concurrency() is allowed to return 0 if it cannot determine the number of cores.
+  unsigned int numberOfCores = std::thread::hardware_concurrency();
+  if(numberOfCores == 0)
+  {
+    return 1;
+  }
+
+  return numberOfCores;
+}
+
+size_t BlockBegin(const size_t numberOfItems, const unsigned int numberOfBlocks, const unsigned int blockId)
+{
+  // Spread the remainder over the first blocks so that block sizes differ by at most 1.
+  const size_t blockSize = numberOfItems / numberOfBlocks;
+  const size_t remainder = numberOfItems % numberOfBlocks;
+  if(blockId < remainder)
+  {
+    return blockId * (blockSize + 1);
+  }
+  return blockId * blockSize + remainder;
+}
+
+unsigned int GetNumberOfThreads(const SequentialExecutionPolicy&)
+{
+  return 1;
+}
+
+unsigned int GetNumberOfThreads(const ParallelExecutionPolicy&)
+{
+  return GetNumberOfThreads(0);
+}
+
+unsigned int GetNumberOfThreads(const ParallelVectorizedExecutionPolicy&)
+{
+  return GetNumberOfThreads(0);
+}
+
+ThreadPool::ThreadPool(const unsigned int numberOfThreads) : Stopping(false)
+{
+  this->Threads.reserve(numberOfThreads);
+  for(unsigned int i = 0; i < numberOfThreads; ++i)
+  {
+    this->Threads.push_back(std::thread(&ThreadPool::Work, this));
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Stopping = true;
+  }
+  this->TaskAvailable.notify_all();
+
+  for(size_t i = 0; i < this->Threads.size(); ++i)
+  {
+    this->Threads[i].join();
+  }
+}
+
+void ThreadPool::Submit(const std::function<void()>& task)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Tasks.push(task);
+  }
+  this->TaskAvailable.notify_one();
+}
+
+unsigned int ThreadPool::GetNumberOfThreads() const
+{
+  return this->Threads.size();
+}
+
+void ThreadPool::Work()
+{
+  while(true)
+  {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(this->Mutex);
+      this->TaskAvailable.wait(lock, [this]() { return this->Stopping || !this->Tasks.empty(); });
+
+      // Finish the queued tasks before stopping.
+      if(this->Tasks.empty())
+      {
+        return;
+      }
+
+      task = this->Tasks.front();
+      this->Tasks.pop();
+    }
+
+    task();
+  }
+}
+
+ThreadPool& GetSharedThreadPool()
+{
+  // Constructed on first use (thread safely, since C++11) and joined at exit.
+  static ThreadPool pool(GetNumberOfThreads(0) - 1);
+  return pool;
+}
+
+/** The blocks of one ParallelForBlockIds call. Pool threads can still be holding it after the call has
+  * returned (they find no blocks left and do nothing), so it is reference counted. */
+struct BlockQueue
+{
+  BlockQueue(const unsigned int numberOfBlocks, const std::function<void(const unsigned int)>* runBlock) :
+    NextBlock(0), NumberOfBlocks(numberOfBlocks), NumberOfCompletedBlocks(0), RunBlock(runBlock) {}
+
+  std::atomic<unsigned int> NextBlock;
+  const unsigned int NumberOfBlocks;
+
+  std::mutex Mutex;
+  std::condition_variable AllBlocksCompleted;
+  unsigned int NumberOfCompletedBlocks;
+  std::exception_ptr Exception;
+
+  /** Only dereferenced while a block is being run, i.e. before ParallelForBlockIds returns. */
+  const std::function<void(const unsigned int)>* RunBlock;
+};
+
+/** Run blocks from 'queue' until there are none left. */
+static void RunQueuedBlocks(BlockQueue& queue)
+{
+  while(true)
+  {
+    const unsigned int blockId = queue.NextBlock++;
+    if(blockId >= queue.NumberOfBlocks)
+    {
+      return;
+    }
+
+    std::exception_ptr exception;
+    try
+    {
+      (*queue.RunBlock)(blockId);
+    }
+    catch(...)
+    {
+      exception = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock(queue.Mutex);
+    if(exception && !queue.Exception)
+    {
+      queue.Exception = exception;
+    }
+    if(++queue.NumberOfCompletedBlocks == queue.NumberOfBlocks)
+    {
+      queue.AllBlocksCompleted.notify_all();
+    }
+  }
+}
+
+void ParallelForBlockIds(const unsigned int numberOfBlocks, const std::function<void(const unsigned int)>& runBlock)
+{
+  std::shared_ptr<BlockQueue> queue = std::make_shared<BlockQueue>(numberOfBlocks, &runBlock);
+
+  ThreadPool& pool = GetSharedThreadPool();
+  const unsigned int numberOfHelpers = std::min(numberOfBlocks - 1, pool.GetNumberOfThreads());
+  for(unsigned int helper = 0; helper < numberOfHelpers; ++helper)
+  {
+    pool.Submit([queue]() { RunQueuedBlocks(*queue); });
+  }
+
+  RunQueuedBlocks(*queue);
+
+  std::unique_lock<std::mutex> lock(queue->Mutex);
+  queue->AllBlocksCompleted.wait(lock, [&queue]() { return queue->NumberOfCompletedBlocks == queue->NumberOfBlocks; });
+
+  if(queue->Exception)
+  {
+    std::rethrow_exception(queue->Exception);
+  }
+}
+
+} // end namespace
@@ -0,0 +1,136 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef Parallel_H
+#define Parallel_H
+
+// STL
+#include <condition_variable>
+#include <cstddef> // for size_t
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Helpers
+{
+
+/** Execution policies for the Helpers reductions, modeled on the C++17 std::execution policies:
+  * Helpers::Min(Helpers::Parallel, v). Every policy gives the same result.
+  * Sequential runs on the calling thread. Parallel and ParallelVectorized split inputs of at least
+  * MinimumParallelLength elements over every core, using the shared thread pool. Each block is reduced
+  * with the same vectorized kernels as the sequential version, so ParallelVectorized currently behaves like
+  * Parallel; it states that the caller does not care about the order of operations within a thread. */
+struct SequentialExecutionPolicy {};
+struct ParallelExecutionPolicy {};
+struct ParallelVectorizedExecutionPolicy {};
+
+const SequentialExecutionPolicy Sequential = SequentialExecutionPolicy();
+const ParallelExecutionPolicy Parallel = ParallelExecutionPolicy();
+const ParallelVectorizedExecutionPolicy ParallelVectorized = ParallelVectorizedExecutionPolicy();
+
+/** Determine if T is one of the execution policies. */
+template <typename T>
+struct IsExecutionPolicy : std::false_type {};
+
+template <>
+struct IsExecutionPolicy<SequentialExecutionPolicy> : std::true_type {};
+
+template <>
+struct IsExecutionPolicy<ParallelExecutionPolicy> : std::true_type {};
+
+template <>
+struct IsExecutionPolicy<ParallelVectorizedExecutionPolicy> : std::true_type {};
+
+/** Determine how many threads a policy uses (1 for Sequential, every core otherwise). */
+unsigned int GetNumberOfThreads(const SequentialExecutionPolicy&);
+unsigned int GetNumberOfThreads(const ParallelExecutionPolicy&);
+unsigned int GetNumberOfThreads(const ParallelVectorizedExecutionPolicy&);
+
+/** A fixed set of worker threads that run the tasks submitted to them, in order.
+  * The parallel functions in this library run on one shared instance (see GetSharedThreadPool()), so a
+  * parallel call does not pay for starting and joining threads. */
+class ThreadPool
+{
+public:
+  explicit ThreadPool(const unsigned int numberOfThreads);
+
+  /** Wait for the queued tasks to finish and join the threads. */
+  ~ThreadPool();
+
+  /** Queue 'task' to run on one of the threads. */
+  void Submit(const std::function<void()>& task);
+
+  unsigned int GetNumberOfThreads() const;
+
+private:
+  ThreadPool(const ThreadPool&);
+  ThreadPool& operator=(const ThreadPool&);
+
+  /** The loop run by each thread. */
+  void Work();
+
+  std::vector<std::thread> Threads;
+  std::queue<std::function<void()> > Tasks;
+  std::mutex Mutex;
+  std::condition_variable TaskAvailable;
+  bool Stopping;
+};
+
+/** Get the pool shared by the parallel functions in this library. It is created on first use, with one
+  * thread fewer than there are cores, because the thread that starts a parallel operation works on it too. */
+ThreadPool& GetSharedThreadPool();
+
+/** Call runBlock(blockId) for every blockId in [0, numberOfBlocks), on the calling thread and on up to
+  * numberOfBlocks-1 threads of the shared pool. The calling thread keeps taking blocks until there are none
+  * left, so this completes even if every pool thread is busy (e.g. when it is called from inside another
+  * parallel operation). If any call throws, the first exception is rethrown once every block is done. */
+void ParallelForBlockIds(const unsigned int numberOfBlocks, const std::function<void(const unsigned int)>& runBlock);
+
+/** The parallel overloads of the Helpers and Statistics functions use the serial versions for inputs with
+  * fewer elements than this, because handing work to threads costs more than it saves on small inputs. */
+const size_t MinimumParallelLength = 100000;
+
+/** Determine how many threads to use. A 'requestedNumberOfThreads' of 0 means
+  * "use every core on this machine". The result is always at least 1. */
+unsigned int GetNumberOfThreads(const unsigned int requestedNumberOfThreads = 0);
+
+/** Split [0, numberOfItems) into 'numberOfBlocks' contiguous blocks of (almost) equal size and
+  * call functor(blockBegin, blockEnd, blockId) for each of them, in parallel (see ParallelForBlockIds).
+  * The function returns once every block is done.
+  * If 'numberOfBlocks' is 1 (or there are not enough items to split), the functor is called directly. */
+template <typename TFunctor>
+void ParallelForBlocks(const size_t numberOfItems, const unsigned int numberOfBlocks, TFunctor functor);
+
+/** Get the first item of block 'blockId' when [0, numberOfItems) is split into 'numberOfBlocks' blocks.
+  * BlockBegin(numberOfItems, numberOfBlocks, numberOfBlocks) is numberOfItems. */
+size_t BlockBegin(const size_t numberOfItems, const unsigned int numberOfBlocks, const unsigned int blockId);
+
+/** Determine if predicate(begin, end) is true for any of the pieces that [0, numberOfItems) is split into,
+  * using 'numberOfBlocks' threads. Each thread checks its block a piece at a time and stops as soon as
+  * any thread has found one. */
+template <typename TPredicate>
+bool ParallelAnyOf(const size_t numberOfItems, const unsigned int numberOfBlocks, TPredicate predicate);
+
+} // end namespace
+
+#include "Parallel.hpp"
+
+#endif
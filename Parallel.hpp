@@ -0,0 +1,74 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef Parallel_HPP
+#define Parallel_HPP
+
+#include "Parallel.h"
+
+// STL
+#include <algorithm>
+#include <atomic>
+
+namespace Helpers
+{
+
+template <typename TFunctor>
+void ParallelForBlocks(const size_t numberOfItems, const unsigned int numberOfBlocks, TFunctor functor)
+{
+  if(numberOfBlocks <= 1 || numberOfItems < numberOfBlocks)
+  {
+    functor(static_cast<size_t>(0), numberOfItems, 0u);
+    return;
+  }
+
+  ParallelForBlockIds(numberOfBlocks, [&](const unsigned int blockId)
+  {
+    functor(BlockBegin(numberOfItems, numberOfBlocks, blockId),
+            BlockBegin(numberOfItems, numberOfBlocks, blockId + 1),
+            blockId);
+  });
+}
+
+template <typename TPredicate>
+bool ParallelAnyOf(const size_t numberOfItems, const unsigned int numberOfBlocks, TPredicate predicate)
+{
+  // Small enough that a thread notices quickly when another one has found something, large enough
+  // that checking the flag costs nothing.
+  const size_t pieceSize = 16384;
+
+  std::atomic<bool> found(false);
+  ParallelForBlocks(numberOfItems, numberOfBlocks,
+                    [&](const size_t blockBegin, const size_t blockEnd, const unsigned int)
+  {
+    for(size_t pieceBegin = blockBegin; pieceBegin < blockEnd && !found.load(std::memory_order_relaxed);
+        pieceBegin += pieceSize)
+    {
+      if(predicate(pieceBegin, std::min(pieceBegin + pieceSize, blockEnd)))
+      {
+        found.store(true, std::memory_order_relaxed);
+      }
+    }
+  });
+
+  return found.load();
+}
+
+} // end namespace
+
+#endif
@@ -23,21 +23,115 @@
 #include <vector>
 #include <algorithm>
 #include <string>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring> // for memcpy()
+#include <type_traits>
+
+// Custom
+#include "Parallel.h"
+
+/** These traits map a value to an unsigned integer key whose unsigned ordering is the same as the ordering
+  * of the values, so that ParallelSort can use a radix sort instead of a comparison sort.
+  * This is the generic version for types that cannot be radix sorted. */
+template <typename T>
+struct ParallelSortRadixKey
+{
+  static const bool IsSupported = false;
+};
+
+/** For unsigned char, the value is already its own key. */
+template <>
+struct ParallelSortRadixKey<unsigned char>
+{
+  static const bool IsSupported = true;
+  typedef uint8_t KeyType;
+  static KeyType Encode(const unsigned char value)
+  {
+    return value;
+  }
+};
+
+/** For unsigned int, the value is already its own key. */
+template <>
+struct ParallelSortRadixKey<unsigned int>
+{
+  static const bool IsSupported = true;
+  typedef uint32_t KeyType;
+  static KeyType Encode(const unsigned int value)
+  {
+    return value;
+  }
+};
+
+/** For int, flipping the sign bit moves the negative values below the positive ones. */
+template <>
+struct ParallelSortRadixKey<int>
+{
+  static const bool IsSupported = true;
+  typedef uint32_t KeyType;
+  static KeyType Encode(const int value)
+  {
+    return static_cast<KeyType>(value) ^ 0x80000000u;
+  }
+};
+
+/** For float, positive values get their sign bit set and negative values get all of their bits flipped,
+  * which reverses their order. -0 is encoded as +0 because the two compare equal. */
+template <>
+struct ParallelSortRadixKey<float>
+{
+  static const bool IsSupported = true;
+  typedef uint32_t KeyType;
+  static KeyType Encode(const float value)
+  {
+    const float canonicalValue = (value == 0.0f) ? 0.0f : value;
+    KeyType bits;
+    memcpy(&bits, &canonicalValue, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+  }
+};
+
+/** For double, see the float version. */
+template <>
+struct ParallelSortRadixKey<double>
+{
+  static const bool IsSupported = true;
+  typedef uint64_t KeyType;
+  static KeyType Encode(const double value)
+  {
+    const double canonicalValue = (value == 0.0) ? 0.0 : value;
+    KeyType bits;
+    memcpy(&bits, &canonicalValue, sizeof(bits));
+    return (bits & 0x8000000000000000ull) ? ~bits : (bits | 0x8000000000000000ull);
+  }
+};
 
 /** This class sorts a vector, taking the origin indices along with it, so you can find out which element ended
   * up in each position.
+  * Large vectors are split into one block per thread, each block is sorted on its own thread, and the sorted
+  * blocks are then merged pairwise (with each round of merges also running in parallel).
+  * Elements with equal values are ordered by their original index, so the result does not depend on the
+  * number of threads that was used.
+  * For types that have a ParallelSortRadixKey (unsigned char, int, unsigned int, float and double), a stable
+  * LSD radix sort is used instead of a comparison sort. It produces exactly the same result.
+  * TIndex is the type used to store the original positions. The default (unsigned int) limits the input
+  * to 4G elements; use ParallelSort<T, size_t> (or uint64_t) for larger inputs.
   */
-template <typename T>
+template <typename T, typename TIndex = unsigned int>
 class ParallelSort
 {
 public:
 
+  typedef TIndex IndexType;
+
   struct IndexedValue
   {
-    unsigned int index;
+    TIndex index;
     T value;
 
-    bool operator<(IndexedValue elementToCompare) const
+    bool operator<(const IndexedValue& elementToCompare) const
     {
       return this->value < elementToCompare.value;
     }
@@ -46,12 +140,302 @@ public:
   typedef std::vector<T> VectorType;
   typedef std::vector<IndexedValue> IndexedVectorType;
 
-  static IndexedVectorType ParallelSortAscending(const VectorType& v);
+  /** A list of original positions. Entry i is the position in the input of the element that belongs at position i. */
+  typedef std::vector<TIndex> PermutationType;
+
+  /** Order IndexedValues by increasing value. Ties are broken by increasing index. */
+  struct AscendingCompare
+  {
+    bool operator()(const IndexedValue& a, const IndexedValue& b) const
+    {
+      if(a.value < b.value)
+      {
+        return true;
+      }
+      if(b.value < a.value)
+      {
+        return false;
+      }
+      return a.index < b.index;
+    }
+  };
+
+  /** Order IndexedValues by decreasing value. Ties are broken by increasing index. */
+  struct DescendingCompare
+  {
+    bool operator()(const IndexedValue& a, const IndexedValue& b) const
+    {
+      if(b.value < a.value)
+      {
+        return true;
+      }
+      if(a.value < b.value)
+      {
+        return false;
+      }
+      return a.index < b.index;
+    }
+  };
+
+  /** Sort 'v' in ascending order. 'numberOfThreads' = 0 means use every core on the machine. */
+  static IndexedVectorType ParallelSortAscending(const VectorType& v, const unsigned int numberOfThreads = 0);
+
+  /** Sort 'v' in descending order. 'numberOfThreads' = 0 means use every core on the machine. */
+  static IndexedVectorType ParallelSortDescending(const VectorType& v, const unsigned int numberOfThreads = 0);
+
+  /** Sort 'v' by a user supplied comparator 'compare(const T&, const T&)'. If 'stable' is true, equivalent elements
+    * keep their original order, otherwise their order is unspecified. */
+  template <typename TCompare>
+  static IndexedVectorType ParallelSortWithComparator(const VectorType& v, TCompare compare,
+                                                      const bool descending = false, const bool stable = false,
+                                                      const unsigned int numberOfThreads = 0);
+
+  /** Sort 'v' by a key derived from each element, e.g. one channel or the norm of a vector-valued T.
+    * 'keyExtractor(const T&)' is called exactly once per element and the keys are compared with operator<.
+    * If 'stable' is true, elements with equal keys keep their original order. */
+  template <typename TKeyExtractor>
+  static IndexedVectorType ParallelSortByKey(const VectorType& v, TKeyExtractor keyExtractor,
+                                             const bool descending = false, const bool stable = false,
+                                             const unsigned int numberOfThreads = 0);
+
+  /** Get the 'k' smallest elements of 'v' in ascending order. This is the same as the first 'k' elements of
+    * ParallelSortAscending(v), but costs roughly O(n + k log k) (O(n log k) in the worst case) instead of
+    * O(n log n), and never copies all of 'v'. */
+  static IndexedVectorType ParallelSortAscendingTopK(const VectorType& v, const size_t k,
+                                                     const unsigned int numberOfThreads = 0);
+
+  /** Get the 'k' largest elements of 'v' in descending order. This is the same as the first 'k' elements of
+    * ParallelSortDescending(v). */
+  static IndexedVectorType ParallelSortDescendingTopK(const VectorType& v, const size_t k,
+                                                      const unsigned int numberOfThreads = 0);
+
+  /** Compute the permutation that sorts 'v' in ascending order without copying any of the values.
+    * The result is the same as the .index values of ParallelSortAscending(v). */
+  static PermutationType ArgSortAscending(const VectorType& v, const unsigned int numberOfThreads = 0);
+
+  /** Compute the permutation that sorts 'v' in descending order without copying any of the values.
+    * The result is the same as the .index values of ParallelSortDescending(v). */
+  static PermutationType ArgSortDescending(const VectorType& v, const unsigned int numberOfThreads = 0);
+
+  /** Reorder 'v' in place so that v[i] becomes the old v[permutation[i]]. This follows the cycles of the
+    * permutation, so it needs one temporary element and one bit per element rather than a copy of 'v'. */
+  template <typename TVector>
+  static void ApplyPermutation(const PermutationType& permutation, TVector& v);
+
+  /** Apply the same permutation to several vectors (e.g. values and their payloads) in place. */
+  template <typename TVector, typename... TVectors>
+  static void ApplyPermutation(const PermutationType& permutation, TVector& v, TVectors&... otherVectors);
+
+  /** Sort 'keys' in place and reorder every one of the 'payloads' vectors the same way, e.g.
+    * ZipSort(false, 0, costs, pixelCoordinates, patchIds). Only a permutation of indices is sorted, and it is
+    * then applied to each vector in place, so no IndexedVectorType is ever created.
+    * All of the vectors must have the same size; if they do not, nothing is modified and an exception is thrown. */
+  template <typename... TPayloads>
+  static void ZipSort(const bool descending, const unsigned int numberOfThreads,
+                      VectorType& keys, TPayloads&... payloads);
+
+  /** ZipSort in ascending order using every core. */
+  template <typename... TPayloads>
+  static void ZipSortAscending(VectorType& keys, TPayloads&... payloads);
+
+  /** ZipSort in descending order using every core. */
+  template <typename... TPayloads>
+  static void ZipSortDescending(VectorType& keys, TPayloads&... payloads);
+
+  /** Sort a binary file of raw T values that may be too large to fit in memory, and write the result to
+    * 'outputFileName' as raw IndexedValue records (in the same order as ParallelSortAscending/Descending).
+    * The input is read in chunks that fit in 'maximumMemory' bytes; each chunk is sorted (using up to
+    * 'numberOfThreads' threads) and written to a temporary run file next to the output. The runs are then
+    * combined with a k-way merge, in several passes if there are too many of them to merge at once.
+    * T must be trivially copyable, and TIndex must be able to hold the number of values in the file. */
+  static void ExternalSort(const std::string& inputFileName, const std::string& outputFileName,
+                           const bool descending, const size_t maximumMemory,
+                           const unsigned int numberOfThreads = 0);
+
+  /** Merge two runs that were each sorted by ParallelSortAscending (or ParallelSortDescending if 'descending' is true)
+    * into one sorted run. The indices of 'b' are shifted by a.size(), so the result is the same as sorting the
+    * concatenation of the two original vectors. This lets batches be merged incrementally:
+    * all = ParallelSort<T>::Merge(all, ParallelSort<T>::ParallelSortAscending(batch)); */
+  static IndexedVectorType Merge(const IndexedVectorType& a, const IndexedVectorType& b,
+                                 const bool descending = false, const unsigned int numberOfThreads = 0);
+
+  /** Merge two sorted runs, adding 'aIndexOffset' to the indices of 'a' and 'bIndexOffset' to the indices of 'b'.
+    * Large merges are split between threads along the merge path. */
+  static IndexedVectorType Merge(const IndexedVectorType& a, const TIndex aIndexOffset,
+                                 const IndexedVectorType& b, const TIndex bIndexOffset,
+                                 const bool descending = false, const unsigned int numberOfThreads = 0);
 
-  static IndexedVectorType ParallelSortDescending(const VectorType& v);
+  /** Merge any number of sorted runs. The indices of each run are shifted by the total size of the runs before it. */
+  static IndexedVectorType Merge(const std::vector<IndexedVectorType>& runs,
+                                 const bool descending = false, const unsigned int numberOfThreads = 0);
+
+  /** Merge any number of sorted runs, adding indexOffsets[i] to the indices of runs[i]. */
+  static IndexedVectorType Merge(const std::vector<IndexedVectorType>& runs, const std::vector<TIndex>& indexOffsets,
+                                 const bool descending = false, const unsigned int numberOfThreads = 0);
 
   static IndexedVectorType CreateInternalData(const VectorType& v);
 
+private:
+
+  /** Order indices by increasing value of the element they refer to in 'Values'. Ties are broken by increasing index. */
+  struct IndexAscendingCompare
+  {
+    IndexAscendingCompare(const VectorType& values) : Values(values) {}
+
+    bool operator()(const TIndex a, const TIndex b) const
+    {
+      if(this->Values[a] < this->Values[b])
+      {
+        return true;
+      }
+      if(this->Values[b] < this->Values[a])
+      {
+        return false;
+      }
+      return a < b;
+    }
+
+    const VectorType& Values;
+  };
+
+  /** Order indices by decreasing value of the element they refer to in 'Values'. Ties are broken by increasing index. */
+  struct IndexDescendingCompare
+  {
+    IndexDescendingCompare(const VectorType& values) : Values(values) {}
+
+    bool operator()(const TIndex a, const TIndex b) const
+    {
+      if(this->Values[b] < this->Values[a])
+      {
+        return true;
+      }
+      if(this->Values[a] < this->Values[b])
+      {
+        return false;
+      }
+      return a < b;
+    }
+
+    const VectorType& Values;
+  };
+
+  /** Order any IndexedValue-like elements (anything with a .value member) by applying 'Compare' to their values. */
+  template <typename TValueCompare>
+  struct ValueCompare
+  {
+    ValueCompare(TValueCompare compare) : Compare(compare) {}
+
+    template <typename TElement>
+    bool operator()(const TElement& a, const TElement& b) const
+    {
+      return this->Compare(a.value, b.value);
+    }
+
+    TValueCompare Compare;
+  };
+
+  /** Reverse the order of a comparator, so that descending sorts do not need reverse iterators. */
+  template <typename TValueCompare>
+  struct ReverseCompare
+  {
+    ReverseCompare(TValueCompare compare) : Compare(compare) {}
+
+    template <typename TValue>
+    bool operator()(const TValue& a, const TValue& b) const
+    {
+      return this->Compare(b, a);
+    }
+
+    TValueCompare Compare;
+  };
+
+  /** Vectors with fewer elements than this per thread are not worth splitting up. */
+  static const size_t MinimumElementsPerThread = 10000;
+
+  /** Each run that is merged at once gets a buffer of at least this many records. This limits how many
+    * runs ExternalSort merges in a single pass. */
+  static const size_t MinimumRecordsPerMergeBuffer = 4096;
+
+  /** Get the name of a temporary run file used by ExternalSort. */
+  static std::string GetRunFileName(const std::string& outputFileName, const unsigned int pass,
+                                    const size_t runId);
+
+  /** Deletes the files whose names it holds when it goes out of scope, so the run files of ExternalSort
+    * are cleaned up even if it throws. Files that have already been deleted are skipped. */
+  struct TemporaryFiles
+  {
+    ~TemporaryFiles();
+
+    std::vector<std::string> FileNames;
+  };
+
+  /** Merge sorted run files into 'outputFileName', in as many passes as needed so that no more than
+    * 'maximumMemory' bytes of buffers are used at once. The run files are deleted. */
+  template <typename TCompare>
+  static void MergeRunFiles(const std::vector<std::string>& runFileNames, const std::string& outputFileName,
+                            TCompare compare, const size_t maximumMemory);
+
+  /** Merge sorted run files into 'outputFileName' in a single pass, using a heap of the runs' current records. */
+  template <typename TCompare>
+  static void MergeRunsOnce(const std::vector<std::string>& runFileNames, const std::string& outputFileName,
+                            TCompare compare, const size_t maximumMemory);
+
+  /** Determine if every vector in 'vectors' has 'size' elements. */
+  static bool AllSizesMatch(const size_t size);
+
+  template <typename TVector, typename... TVectors>
+  static bool AllSizesMatch(const size_t size, const TVector& v, const TVectors&... otherVectors);
+
+  /** Create the identity permutation 0, 1, ..., numberOfElements-1. */
+  static PermutationType CreateIdentityPermutation(const size_t numberOfElements);
+
+  /** Vectors with fewer elements than this are sorted by comparison even if T supports radix sorting. */
+  static const size_t MinimumElementsForRadixSort = 256;
+
+  /** Sort the output of CreateInternalData by comparison. */
+  static void SortInternalData(IndexedVectorType& data, const bool descending, const unsigned int numberOfThreads,
+                               std::false_type radixSortable);
+
+  /** Sort the output of CreateInternalData with a radix sort (if it is large enough). */
+  static void SortInternalData(IndexedVectorType& data, const bool descending, const unsigned int numberOfThreads,
+                               std::true_type radixSortable);
+
+  /** Stable LSD radix sort of 'data' by the ParallelSortRadixKey of the values, one byte per pass.
+    * Both the per-block histograms and the scatter of each pass run in parallel. */
+  static void RadixSort(IndexedVectorType& data, const bool descending, const unsigned int numberOfThreads);
+
+  /** Find the first 'k' elements of 'v' according to 'compare'. Each thread keeps a bounded heap of the best
+    * 'k' elements of its block, then the candidates from all of the blocks are sorted and truncated. */
+  template <typename TCompare>
+  static IndexedVectorType TopK(const VectorType& v, const size_t k, TCompare compare,
+                                const unsigned int numberOfThreads);
+
+  /** Determine how many blocks to split 'numberOfElements' into, so that no block is smaller than MinimumElementsPerThread. */
+  static unsigned int GetNumberOfBlocks(const size_t numberOfElements, const unsigned int numberOfThreads);
+
+  /** Find how many elements of the first of two sorted runs are among the first 'diagonal' elements of their
+    * merge (the "merge path" split). 'secondBeforeFirst(i, j)' must return true if element j of the second run
+    * goes strictly before element i of the first run. */
+  template <typename TSecondBeforeFirst>
+  static size_t MergePathSplit(const size_t firstSize, const size_t secondSize, const size_t diagonal,
+                               TSecondBeforeFirst secondBeforeFirst);
+
+  /** Merge source[first, middle) and source[middle, last) into destination[first, last), splitting the
+    * output into 'numberOfBlocks' pieces that are merged in parallel. */
+  template <typename TContainer, typename TCompare>
+  static void ParallelMerge(const TContainer& source, const size_t first, const size_t middle, const size_t last,
+                            TContainer& destination, TCompare compare, const unsigned int numberOfBlocks);
+
+  /** Determine if 'a' goes before 'b' in a sorted run once their index offsets are applied. */
+  static bool ComesBefore(const IndexedValue& a, const TIndex aIndexOffset,
+                          const IndexedValue& b, const TIndex bIndexOffset, const bool descending);
+
+  /** Sort 'data' (a vector of IndexedValues or of indices) in place using up to 'numberOfThreads' threads.
+    * If 'stable' is true, equivalent elements keep their relative order. */
+  template <typename TContainer, typename TCompare>
+  static void MultiThreadedSort(TContainer& data, TCompare compare, const unsigned int numberOfThreads,
+                                const bool stable = false);
+
 };
 
 #include "ParallelSort.hpp"
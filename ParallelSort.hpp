@@ -23,12 +23,26 @@
 #include <vector>
 #include <algorithm>
 #include <string>
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+#include <cstdio> // for remove()
+#include <fstream>
+#include <functional> // for less
+#include <memory> // for unique_ptr
+#include <sstream>
+#include <utility> // for move()
 
-template <typename T>
-typename ParallelSort<T>::IndexedVectorType ParallelSort<T>::CreateInternalData(const VectorType& v)
+template <typename T, typename TIndex>
+typename ParallelSort<T, TIndex>::IndexedVectorType ParallelSort<T, TIndex>::CreateInternalData(const VectorType& v)
 {
+  if(v.size() > static_cast<size_t>(std::numeric_limits<TIndex>::max()))
+  {
+    throw std::runtime_error("ParallelSort: too many elements for the index type, use a larger TIndex!");
+  }
+
   IndexedVectorType pairs(v.size());
-  for(unsigned int i = 0; i < v.size(); i++)
+  for(size_t i = 0; i < v.size(); i++)
   {
     pairs[i].index = i;
     pairs[i].value = v[i];
@@ -36,24 +50,943 @@ typename ParallelSort<T>::IndexedVectorType ParallelSort<T>::CreateInternalData(
   return pairs;
 }
 
-template <typename T>
-typename ParallelSort<T>::IndexedVectorType ParallelSort<T>::ParallelSortAscending(const VectorType& v)
+template <typename T, typename TIndex>
+template <typename TContainer, typename TCompare>
+void ParallelSort<T, TIndex>::MultiThreadedSort(TContainer& data, TCompare compare, const unsigned int numberOfThreads,
+                                                const bool stable)
+{
+  const unsigned int numberOfBlocks = GetNumberOfBlocks(data.size(), numberOfThreads);
+
+  if(numberOfBlocks == 1)
+  {
+    if(stable)
+    {
+      std::stable_sort(data.begin(), data.end(), compare);
+    }
+    else
+    {
+      std::sort(data.begin(), data.end(), compare);
+    }
+    return;
+  }
+
+  // Sort each block on its own thread. Remember where the blocks start so they can be merged below.
+  std::vector<size_t> runBoundaries(numberOfBlocks + 1);
+  for(unsigned int blockId = 0; blockId <= numberOfBlocks; ++blockId)
+  {
+    runBoundaries[blockId] = Helpers::BlockBegin(data.size(), numberOfBlocks, blockId);
+  }
+
+  Helpers::ParallelForBlocks(data.size(), numberOfBlocks,
+                             [&data, &compare, stable](const size_t blockBegin, const size_t blockEnd, const unsigned int)
+  {
+    if(stable)
+    {
+      std::stable_sort(data.begin() + blockBegin, data.begin() + blockEnd, compare);
+    }
+    else
+    {
+      std::sort(data.begin() + blockBegin, data.begin() + blockEnd, compare);
+    }
+  });
+
+  // Merge neighboring runs pairwise until only one run is left. std::merge takes from the first
+  // run when elements are equivalent, so the merge keeps the sort stable. Each round ping-pongs between
+  // 'data' and 'buffer'. The merges within a round are independent so they run in parallel, and each
+  // merge is itself split so that the later rounds (with fewer, larger merges) still use every thread.
+  TContainer buffer(data.size());
+  TContainer* source = &data;
+  TContainer* destination = &buffer;
+
+  while(runBoundaries.size() > 2)
+  {
+    const unsigned int numberOfRuns = runBoundaries.size() - 1;
+    const unsigned int numberOfMerges = (numberOfRuns + 1) / 2;
+
+    const unsigned int blocksPerMerge = std::max(1u, numberOfBlocks / numberOfMerges);
+
+    Helpers::ParallelForBlocks(numberOfMerges, numberOfMerges,
+                               [&](const size_t mergeBegin, const size_t mergeEnd, const unsigned int)
+    {
+      for(size_t merge = mergeBegin; merge < mergeEnd; ++merge)
+      {
+        const size_t first = runBoundaries[2 * merge];
+        const size_t middle = runBoundaries[std::min<size_t>(2 * merge + 1, numberOfRuns)];
+        const size_t last = runBoundaries[std::min<size_t>(2 * merge + 2, numberOfRuns)];
+        ParallelMerge(*source, first, middle, last, *destination, compare, blocksPerMerge);
+      }
+    });
+
+    std::vector<size_t> mergedBoundaries;
+    for(size_t i = 0; i < runBoundaries.size(); i += 2)
+    {
+      mergedBoundaries.push_back(runBoundaries[i]);
+    }
+    if(mergedBoundaries.back() != data.size())
+    {
+      mergedBoundaries.push_back(data.size());
+    }
+    runBoundaries = mergedBoundaries;
+
+    std::swap(source, destination);
+  }
+
+  if(source != &data)
+  {
+    data.swap(buffer);
+  }
+}
+
+template <typename T, typename TIndex>
+template <typename TSecondBeforeFirst>
+size_t ParallelSort<T, TIndex>::MergePathSplit(const size_t firstSize, const size_t secondSize, const size_t diagonal,
+                                               TSecondBeforeFirst secondBeforeFirst)
+{
+  // Binary search along the diagonal for the point where the merge path crosses it.
+  size_t low = (diagonal > secondSize) ? diagonal - secondSize : 0;
+  size_t high = std::min(diagonal, firstSize);
+  while(low < high)
+  {
+    const size_t middle = low + (high - low) / 2;
+    if(secondBeforeFirst(middle, diagonal - middle - 1))
+    {
+      high = middle;
+    }
+    else
+    {
+      low = middle + 1;
+    }
+  }
+  return low;
+}
+
+template <typename T, typename TIndex>
+template <typename TContainer, typename TCompare>
+void ParallelSort<T, TIndex>::ParallelMerge(const TContainer& source, const size_t first, const size_t middle,
+                                            const size_t last, TContainer& destination, TCompare compare,
+                                            const unsigned int numberOfBlocks)
+{
+  const size_t firstSize = middle - first;
+  const size_t secondSize = last - middle;
+
+  auto secondBeforeFirst = [&](const size_t i, const size_t j) -> bool
+  {
+    return compare(source[middle + j], source[first + i]);
+  };
+
+  // Each block produces a contiguous piece of the output. Where that piece starts in each of the
+  // two runs is found independently by every block, so the blocks never need to communicate.
+  Helpers::ParallelForBlocks(firstSize + secondSize, numberOfBlocks,
+                             [&](const size_t outputBegin, const size_t outputEnd, const unsigned int)
+  {
+    const size_t firstBegin = MergePathSplit(firstSize, secondSize, outputBegin, secondBeforeFirst);
+    const size_t firstEnd = MergePathSplit(firstSize, secondSize, outputEnd, secondBeforeFirst);
+
+    std::merge(source.begin() + first + firstBegin, source.begin() + first + firstEnd,
+               source.begin() + middle + (outputBegin - firstBegin), source.begin() + middle + (outputEnd - firstEnd),
+               destination.begin() + first + outputBegin, compare);
+  });
+}
+
+template <typename T, typename TIndex>
+void ParallelSort<T, TIndex>::SortInternalData(IndexedVectorType& data, const bool descending,
+                                               const unsigned int numberOfThreads, std::false_type)
+{
+  if(descending)
+  {
+    MultiThreadedSort(data, DescendingCompare(), numberOfThreads);
+  }
+  else
+  {
+    MultiThreadedSort(data, AscendingCompare(), numberOfThreads);
+  }
+}
+
+template <typename T, typename TIndex>
+void ParallelSort<T, TIndex>::SortInternalData(IndexedVectorType& data, const bool descending,
+                                               const unsigned int numberOfThreads, std::true_type)
+{
+  if(data.size() < MinimumElementsForRadixSort)
+  {
+    SortInternalData(data, descending, numberOfThreads, std::false_type());
+    return;
+  }
+
+  RadixSort(data, descending, numberOfThreads);
+}
+
+template <typename T, typename TIndex>
+void ParallelSort<T, TIndex>::RadixSort(IndexedVectorType& data, const bool descending,
+                                        const unsigned int numberOfThreads)
+{
+  typedef ParallelSortRadixKey<T> RadixKeyType;
+  typedef typename RadixKeyType::KeyType KeyType;
+
+  const unsigned int numberOfBuckets = 256;
+
+  const unsigned int numberOfBlocks = GetNumberOfBlocks(data.size(), numberOfThreads);
+
+  // Flipping every bit of the key reverses the order. Because the sort is stable, ties still keep
+  // their original (increasing index) order, which matches DescendingCompare.
+  const KeyType keyMask = descending ? static_cast<KeyType>(~static_cast<KeyType>(0)) : static_cast<KeyType>(0);
+
+  IndexedVectorType buffer(data.size());
+  IndexedVectorType* source = &data;
+  IndexedVectorType* destination = &buffer;
+
+  // bucketOffsets[blockId * numberOfBuckets + bucket] first holds the histogram of a block,
+  // and then where that block should write its next element of that bucket.
+  std::vector<size_t> bucketOffsets(numberOfBlocks * numberOfBuckets);
+
+  for(unsigned int pass = 0; pass < sizeof(KeyType); ++pass)
+  {
+    const unsigned int shift = 8 * pass;
+
+    std::fill(bucketOffsets.begin(), bucketOffsets.end(), 0);
+
+    Helpers::ParallelForBlocks(data.size(), numberOfBlocks,
+                               [&](const size_t blockBegin, const size_t blockEnd, const unsigned int blockId)
+    {
+      size_t* histogram = &bucketOffsets[blockId * numberOfBuckets];
+      for(size_t i = blockBegin; i < blockEnd; ++i)
+      {
+        const KeyType key = RadixKeyType::Encode((*source)[i].value) ^ keyMask;
+        histogram[(key >> shift) & 0xFF]++;
+      }
+    });
+
+    // Turn the histograms into write positions. Buckets are laid out in order, and within a
+    // bucket, lower blocks come first so that the sort is stable.
+    size_t runningTotal = 0;
+    bool allInOneBucket = false;
+    for(unsigned int bucket = 0; bucket < numberOfBuckets; ++bucket)
+    {
+      const size_t bucketStart = runningTotal;
+      for(unsigned int blockId = 0; blockId < numberOfBlocks; ++blockId)
+      {
+        const size_t count = bucketOffsets[blockId * numberOfBuckets + bucket];
+        bucketOffsets[blockId * numberOfBuckets + bucket] = runningTotal;
+        runningTotal += count;
+      }
+      if(runningTotal - bucketStart == data.size())
+      {
+        allInOneBucket = true;
+      }
+    }
+
+    // If every key has the same byte here, this pass would not move anything.
+    if(allInOneBucket)
+    {
+      continue;
+    }
+
+    Helpers::ParallelForBlocks(data.size(), numberOfBlocks,
+                               [&](const size_t blockBegin, const size_t blockEnd, const unsigned int blockId)
+    {
+      size_t* writePositions = &bucketOffsets[blockId * numberOfBuckets];
+      for(size_t i = blockBegin; i < blockEnd; ++i)
+      {
+        const KeyType key = RadixKeyType::Encode((*source)[i].value) ^ keyMask;
+        (*destination)[writePositions[(key >> shift) & 0xFF]++] = (*source)[i];
+      }
+    });
+
+    std::swap(source, destination);
+  }
+
+  if(source != &data)
+  {
+    data.swap(buffer);
+  }
+}
+
+template <typename T, typename TIndex>
+typename ParallelSort<T, TIndex>::IndexedVectorType ParallelSort<T, TIndex>::ParallelSortAscending(const VectorType& v,
+                                                                                   const unsigned int numberOfThreads)
 {
   IndexedVectorType internalData = CreateInternalData(v);
 
-  std::sort(internalData.begin(), internalData.end());
+  SortInternalData(internalData, false, numberOfThreads,
+                   std::integral_constant<bool, ParallelSortRadixKey<T>::IsSupported>());
 
   return internalData;
 }
 
-template <typename T>
-typename ParallelSort<T>::IndexedVectorType ParallelSort<T>::ParallelSortDescending(const VectorType& v)
+template <typename T, typename TIndex>
+typename ParallelSort<T, TIndex>::IndexedVectorType ParallelSort<T, TIndex>::ParallelSortDescending(const VectorType& v,
+                                                                                    const unsigned int numberOfThreads)
 {
   IndexedVectorType internalData = CreateInternalData(v);
 
-  std::sort(internalData.rbegin(), internalData.rend());
+  SortInternalData(internalData, true, numberOfThreads,
+                   std::integral_constant<bool, ParallelSortRadixKey<T>::IsSupported>());
 
   return internalData;
 }
 
+template <typename T, typename TIndex>
+template <typename TCompare>
+typename ParallelSort<T, TIndex>::IndexedVectorType ParallelSort<T, TIndex>::TopK(const VectorType& v, const size_t k,
+                                                                                 TCompare compare,
+                                                                                 const unsigned int numberOfThreads)
+{
+  if(v.size() > static_cast<size_t>(std::numeric_limits<TIndex>::max()))
+  {
+    throw std::runtime_error("ParallelSort: too many elements for the index type, use a larger TIndex!");
+  }
+
+  const size_t numberToKeep = std::min(k, v.size());
+  if(numberToKeep == 0)
+  {
+    return IndexedVectorType();
+  }
+
+  const unsigned int numberOfBlocks = GetNumberOfBlocks(v.size(), numberOfThreads);
+
+  // Each block keeps a heap whose front is the worst of the best 'numberToKeep' elements seen so far.
+  std::vector<IndexedVectorType> blockCandidates(numberOfBlocks);
+
+  Helpers::ParallelForBlocks(v.size(), numberOfBlocks,
+                             [&](const size_t blockBegin, const size_t blockEnd, const unsigned int blockId)
+  {
+    IndexedVectorType& heap = blockCandidates[blockId];
+    heap.reserve(std::min(numberToKeep, blockEnd - blockBegin));
+
+    for(size_t i = blockBegin; i < blockEnd; ++i)
+    {
+      IndexedValue element;
+      element.index = static_cast<TIndex>(i);
+      element.value = v[i];
+
+      if(heap.size() < numberToKeep)
+      {
+        heap.push_back(element);
+        std::push_heap(heap.begin(), heap.end(), compare);
+      }
+      else if(compare(element, heap.front()))
+      {
+        std::pop_heap(heap.begin(), heap.end(), compare);
+        heap.back() = element;
+        std::push_heap(heap.begin(), heap.end(), compare);
+      }
+    }
+  });
+
+  IndexedVectorType candidates;
+  candidates.reserve(numberOfBlocks * numberToKeep);
+  for(unsigned int blockId = 0; blockId < numberOfBlocks; ++blockId)
+  {
+    candidates.insert(candidates.end(), blockCandidates[blockId].begin(), blockCandidates[blockId].end());
+  }
+
+  if(candidates.size() > numberToKeep)
+  {
+    std::nth_element(candidates.begin(), candidates.begin() + numberToKeep, candidates.end(), compare);
+    candidates.resize(numberToKeep);
+  }
+  std::sort(candidates.begin(), candidates.end(), compare);
+
+  return candidates;
+}
+
+template <typename T, typename TIndex>
+typename ParallelSort<T, TIndex>::IndexedVectorType ParallelSort<T, TIndex>::ParallelSortAscendingTopK(const VectorType& v,
+                                                                                                      const size_t k,
+                                                                                                      const unsigned int numberOfThreads)
+{
+  return TopK(v, k, AscendingCompare(), numberOfThreads);
+}
+
+template <typename T, typename TIndex>
+typename ParallelSort<T, TIndex>::IndexedVectorType ParallelSort<T, TIndex>::ParallelSortDescendingTopK(const VectorType& v,
+                                                                                                       const size_t k,
+                                                                                                       const unsigned int numberOfThreads)
+{
+  return TopK(v, k, DescendingCompare(), numberOfThreads);
+}
+
+template <typename T, typename TIndex>
+unsigned int ParallelSort<T, TIndex>::GetNumberOfBlocks(const size_t numberOfElements, const unsigned int numberOfThreads)
+{
+  const unsigned int numberOfBlocks = Helpers::GetNumberOfThreads(numberOfThreads);
+  if(numberOfElements / MinimumElementsPerThread < numberOfBlocks)
+  {
+    return std::max<size_t>(1, numberOfElements / MinimumElementsPerThread);
+  }
+  return numberOfBlocks;
+}
+
+template <typename T, typename TIndex>
+template <typename TCompare>
+typename ParallelSort<T, TIndex>::IndexedVectorType
+ParallelSort<T, TIndex>::ParallelSortWithComparator(const VectorType& v, TCompare compare, const bool descending,
+                                                    const bool stable, const unsigned int numberOfThreads)
+{
+  IndexedVectorType internalData = CreateInternalData(v);
+
+  if(descending)
+  {
+    MultiThreadedSort(internalData, ValueCompare<ReverseCompare<TCompare> >(ReverseCompare<TCompare>(compare)),
+                      numberOfThreads, stable);
+  }
+  else
+  {
+    MultiThreadedSort(internalData, ValueCompare<TCompare>(compare), numberOfThreads, stable);
+  }
+
+  return internalData;
+}
+
+template <typename T, typename TIndex>
+template <typename TKeyExtractor>
+typename ParallelSort<T, TIndex>::IndexedVectorType
+ParallelSort<T, TIndex>::ParallelSortByKey(const VectorType& v, TKeyExtractor keyExtractor, const bool descending,
+                                           const bool stable, const unsigned int numberOfThreads)
+{
+  if(v.size() > static_cast<size_t>(std::numeric_limits<TIndex>::max()))
+  {
+    throw std::runtime_error("ParallelSort: too many elements for the index type, use a larger TIndex!");
+  }
+
+  typedef typename std::decay<decltype(keyExtractor(v[0]))>::type KeyType;
+  typedef typename ParallelSort<KeyType, TIndex>::IndexedVectorType KeyVectorType;
+  typedef std::less<KeyType> KeyCompareType;
+
+  const unsigned int numberOfBlocks = GetNumberOfBlocks(v.size(), numberOfThreads);
+
+  // Extract every key exactly once, rather than once per comparison.
+  KeyVectorType keys(v.size());
+  Helpers::ParallelForBlocks(v.size(), numberOfBlocks,
+                             [&](const size_t blockBegin, const size_t blockEnd, const unsigned int)
+  {
+    for(size_t i = blockBegin; i < blockEnd; ++i)
+    {
+      keys[i].index = static_cast<TIndex>(i);
+      keys[i].value = keyExtractor(v[i]);
+    }
+  });
+
+  if(descending)
+  {
+    MultiThreadedSort(keys, ValueCompare<ReverseCompare<KeyCompareType> >(ReverseCompare<KeyCompareType>(KeyCompareType())),
+                      numberOfThreads, stable);
+  }
+  else
+  {
+    MultiThreadedSort(keys, ValueCompare<KeyCompareType>(KeyCompareType()), numberOfThreads, stable);
+  }
+
+  IndexedVectorType sorted(v.size());
+  Helpers::ParallelForBlocks(v.size(), numberOfBlocks,
+                             [&](const size_t blockBegin, const size_t blockEnd, const unsigned int)
+  {
+    for(size_t i = blockBegin; i < blockEnd; ++i)
+    {
+      sorted[i].index = keys[i].index;
+      sorted[i].value = v[keys[i].index];
+    }
+  });
+
+  return sorted;
+}
+
+template <typename T, typename TIndex>
+typename ParallelSort<T, TIndex>::PermutationType ParallelSort<T, TIndex>::CreateIdentityPermutation(const size_t numberOfElements)
+{
+  if(numberOfElements > static_cast<size_t>(std::numeric_limits<TIndex>::max()))
+  {
+    throw std::runtime_error("ParallelSort: too many elements for the index type, use a larger TIndex!");
+  }
+
+  PermutationType permutation(numberOfElements);
+  for(size_t i = 0; i < numberOfElements; i++)
+  {
+    permutation[i] = static_cast<TIndex>(i);
+  }
+  return permutation;
+}
+
+template <typename T, typename TIndex>
+typename ParallelSort<T, TIndex>::PermutationType ParallelSort<T, TIndex>::ArgSortAscending(const VectorType& v,
+                                                                                           const unsigned int numberOfThreads)
+{
+  PermutationType permutation = CreateIdentityPermutation(v.size());
+
+  MultiThreadedSort(permutation, IndexAscendingCompare(v), numberOfThreads);
+
+  return permutation;
+}
+
+template <typename T, typename TIndex>
+typename ParallelSort<T, TIndex>::PermutationType ParallelSort<T, TIndex>::ArgSortDescending(const VectorType& v,
+                                                                                            const unsigned int numberOfThreads)
+{
+  PermutationType permutation = CreateIdentityPermutation(v.size());
+
+  MultiThreadedSort(permutation, IndexDescendingCompare(v), numberOfThreads);
+
+  return permutation;
+}
+
+template <typename T, typename TIndex>
+template <typename TVector>
+void ParallelSort<T, TIndex>::ApplyPermutation(const PermutationType& permutation, TVector& v)
+{
+  assert(permutation.size() == v.size());
+  if(permutation.size() != v.size())
+  {
+    throw std::runtime_error("ApplyPermutation: the permutation and the vector must be the same size!");
+  }
+
+  std::vector<bool> placed(v.size(), false);
+
+  for(size_t cycleStart = 0; cycleStart < v.size(); ++cycleStart)
+  {
+    if(placed[cycleStart])
+    {
+      continue;
+    }
+
+    // Walk the cycle that contains 'cycleStart', pulling each element into place.
+    typename TVector::value_type firstValue = std::move(v[cycleStart]);
+    size_t current = cycleStart;
+    while(true)
+    {
+      placed[current] = true;
+      const size_t next = permutation[current];
+      if(next == cycleStart)
+      {
+        v[current] = std::move(firstValue);
+        break;
+      }
+      v[current] = std::move(v[next]);
+      current = next;
+    }
+  }
+}
+
+template <typename T, typename TIndex>
+template <typename TVector, typename... TVectors>
+void ParallelSort<T, TIndex>::ApplyPermutation(const PermutationType& permutation, TVector& v, TVectors&... otherVectors)
+{
+  ApplyPermutation(permutation, v);
+  ApplyPermutation(permutation, otherVectors...);
+}
+
+template <typename T, typename TIndex>
+bool ParallelSort<T, TIndex>::AllSizesMatch(const size_t)
+{
+  return true;
+}
+
+template <typename T, typename TIndex>
+template <typename TVector, typename... TVectors>
+bool ParallelSort<T, TIndex>::AllSizesMatch(const size_t size, const TVector& v, const TVectors&... otherVectors)
+{
+  return v.size() == size && AllSizesMatch(size, otherVectors...);
+}
+
+template <typename T, typename TIndex>
+template <typename... TPayloads>
+void ParallelSort<T, TIndex>::ZipSort(const bool descending, const unsigned int numberOfThreads,
+                                      VectorType& keys, TPayloads&... payloads)
+{
+  // Check everything up front so that we never leave the vectors partially reordered.
+  if(!AllSizesMatch(keys.size(), payloads...))
+  {
+    throw std::runtime_error("ZipSort: all of the vectors must be the same size!");
+  }
+
+  PermutationType permutation;
+  if(descending)
+  {
+    permutation = ArgSortDescending(keys, numberOfThreads);
+  }
+  else
+  {
+    permutation = ArgSortAscending(keys, numberOfThreads);
+  }
+
+  ApplyPermutation(permutation, keys, payloads...);
+}
+
+template <typename T, typename TIndex>
+template <typename... TPayloads>
+void ParallelSort<T, TIndex>::ZipSortAscending(VectorType& keys, TPayloads&... payloads)
+{
+  ZipSort(false, 0, keys, payloads...);
+}
+
+template <typename T, typename TIndex>
+template <typename... TPayloads>
+void ParallelSort<T, TIndex>::ZipSortDescending(VectorType& keys, TPayloads&... payloads)
+{
+  ZipSort(true, 0, keys, payloads...);
+}
+
+template <typename T, typename TIndex>
+std::string ParallelSort<T, TIndex>::GetRunFileName(const std::string& outputFileName, const unsigned int pass,
+                                                   const size_t runId)
+{
+  std::stringstream runFileName;
+  runFileName << outputFileName << ".pass" << pass << ".run" << runId;
+  return runFileName.str();
+}
+
+template <typename T, typename TIndex>
+ParallelSort<T, TIndex>::TemporaryFiles::~TemporaryFiles()
+{
+  // The merge deletes its input runs once it has finished, so most of these are usually gone already
+  // (and remove() then just fails).
+  for(size_t i = 0; i < this->FileNames.size(); ++i)
+  {
+    std::remove(this->FileNames[i].c_str());
+  }
+}
+
+template <typename T, typename TIndex>
+void ParallelSort<T, TIndex>::ExternalSort(const std::string& inputFileName, const std::string& outputFileName,
+                                           const bool descending, const size_t maximumMemory,
+                                           const unsigned int numberOfThreads)
+{
+  static_assert(std::is_trivially_copyable<T>::value,
+                "ExternalSort can only be used with types that can be read from a file byte by byte!");
+
+  std::ifstream input(inputFileName.c_str(), std::ios::binary);
+  if(!input)
+  {
+    throw std::runtime_error("ExternalSort: could not open " + inputFileName + "!");
+  }
+
+  input.seekg(0, std::ios::end);
+  const size_t fileSize = static_cast<size_t>(input.tellg());
+  input.seekg(0, std::ios::beg);
+
+  if(fileSize % sizeof(T) != 0)
+  {
+    throw std::runtime_error("ExternalSort: the size of " + inputFileName + " is not a multiple of sizeof(T)!");
+  }
+
+  const size_t numberOfElements = fileSize / sizeof(T);
+  if(numberOfElements > static_cast<size_t>(std::numeric_limits<TIndex>::max()))
+  {
+    throw std::runtime_error("ParallelSort: too many elements for the index type, use a larger TIndex!");
+  }
+
+  // While a run is sorted we hold the raw values, the IndexedValues, and the buffer that the sort uses.
+  const size_t bytesPerElement = sizeof(T) + 2 * sizeof(IndexedValue);
+  const size_t elementsPerRun = std::max<size_t>(1, maximumMemory / bytesPerElement);
+
+  std::vector<std::string> runFileNames;
+  TemporaryFiles temporaryFiles;
+  for(size_t runStart = 0; runStart < numberOfElements; runStart += elementsPerRun)
+  {
+    VectorType chunk(std::min(elementsPerRun, numberOfElements - runStart));
+    input.read(reinterpret_cast<char*>(chunk.data()), chunk.size() * sizeof(T));
+    if(!input)
+    {
+      throw std::runtime_error("ExternalSort: could not read " + inputFileName + "!");
+    }
+
+    IndexedVectorType run;
+    if(descending)
+    {
+      run = ParallelSortDescending(chunk, numberOfThreads);
+    }
+    else
+    {
+      run = ParallelSortAscending(chunk, numberOfThreads);
+    }
+    VectorType().swap(chunk);
+
+    // The sort numbered the elements within the chunk, we want their position in the whole file.
+    for(size_t i = 0; i < run.size(); ++i)
+    {
+      run[i].index += static_cast<TIndex>(runStart);
+    }
+
+    const std::string runFileName = GetRunFileName(outputFileName, 0, runFileNames.size());
+    temporaryFiles.FileNames.push_back(runFileName);
+    std::ofstream runFile(runFileName.c_str(), std::ios::binary);
+    runFile.write(reinterpret_cast<const char*>(run.data()), run.size() * sizeof(IndexedValue));
+    if(!runFile)
+    {
+      throw std::runtime_error("ExternalSort: could not write " + runFileName + "!");
+    }
+    runFileNames.push_back(runFileName);
+  }
+
+  if(descending)
+  {
+    MergeRunFiles(runFileNames, outputFileName, DescendingCompare(), maximumMemory);
+  }
+  else
+  {
+    MergeRunFiles(runFileNames, outputFileName, AscendingCompare(), maximumMemory);
+  }
+}
+
+template <typename T, typename TIndex>
+template <typename TCompare>
+void ParallelSort<T, TIndex>::MergeRunFiles(const std::vector<std::string>& runFileNames,
+                                            const std::string& outputFileName,
+                                            TCompare compare, const size_t maximumMemory)
+{
+  const size_t maximumFanIn = std::max<size_t>(2, maximumMemory / (sizeof(IndexedValue) * MinimumRecordsPerMergeBuffer));
+
+  std::vector<std::string> runs = runFileNames;
+  TemporaryFiles mergedRunFiles;
+  unsigned int pass = 0;
+  while(runs.size() > maximumFanIn)
+  {
+    ++pass;
+    std::vector<std::string> mergedRuns;
+    for(size_t groupStart = 0; groupStart < runs.size(); groupStart += maximumFanIn)
+    {
+      std::vector<std::string> group(runs.begin() + groupStart,
+                                     runs.begin() + std::min(groupStart + maximumFanIn, runs.size()));
+      const std::string mergedRunFileName = GetRunFileName(outputFileName, pass, mergedRuns.size());
+      mergedRunFiles.FileNames.push_back(mergedRunFileName);
+      MergeRunsOnce(group, mergedRunFileName, compare, maximumMemory);
+      mergedRuns.push_back(mergedRunFileName);
+    }
+    runs = mergedRuns;
+  }
+
+  MergeRunsOnce(runs, outputFileName, compare, maximumMemory);
+}
+
+template <typename T, typename TIndex>
+template <typename TCompare>
+void ParallelSort<T, TIndex>::MergeRunsOnce(const std::vector<std::string>& runFileNames,
+                                            const std::string& outputFileName,
+                                            TCompare compare, const size_t maximumMemory)
+{
+  const size_t numberOfRuns = runFileNames.size();
+
+  // One buffer per run, plus one for the output.
+  const size_t recordsPerBuffer = std::max<size_t>(1, maximumMemory / ((numberOfRuns + 1) * sizeof(IndexedValue)));
+
+  std::vector<std::unique_ptr<std::ifstream> > runFiles(numberOfRuns);
+  std::vector<IndexedVectorType> buffers(numberOfRuns);
+  std::vector<size_t> positions(numberOfRuns, 0);
+
+  // Load the next block of records of a run. Returns false if the run is exhausted.
+  auto refill = [&](const size_t run) -> bool
+  {
+    buffers[run].resize(recordsPerBuffer);
+    runFiles[run]->read(reinterpret_cast<char*>(buffers[run].data()), recordsPerBuffer * sizeof(IndexedValue));
+    buffers[run].resize(static_cast<size_t>(runFiles[run]->gcount()) / sizeof(IndexedValue));
+    positions[run] = 0;
+    return !buffers[run].empty();
+  };
+
+  // The heap holds the ids of the runs that still have records, with the run whose current record
+  // comes first at the front.
+  auto heapCompare = [&](const size_t a, const size_t b) -> bool
+  {
+    return compare(buffers[b][positions[b]], buffers[a][positions[a]]);
+  };
+
+  std::vector<size_t> heap;
+  for(size_t run = 0; run < numberOfRuns; ++run)
+  {
+    runFiles[run].reset(new std::ifstream(runFileNames[run].c_str(), std::ios::binary));
+    if(!*runFiles[run])
+    {
+      throw std::runtime_error("ExternalSort: could not open " + runFileNames[run] + "!");
+    }
+    if(refill(run))
+    {
+      heap.push_back(run);
+    }
+  }
+  std::make_heap(heap.begin(), heap.end(), heapCompare);
+
+  std::ofstream output(outputFileName.c_str(), std::ios::binary);
+  if(!output)
+  {
+    throw std::runtime_error("ExternalSort: could not open " + outputFileName + "!");
+  }
+
+  IndexedVectorType outputBuffer;
+  outputBuffer.reserve(recordsPerBuffer);
+
+  while(!heap.empty())
+  {
+    std::pop_heap(heap.begin(), heap.end(), heapCompare);
+    const size_t run = heap.back();
+
+    outputBuffer.push_back(buffers[run][positions[run]]);
+    if(outputBuffer.size() == recordsPerBuffer)
+    {
+      output.write(reinterpret_cast<const char*>(outputBuffer.data()), outputBuffer.size() * sizeof(IndexedValue));
+      outputBuffer.clear();
+    }
+
+    positions[run]++;
+    if(positions[run] == buffers[run].size() && !refill(run))
+    {
+      heap.pop_back();
+    }
+    else
+    {
+      std::push_heap(heap.begin(), heap.end(), heapCompare);
+    }
+  }
+
+  output.write(reinterpret_cast<const char*>(outputBuffer.data()), outputBuffer.size() * sizeof(IndexedValue));
+  if(!output)
+  {
+    throw std::runtime_error("ExternalSort: could not write " + outputFileName + "!");
+  }
+
+  for(size_t run = 0; run < numberOfRuns; ++run)
+  {
+    runFiles[run].reset();
+    std::remove(runFileNames[run].c_str());
+  }
+}
+
+template <typename T, typename TIndex>
+bool ParallelSort<T, TIndex>::ComesBefore(const IndexedValue& a, const TIndex aIndexOffset,
+                                          const IndexedValue& b, const TIndex bIndexOffset, const bool descending)
+{
+  if(descending ? (b.value < a.value) : (a.value < b.value))
+  {
+    return true;
+  }
+  if(descending ? (a.value < b.value) : (b.value < a.value))
+  {
+    return false;
+  }
+  return a.index + aIndexOffset < b.index + bIndexOffset;
+}
+
+template <typename T, typename TIndex>
+typename ParallelSort<T, TIndex>::IndexedVectorType
+ParallelSort<T, TIndex>::Merge(const IndexedVectorType& a, const TIndex aIndexOffset,
+                               const IndexedVectorType& b, const TIndex bIndexOffset,
+                               const bool descending, const unsigned int numberOfThreads)
+{
+  IndexedVectorType merged(a.size() + b.size());
+
+  auto secondBeforeFirst = [&](const size_t i, const size_t j) -> bool
+  {
+    return ComesBefore(b[j], bIndexOffset, a[i], aIndexOffset, descending);
+  };
+
+  // Split the output with the merge path so every thread merges an equal share.
+  Helpers::ParallelForBlocks(merged.size(), GetNumberOfBlocks(merged.size(), numberOfThreads),
+                             [&](const size_t outputBegin, const size_t outputEnd, const unsigned int)
+  {
+    size_t i = MergePathSplit(a.size(), b.size(), outputBegin, secondBeforeFirst);
+    size_t j = outputBegin - i;
+
+    for(size_t output = outputBegin; output < outputEnd; ++output)
+    {
+      if(j < b.size() && (i == a.size() || secondBeforeFirst(i, j)))
+      {
+        merged[output].index = b[j].index + bIndexOffset;
+        merged[output].value = b[j].value;
+        ++j;
+      }
+      else
+      {
+        merged[output].index = a[i].index + aIndexOffset;
+        merged[output].value = a[i].value;
+        ++i;
+      }
+    }
+  });
+
+  return merged;
+}
+
+template <typename T, typename TIndex>
+typename ParallelSort<T, TIndex>::IndexedVectorType
+ParallelSort<T, TIndex>::Merge(const IndexedVectorType& a, const IndexedVectorType& b,
+                               const bool descending, const unsigned int numberOfThreads)
+{
+  if(a.size() + b.size() > static_cast<size_t>(std::numeric_limits<TIndex>::max()))
+  {
+    throw std::runtime_error("ParallelSort: too many elements for the index type, use a larger TIndex!");
+  }
+
+  return Merge(a, 0, b, static_cast<TIndex>(a.size()), descending, numberOfThreads);
+}
+
+template <typename T, typename TIndex>
+typename ParallelSort<T, TIndex>::IndexedVectorType
+ParallelSort<T, TIndex>::Merge(const std::vector<IndexedVectorType>& runs, const std::vector<TIndex>& indexOffsets,
+                               const bool descending, const unsigned int numberOfThreads)
+{
+  if(runs.size() != indexOffsets.size())
+  {
+    throw std::runtime_error("Merge: there must be one index offset per run!");
+  }
+
+  if(runs.empty())
+  {
+    return IndexedVectorType();
+  }
+
+  // Merge neighboring runs pairwise, so every element is copied about log2(k) times. The first
+  // round applies the index offsets, after that every run already has its final indices.
+  std::vector<IndexedVectorType> merged((runs.size() + 1) / 2);
+  for(size_t i = 0; i < merged.size(); ++i)
+  {
+    if(2 * i + 1 < runs.size())
+    {
+      merged[i] = Merge(runs[2 * i], indexOffsets[2 * i], runs[2 * i + 1], indexOffsets[2 * i + 1],
+                        descending, numberOfThreads);
+    }
+    else
+    {
+      merged[i] = Merge(runs[2 * i], indexOffsets[2 * i], IndexedVectorType(), 0, descending, numberOfThreads);
+    }
+  }
+
+  while(merged.size() > 1)
+  {
+    std::vector<IndexedVectorType> nextMerged((merged.size() + 1) / 2);
+    for(size_t i = 0; i < nextMerged.size(); ++i)
+    {
+      if(2 * i + 1 < merged.size())
+      {
+        nextMerged[i] = Merge(merged[2 * i], 0, merged[2 * i + 1], 0, descending, numberOfThreads);
+      }
+      else
+      {
+        nextMerged[i].swap(merged[2 * i]);
+      }
+    }
+    merged.swap(nextMerged);
+  }
+
+  return merged[0];
+}
+
+template <typename T, typename TIndex>
+typename ParallelSort<T, TIndex>::IndexedVectorType
+ParallelSort<T, TIndex>::Merge(const std::vector<IndexedVectorType>& runs,
+                               const bool descending, const unsigned int numberOfThreads)
+{
+  // Number the elements as if the runs had been concatenated.
+  std::vector<TIndex> indexOffsets(runs.size());
+  size_t totalSize = 0;
+  for(size_t i = 0; i < runs.size(); ++i)
+  {
+    indexOffsets[i] = static_cast<TIndex>(totalSize);
+    totalSize += runs[i].size();
+  }
+
+  if(totalSize > static_cast<size_t>(std::numeric_limits<TIndex>::max()))
+  {
+    throw std::runtime_error("ParallelSort: too many elements for the index type, use a larger TIndex!");
+  }
+
+  return Merge(runs, indexOffsets, descending, numberOfThreads);
+}
+
 #endif
@@ -0,0 +1,144 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef QuantileSketch_H
+#define QuantileSketch_H
+
+// STL
+#include <cstddef> // for size_t
+#include <random>
+#include <vector>
+
+namespace Statistics
+{
+
+/** This class estimates quantiles (e.g. the median) of a stream of scalar values in bounded memory, using the
+  * KLL sketch (Karnin, Lang and Liberty, "Optimal Quantile Approximation in Streams", 2016). Values are pushed
+  * into a stack of compactors. When a compactor is full, it is sorted and every other value (starting at a
+  * random offset) is promoted to the next level with twice the weight, so about O(K log(N/K)) values are stored
+  * regardless of how many are pushed.
+  *
+  * Error: the rank of the value returned by GetQuantile(p) is within GetNormalizedRankError() * N of p * N
+  * with about 99% probability. This is about 2.3 / K^0.97, e.g. 1.3% for the default K = 200 and 0.3% for
+  * K = 1000 (these are the empirical constants of the Apache DataSketches KLL implementation, which uses the
+  * same capacity schedule). The minimum and maximum are exact.
+  *
+  * Sketches with the same K can be combined with Merge(), so separate sketches can be filled on separate threads
+  * (see PushVector) and reduced at the end. The results depend on the seed of the random generator, which
+  * defaults to a fixed value so that runs are reproducible.
+  */
+template <typename T>
+class QuantileSketch
+{
+public:
+
+  /** 'k' controls the accuracy (see above) and the memory, which is about 3 * k values. */
+  QuantileSketch(const unsigned int k = 200, const unsigned int seed = 0);
+
+  /** Add a value. NaNs are ignored. */
+  void Push(const T& value);
+
+  /** Add every value in [first, last). */
+  template <typename TIterator>
+  void PushRange(TIterator first, TIterator last);
+
+  /** Add every value of 'v', splitting it across 'numberOfThreads' threads (0 means every core).
+    * Each thread fills its own sketch, and these are merged at the end, so 'v' is never copied. */
+  template <typename TVector>
+  void PushVector(const TVector& v, const unsigned int numberOfThreads = 0);
+
+  /** Combine the values pushed into 'other' (which must have the same K) with the values in this sketch. */
+  void Merge(const QuantileSketch<T>& other);
+
+  /** Forget every value that has been pushed. */
+  void Clear();
+
+  /** Get the number of values that have been pushed. */
+  size_t GetCount() const;
+
+  /** Get the number of values that are currently stored. */
+  size_t GetNumberOfRetainedValues() const;
+
+  /** Get K. */
+  unsigned int GetK() const;
+
+  /** Get the approximate rank error (as a fraction of GetCount()) for this K, see above. */
+  double GetNormalizedRankError() const;
+
+  /** Get the smallest value pushed so far. */
+  T GetMin() const;
+
+  /** Get the largest value pushed so far. */
+  T GetMax() const;
+
+  /** Get a value whose rank is approximately 'p' * GetCount(), for 'p' in [0, 1].
+    * p = 0 gives the minimum and p = 1 gives the maximum. */
+  T GetQuantile(const double p) const;
+
+  /** Get the approximate median. */
+  T GetMedian() const;
+
+  /** Get the quantiles for several values of 'p' at once (this only sorts the retained values once). */
+  std::vector<T> GetQuantiles(const std::vector<double>& p) const;
+
+  /** Get the approximate fraction of the pushed values that are smaller than or equal to 'value'. */
+  double GetRank(const T& value) const;
+
+private:
+
+  /** Throw if nothing has been pushed yet. */
+  void CheckNotEmpty() const;
+
+  /** Get the number of values that a level can hold before it is compacted. */
+  size_t GetCapacity(const unsigned int level) const;
+
+  /** Add an empty level on top, and recompute MaximumSize. */
+  void AddLevel();
+
+  /** Compact full levels until the sketch is smaller than MaximumSize. */
+  void Compress();
+
+  /** Get every retained value with its weight (2^level), sorted by value, with the weights accumulated. */
+  void GetSortedValues(std::vector<T>& values, std::vector<double>& cumulativeWeights) const;
+
+  unsigned int K;
+
+  size_t Count;
+
+  T Min;
+  T Max;
+
+  /** Levels[i] holds values that each stand for 2^i of the pushed values. */
+  std::vector<std::vector<T> > Levels;
+
+  /** The number of values in all of the levels. */
+  size_t Size;
+
+  /** The sum of the capacities of the levels. The sketch is compressed when Size reaches this. */
+  size_t MaximumSize;
+
+  unsigned int Seed;
+
+  std::mt19937 RandomGenerator;
+};
+
+} // end namespace
+
+#include "QuantileSketch.hpp"
+
+#endif
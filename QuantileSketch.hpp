@@ -0,0 +1,385 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef QuantileSketch_HPP
+#define QuantileSketch_HPP
+
+// Custom
+#include "QuantileSketch.h"
+#include "Parallel.h"
+#include "Statistics.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Statistics
+{
+
+template <typename T>
+QuantileSketch<T>::QuantileSketch(const unsigned int k, const unsigned int seed) :
+  K(k), Count(0), Min(), Max(), Size(0), MaximumSize(0), Seed(seed), RandomGenerator(seed)
+{
+  if(k < 8)
+  {
+    throw std::runtime_error("QuantileSketch: k must be at least 8!");
+  }
+
+  AddLevel();
+}
+
+template <typename T>
+void QuantileSketch<T>::Push(const T& value)
+{
+  // NaN does not have a rank.
+  if(value != value)
+  {
+    return;
+  }
+
+  if(this->Count == 0)
+  {
+    this->Min = value;
+    this->Max = value;
+  }
+  else
+  {
+    this->Min = std::min(this->Min, value);
+    this->Max = std::max(this->Max, value);
+  }
+
+  this->Count++;
+  this->Levels[0].push_back(value);
+  this->Size++;
+
+  if(this->Size >= this->MaximumSize)
+  {
+    Compress();
+  }
+}
+
+template <typename T>
+template <typename TIterator>
+void QuantileSketch<T>::PushRange(TIterator first, TIterator last)
+{
+  for(TIterator iterator = first; iterator != last; ++iterator)
+  {
+    Push(*iterator);
+  }
+}
+
+template <typename T>
+template <typename TVector>
+void QuantileSketch<T>::PushVector(const TVector& v, const unsigned int numberOfThreads)
+{
+  unsigned int numberOfBlocks = Helpers::GetNumberOfThreads(numberOfThreads);
+  if(v.size() < MinimumParallelLength)
+  {
+    numberOfBlocks = 1;
+  }
+
+  if(numberOfBlocks == 1)
+  {
+    PushRange(v.begin(), v.end());
+    return;
+  }
+
+  // Give every block its own seed, so the blocks do not make the same random choices.
+  std::vector<QuantileSketch<T> > blockSketches;
+  for(unsigned int blockId = 0; blockId < numberOfBlocks; ++blockId)
+  {
+    blockSketches.push_back(QuantileSketch<T>(this->K, this->Seed + blockId + 1));
+  }
+
+  Helpers::ParallelForBlocks(v.size(), numberOfBlocks,
+                             [&](const size_t blockBegin, const size_t blockEnd, const unsigned int blockId)
+  {
+    blockSketches[blockId].PushRange(v.begin() + blockBegin, v.begin() + blockEnd);
+  });
+
+  for(unsigned int blockId = 0; blockId < numberOfBlocks; ++blockId)
+  {
+    Merge(blockSketches[blockId]);
+  }
+}
+
+template <typename T>
+void QuantileSketch<T>::Merge(const QuantileSketch<T>& other)
+{
+  if(other.K != this->K)
+  {
+    throw std::runtime_error("QuantileSketch::Merge: the sketches must have the same k!");
+  }
+
+  if(other.Count == 0)
+  {
+    return;
+  }
+
+  if(this->Count == 0)
+  {
+    this->Min = other.Min;
+    this->Max = other.Max;
+  }
+  else
+  {
+    this->Min = std::min(this->Min, other.Min);
+    this->Max = std::max(this->Max, other.Max);
+  }
+
+  while(this->Levels.size() < other.Levels.size())
+  {
+    AddLevel();
+  }
+
+  for(size_t level = 0; level < other.Levels.size(); ++level)
+  {
+    this->Levels[level].insert(this->Levels[level].end(), other.Levels[level].begin(), other.Levels[level].end());
+  }
+
+  this->Count += other.Count;
+  this->Size += other.Size;
+
+  while(this->Size >= this->MaximumSize)
+  {
+    Compress();
+  }
+}
+
+template <typename T>
+void QuantileSketch<T>::Clear()
+{
+  this->Count = 0;
+  this->Size = 0;
+  this->Levels.clear();
+  this->RandomGenerator.seed(this->Seed);
+  AddLevel();
+}
+
+template <typename T>
+size_t QuantileSketch<T>::GetCount() const
+{
+  return this->Count;
+}
+
+template <typename T>
+size_t QuantileSketch<T>::GetNumberOfRetainedValues() const
+{
+  return this->Size;
+}
+
+template <typename T>
+unsigned int QuantileSketch<T>::GetK() const
+{
+  return this->K;
+}
+
+template <typename T>
+double QuantileSketch<T>::GetNormalizedRankError() const
+{
+  return 2.296 / pow(static_cast<double>(this->K), 0.9723);
+}
+
+template <typename T>
+T QuantileSketch<T>::GetMin() const
+{
+  CheckNotEmpty();
+  return this->Min;
+}
+
+template <typename T>
+T QuantileSketch<T>::GetMax() const
+{
+  CheckNotEmpty();
+  return this->Max;
+}
+
+template <typename T>
+T QuantileSketch<T>::GetQuantile(const double p) const
+{
+  return GetQuantiles(std::vector<double>(1, p))[0];
+}
+
+template <typename T>
+T QuantileSketch<T>::GetMedian() const
+{
+  return GetQuantile(0.5);
+}
+
+template <typename T>
+std::vector<T> QuantileSketch<T>::GetQuantiles(const std::vector<double>& p) const
+{
+  CheckNotEmpty();
+
+  std::vector<T> values;
+  std::vector<double> cumulativeWeights;
+  GetSortedValues(values, cumulativeWeights);
+
+  std::vector<T> quantiles(p.size());
+  for(size_t i = 0; i < p.size(); ++i)
+  {
+    if(!(p[i] >= 0.0 && p[i] <= 1.0))
+    {
+      throw std::runtime_error("QuantileSketch: quantiles must be in [0, 1]!");
+    }
+
+    if(p[i] == 0.0)
+    {
+      quantiles[i] = this->Min;
+    }
+    else if(p[i] == 1.0)
+    {
+      quantiles[i] = this->Max;
+    }
+    else
+    {
+      // The first value whose accumulated weight reaches the requested rank.
+      const double rank = p[i] * static_cast<double>(this->Count);
+      const size_t position = std::lower_bound(cumulativeWeights.begin(), cumulativeWeights.end(), rank) -
+                              cumulativeWeights.begin();
+      quantiles[i] = values[std::min(position, values.size() - 1)];
+    }
+  }
+
+  return quantiles;
+}
+
+template <typename T>
+double QuantileSketch<T>::GetRank(const T& value) const
+{
+  CheckNotEmpty();
+
+  double weight = 0.0;
+  for(size_t level = 0; level < this->Levels.size(); ++level)
+  {
+    const double levelWeight = static_cast<double>(size_t(1) << level);
+    for(size_t i = 0; i < this->Levels[level].size(); ++i)
+    {
+      if(this->Levels[level][i] <= value)
+      {
+        weight += levelWeight;
+      }
+    }
+  }
+
+  return weight / static_cast<double>(this->Count);
+}
+
+template <typename T>
+void QuantileSketch<T>::CheckNotEmpty() const
+{
+  if(this->Count == 0)
+  {
+    throw std::runtime_error("QuantileSketch: no values have been pushed!");
+  }
+}
+
+template <typename T>
+size_t QuantileSketch<T>::GetCapacity(const unsigned int level) const
+{
+  // The top level holds K values, and each level below it 2/3 as many (but at least 8).
+  const unsigned int depth = this->Levels.size() - level - 1;
+  const size_t capacity = static_cast<size_t>(ceil(this->K * pow(2.0 / 3.0, static_cast<double>(depth))));
+  return std::max(capacity, static_cast<size_t>(8));
+}
+
+template <typename T>
+void QuantileSketch<T>::AddLevel()
+{
+  this->Levels.push_back(std::vector<T>());
+
+  this->MaximumSize = 0;
+  for(unsigned int level = 0; level < this->Levels.size(); ++level)
+  {
+    this->MaximumSize += GetCapacity(level);
+  }
+}
+
+template <typename T>
+void QuantileSketch<T>::Compress()
+{
+  for(unsigned int level = 0; level < this->Levels.size(); ++level)
+  {
+    if(this->Levels[level].size() < GetCapacity(level))
+    {
+      continue;
+    }
+
+    if(level + 1 == this->Levels.size())
+    {
+      AddLevel();
+    }
+
+    std::vector<T>& values = this->Levels[level];
+    std::sort(values.begin(), values.end());
+
+    // With an odd number of values, the smallest one stays at this level.
+    const size_t firstPaired = values.size() % 2;
+
+    // Promote every other value, starting at a random offset, so that the rank of any
+    // value is preserved in expectation.
+    const size_t offset = this->RandomGenerator() & 1;
+    std::vector<T>& nextValues = this->Levels[level + 1];
+    for(size_t i = firstPaired + offset; i < values.size(); i += 2)
+    {
+      nextValues.push_back(values[i]);
+    }
+
+    const size_t numberOfPaired = values.size() - firstPaired;
+    values.resize(firstPaired);
+    this->Size -= numberOfPaired / 2;
+
+    // Compacting one level is usually enough.
+    if(this->Size < this->MaximumSize)
+    {
+      break;
+    }
+  }
+}
+
+template <typename T>
+void QuantileSketch<T>::GetSortedValues(std::vector<T>& values, std::vector<double>& cumulativeWeights) const
+{
+  std::vector<std::pair<T, double> > weightedValues;
+  weightedValues.reserve(this->Size);
+  for(size_t level = 0; level < this->Levels.size(); ++level)
+  {
+    const double levelWeight = static_cast<double>(size_t(1) << level);
+    for(size_t i = 0; i < this->Levels[level].size(); ++i)
+    {
+      weightedValues.push_back(std::make_pair(this->Levels[level][i], levelWeight));
+    }
+  }
+
+  std::sort(weightedValues.begin(), weightedValues.end());
+
+  values.resize(weightedValues.size());
+  cumulativeWeights.resize(weightedValues.size());
+  double cumulativeWeight = 0.0;
+  for(size_t i = 0; i < weightedValues.size(); ++i)
+  {
+    values[i] = weightedValues[i].first;
+    cumulativeWeight += weightedValues[i].second;
+    cumulativeWeights[i] = cumulativeWeight;
+  }
+}
+
+} // end namespace
+
+#endif
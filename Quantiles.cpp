@@ -0,0 +1,110 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "Quantiles.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Statistics
+{
+
+void GetQuantilePosition(const size_t numberOfValues, const double p, const QuantileInterpolation interpolation,
+                         size_t& lowerRank, size_t& upperRank, double& fraction)
+{
+  if(numberOfValues == 0)
+  {
+    throw std::runtime_error("Must have more than 0 items to compute a quantile!");
+  }
+
+  if(!(p >= 0.0 && p <= 1.0))
+  {
+    throw std::runtime_error("Quantiles must be in [0, 1]!");
+  }
+
+  const double position = static_cast<double>(numberOfValues - 1) * p;
+  const size_t floorRank = std::min(static_cast<size_t>(floor(position)), numberOfValues - 1);
+  const size_t ceilRank = std::min(floorRank + 1, numberOfValues - 1);
+  const double positionFraction = position - static_cast<double>(floorRank);
+
+  lowerRank = floorRank;
+  upperRank = floorRank;
+  fraction = 0.0;
+
+  switch(interpolation)
+  {
+    case QUANTILE_LINEAR:
+      if(positionFraction > 0.0)
+      {
+        upperRank = ceilRank;
+        fraction = positionFraction;
+      }
+      break;
+    case QUANTILE_LOWER:
+      break;
+    case QUANTILE_HIGHER:
+      if(positionFraction > 0.0)
+      {
+        lowerRank = ceilRank;
+        upperRank = ceilRank;
+      }
+      break;
+    case QUANTILE_NEAREST:
+      if(positionFraction > 0.5 || (positionFraction == 0.5 && floorRank % 2 == 1))
+      {
+        lowerRank = ceilRank;
+        upperRank = ceilRank;
+      }
+      break;
+    case QUANTILE_MIDPOINT:
+      if(positionFraction > 0.0)
+      {
+        upperRank = ceilRank;
+        fraction = 0.5;
+      }
+      break;
+    default:
+      throw std::runtime_error("Unknown quantile interpolation!");
+  }
+}
+
+std::vector<size_t> GetQuantileRanks(const size_t numberOfValues, const std::vector<double>& p,
+                                     const QuantileInterpolation interpolation)
+{
+  std::vector<size_t> ranks;
+  for(size_t i = 0; i < p.size(); ++i)
+  {
+    size_t lowerRank = 0;
+    size_t upperRank = 0;
+    double fraction = 0.0;
+    GetQuantilePosition(numberOfValues, p[i], interpolation, lowerRank, upperRank, fraction);
+    ranks.push_back(lowerRank);
+    if(upperRank != lowerRank)
+    {
+      ranks.push_back(upperRank);
+    }
+  }
+
+  std::sort(ranks.begin(), ranks.end());
+  ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+  return ranks;
+}
+
+} // end namespace
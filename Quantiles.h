@@ -0,0 +1,105 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef Quantiles_H
+#define Quantiles_H
+
+// STL
+#include <cstddef> // for size_t
+#include <vector>
+
+// Custom
+#include "TypeTraits.h"
+
+namespace Statistics
+{
+
+/** How to compute a quantile that falls between two values. With the values sorted as x[0] <= ... <= x[n-1],
+  * quantile p falls at h = (n - 1) * p. These are the same definitions as numpy.percentile's 'method' argument
+  * (QUANTILE_LINEAR is also R's default, type 7). */
+enum QuantileInterpolation
+{
+  /** x[floor(h)] + (h - floor(h)) * (x[ceil(h)] - x[floor(h)]) */
+  QUANTILE_LINEAR,
+
+  /** x[floor(h)] */
+  QUANTILE_LOWER,
+
+  /** x[ceil(h)] */
+  QUANTILE_HIGHER,
+
+  /** x[round(h)], where halves round to the even index */
+  QUANTILE_NEAREST,
+
+  /** (x[floor(h)] + x[ceil(h)]) / 2 */
+  QUANTILE_MIDPOINT
+};
+
+/** Compute the quantiles 'p' (each in [0, 1], e.g. {0.05, 0.25, 0.5, 0.75, 0.95}) of the scalar values in 'v'
+  * exactly. 'v' is copied once, and every order statistic that is needed is found by one multi-select:
+  * the middle requested rank is selected with nth_element, and the ranks on either side are selected
+  * recursively in the two halves, so this takes about O(n log q) for q quantiles.
+  * With more than one thread and at least MinimumParallelLength values, the copy is made by a parallel
+  * partition around a sampled pivot, and the two sides are then selected on separate threads. */
+template<typename TVector>
+std::vector<typename TypeTraits<TVector>::LargerComponentType>
+Quantiles(const TVector& v, const std::vector<double>& p,
+          const QuantileInterpolation interpolation = QUANTILE_LINEAR, const unsigned int numberOfThreads = 1);
+
+/** Like Quantiles, but reorder 'v' itself instead of copying it. */
+template<typename TVector>
+std::vector<typename TypeTraits<TVector>::LargerComponentType>
+QuantilesInPlace(TVector& v, const std::vector<double>& p,
+                 const QuantileInterpolation interpolation = QUANTILE_LINEAR, const unsigned int numberOfThreads = 1);
+
+/** Compute one quantile. See Quantiles. */
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType
+Quantile(const TVector& v, const double p, const QuantileInterpolation interpolation = QUANTILE_LINEAR);
+
+/** Determine where quantile 'p' of 'numberOfValues' sorted values falls: it is
+  * x[lowerRank] + fraction * (x[upperRank] - x[lowerRank]) for the given interpolation. */
+void GetQuantilePosition(const size_t numberOfValues, const double p, const QuantileInterpolation interpolation,
+                         size_t& lowerRank, size_t& upperRank, double& fraction);
+
+/** Get the (sorted, unique) ranks of the values that are needed to compute the quantiles 'p' of 'numberOfValues' values. */
+std::vector<size_t> GetQuantileRanks(const size_t numberOfValues, const std::vector<double>& p,
+                                     const QuantileInterpolation interpolation);
+
+/** Reorder the elements [begin, end) of 'base' so that the element at each of the ranks [ranksBegin, ranksEnd)
+  * (sorted, unique and in [begin, end)) is the one that would be there if the elements were sorted. */
+template<typename TIterator>
+void MultiSelect(TIterator base, const size_t begin, const size_t end,
+                 std::vector<size_t>::const_iterator ranksBegin, std::vector<size_t>::const_iterator ranksEnd);
+
+/** Finish a multi-select on two threads once [0, lessEnd) holds the values smaller than those in [lessEnd, greaterBegin),
+  * which are already in their sorted positions, and [greaterBegin, numberOfValues) holds the larger values. */
+template<typename TIterator>
+void MultiSelectSides(TIterator base, const size_t lessEnd, const size_t greaterBegin, const size_t numberOfValues,
+                      const std::vector<size_t>& ranks, const unsigned int numberOfThreads);
+
+/** Compute the quantiles 'p' from values that have been multi-selected at GetQuantileRanks. */
+template<typename TIterator, typename TOutput>
+std::vector<TOutput> InterpolateQuantiles(TIterator selected, const size_t numberOfValues, const std::vector<double>& p,
+                                          const QuantileInterpolation interpolation);
+
+} // end namespace
+
+#include "Quantiles.hpp"
+
+#endif
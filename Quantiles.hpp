@@ -0,0 +1,252 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef Quantiles_HPP
+#define Quantiles_HPP
+
+// Custom
+#include "Quantiles.h"
+#include "Parallel.h"
+#include "Statistics.h"
+
+// STL
+#include <algorithm>
+#include <stdexcept>
+
+namespace Statistics
+{
+
+template<typename TVector>
+std::vector<typename TypeTraits<TVector>::LargerComponentType>
+Quantiles(const TVector& v, const std::vector<double>& p,
+          const QuantileInterpolation interpolation, const unsigned int numberOfThreads)
+{
+  typedef typename TypeTraits<TVector>::LargerComponentType QuantileType;
+  typedef typename TVector::value_type ValueType;
+
+  const size_t numberOfValues = v.size();
+  const std::vector<size_t> ranks = GetQuantileRanks(numberOfValues, p, interpolation);
+  if(ranks.empty())
+  {
+    return std::vector<QuantileType>();
+  }
+
+  const unsigned int numberOfBlocks = Helpers::GetNumberOfThreads(numberOfThreads);
+  if(numberOfBlocks == 1 || numberOfValues < MinimumParallelLength)
+  {
+    std::vector<ValueType> values(v.begin(), v.end());
+    MultiSelect(values.begin(), 0, numberOfValues, ranks.begin(), ranks.end());
+    return InterpolateQuantiles<typename std::vector<ValueType>::const_iterator, QuantileType>(
+          values.begin(), numberOfValues, p, interpolation);
+  }
+
+  // Pick a pivot near the middle requested rank from an evenly spaced sample.
+  const size_t sampleSize = 1023;
+  std::vector<ValueType> sample(sampleSize);
+  for(size_t i = 0; i < sampleSize; ++i)
+  {
+    sample[i] = v[i * numberOfValues / sampleSize];
+  }
+  const size_t targetRank = ranks[ranks.size() / 2];
+  std::nth_element(sample.begin(), sample.begin() + targetRank * sampleSize / numberOfValues, sample.end());
+  const ValueType pivot = sample[targetRank * sampleSize / numberOfValues];
+
+  // Make the working copy with a three way partition around the pivot: every block counts its values that
+  // are smaller than, equal to and larger than the pivot, and then writes them to their places in the copy.
+  std::vector<size_t> blockLess(numberOfBlocks, 0);
+  std::vector<size_t> blockEqual(numberOfBlocks, 0);
+  Helpers::ParallelForBlocks(numberOfValues, numberOfBlocks,
+                             [&](const size_t blockBegin, const size_t blockEnd, const unsigned int blockId)
+  {
+    for(size_t i = blockBegin; i < blockEnd; ++i)
+    {
+      if(v[i] < pivot)
+      {
+        blockLess[blockId]++;
+      }
+      else if(v[i] == pivot)
+      {
+        blockEqual[blockId]++;
+      }
+    }
+  });
+
+  size_t lessEnd = 0;
+  size_t equalEnd = 0;
+  for(unsigned int blockId = 0; blockId < numberOfBlocks; ++blockId)
+  {
+    lessEnd += blockLess[blockId];
+    equalEnd += blockLess[blockId] + blockEqual[blockId];
+  }
+
+  std::vector<ValueType> values(numberOfValues);
+  std::vector<size_t> lessOffset(numberOfBlocks);
+  std::vector<size_t> equalOffset(numberOfBlocks);
+  std::vector<size_t> greaterOffset(numberOfBlocks);
+  size_t lessPosition = 0;
+  size_t equalPosition = lessEnd;
+  size_t greaterPosition = equalEnd;
+  for(unsigned int blockId = 0; blockId < numberOfBlocks; ++blockId)
+  {
+    const size_t blockSize = Helpers::BlockBegin(numberOfValues, numberOfBlocks, blockId + 1) -
+                             Helpers::BlockBegin(numberOfValues, numberOfBlocks, blockId);
+    lessOffset[blockId] = lessPosition;
+    equalOffset[blockId] = equalPosition;
+    greaterOffset[blockId] = greaterPosition;
+    lessPosition += blockLess[blockId];
+    equalPosition += blockEqual[blockId];
+    greaterPosition += blockSize - blockLess[blockId] - blockEqual[blockId];
+  }
+
+  Helpers::ParallelForBlocks(numberOfValues, numberOfBlocks,
+                             [&](const size_t blockBegin, const size_t blockEnd, const unsigned int blockId)
+  {
+    size_t less = lessOffset[blockId];
+    size_t equal = equalOffset[blockId];
+    size_t greater = greaterOffset[blockId];
+    for(size_t i = blockBegin; i < blockEnd; ++i)
+    {
+      if(v[i] < pivot)
+      {
+        values[less++] = v[i];
+      }
+      else if(v[i] == pivot)
+      {
+        values[equal++] = v[i];
+      }
+      else
+      {
+        values[greater++] = v[i];
+      }
+    }
+  });
+
+  MultiSelectSides(values.begin(), lessEnd, equalEnd, numberOfValues, ranks, numberOfBlocks);
+
+  return InterpolateQuantiles<typename std::vector<ValueType>::const_iterator, QuantileType>(
+        values.begin(), numberOfValues, p, interpolation);
+}
+
+template<typename TVector>
+std::vector<typename TypeTraits<TVector>::LargerComponentType>
+QuantilesInPlace(TVector& v, const std::vector<double>& p,
+                 const QuantileInterpolation interpolation, const unsigned int numberOfThreads)
+{
+  typedef typename TypeTraits<TVector>::LargerComponentType QuantileType;
+
+  const size_t numberOfValues = v.size();
+  const std::vector<size_t> ranks = GetQuantileRanks(numberOfValues, p, interpolation);
+  if(ranks.empty())
+  {
+    return std::vector<QuantileType>();
+  }
+
+  const unsigned int numberOfBlocks = Helpers::GetNumberOfThreads(numberOfThreads);
+  if(numberOfBlocks == 1 || numberOfValues < MinimumParallelLength)
+  {
+    MultiSelect(v.begin(), 0, numberOfValues, ranks.begin(), ranks.end());
+  }
+  else
+  {
+    // Without a buffer to partition into, select the middle rank on this thread and the two sides in parallel.
+    const size_t middleRank = ranks[ranks.size() / 2];
+    std::nth_element(v.begin(), v.begin() + middleRank, v.end());
+    MultiSelectSides(v.begin(), middleRank, middleRank + 1, numberOfValues, ranks, numberOfBlocks);
+  }
+
+  return InterpolateQuantiles<typename TVector::const_iterator, QuantileType>(v.begin(), numberOfValues, p, interpolation);
+}
+
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType
+Quantile(const TVector& v, const double p, const QuantileInterpolation interpolation)
+{
+  return Quantiles(v, std::vector<double>(1, p), interpolation)[0];
+}
+
+template<typename TIterator>
+void MultiSelect(TIterator base, const size_t begin, const size_t end,
+                 std::vector<size_t>::const_iterator ranksBegin, std::vector<size_t>::const_iterator ranksEnd)
+{
+  if(ranksBegin == ranksEnd || end - begin < 2)
+  {
+    return;
+  }
+
+  // Sorting is faster than selecting repeatedly in very small ranges.
+  if(end - begin <= 32)
+  {
+    std::sort(base + begin, base + end);
+    return;
+  }
+
+  // Everything before the middle rank is then smaller than (or equal to) it, and everything after it is larger,
+  // so the ranks on each side only need to be selected within that side.
+  const std::vector<size_t>::const_iterator middle = ranksBegin + (ranksEnd - ranksBegin) / 2;
+  std::nth_element(base + begin, base + *middle, base + end);
+
+  MultiSelect(base, begin, *middle, ranksBegin, middle);
+  MultiSelect(base, *middle + 1, end, middle + 1, ranksEnd);
+}
+
+template<typename TIterator>
+void MultiSelectSides(TIterator base, const size_t lessEnd, const size_t greaterBegin, const size_t numberOfValues,
+                      const std::vector<size_t>& ranks, const unsigned int numberOfThreads)
+{
+  const std::vector<size_t>::const_iterator lessRanksEnd = std::lower_bound(ranks.begin(), ranks.end(), lessEnd);
+  const std::vector<size_t>::const_iterator greaterRanksBegin = std::lower_bound(ranks.begin(), ranks.end(), greaterBegin);
+
+  Helpers::ParallelForBlocks(2, std::min(numberOfThreads, 2u),
+                             [&](const size_t sideBegin, const size_t sideEnd, const unsigned int)
+  {
+    for(size_t side = sideBegin; side < sideEnd; ++side)
+    {
+      if(side == 0)
+      {
+        MultiSelect(base, 0, lessEnd, ranks.begin(), lessRanksEnd);
+      }
+      else
+      {
+        MultiSelect(base, greaterBegin, numberOfValues, greaterRanksBegin, ranks.end());
+      }
+    }
+  });
+}
+
+template<typename TIterator, typename TOutput>
+std::vector<TOutput> InterpolateQuantiles(TIterator selected, const size_t numberOfValues, const std::vector<double>& p,
+                                          const QuantileInterpolation interpolation)
+{
+  std::vector<TOutput> quantiles(p.size());
+  for(size_t i = 0; i < p.size(); ++i)
+  {
+    size_t lowerRank = 0;
+    size_t upperRank = 0;
+    double fraction = 0.0;
+    GetQuantilePosition(numberOfValues, p[i], interpolation, lowerRank, upperRank, fraction);
+
+    const double lower = selected[lowerRank];
+    const double upper = selected[upperRank];
+    quantiles[i] = static_cast<TOutput>(lower + fraction * (upper - lower));
+  }
+  return quantiles;
+}
+
+} // end namespace
+
+#endif
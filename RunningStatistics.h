@@ -0,0 +1,117 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef RunningStatistics_H
+#define RunningStatistics_H
+
+// STL
+#include <cstddef> // for size_t
+#include <vector>
+
+// Custom
+#include "TypeTraits.h"
+
+namespace Statistics
+{
+
+/** This class accumulates the count, mean, variance, min and max of a stream of values in a single pass
+  * (using Welford's algorithm), so the values never need to be stored. T can be a scalar or a multi-component
+  * type (e.g. std::vector<float> for an RGB pixel) - each component is accumulated separately through
+  * Helpers::index/Helpers::length. Two accumulators can be combined with Merge() (using Chan et al.'s
+  * formula), so partial results computed on different threads or batches can be reduced at the end.
+  * All of the accumulation is done in double precision.
+  */
+template <typename T>
+class RunningStatistics
+{
+public:
+
+  typedef typename TypeTraits<T>::LargerType LargerType;
+  typedef typename TypeTraits<T>::ComponentType ComponentType;
+
+  RunningStatistics();
+
+  /** Add a value. Every value must have the same number of components as the first one. */
+  void Push(const T& value);
+
+  /** Add every value in [first, last). */
+  template <typename TIterator>
+  void PushRange(TIterator first, TIterator last);
+
+  /** Combine the values accumulated by 'other' into this accumulator. The result is the same
+    * (up to rounding) as if every value had been pushed into this accumulator. */
+  void Merge(const RunningStatistics<T>& other);
+
+  /** Forget every value that has been pushed. */
+  void Clear();
+
+  /** Get the number of values that have been pushed. */
+  size_t GetCount() const;
+
+  /** Get the number of components of the values (0 if nothing has been pushed yet). */
+  unsigned int GetNumberOfComponents() const;
+
+  /** Get the mean of one component. */
+  double GetMean(const unsigned int component) const;
+
+  /** Get the unbiased (N-1) sample variance of one component, the same definition used by Statistics::Variance. */
+  double GetVariance(const unsigned int component) const;
+
+  /** Get the smallest value of one component. */
+  double GetMin(const unsigned int component) const;
+
+  /** Get the largest value of one component. */
+  double GetMax(const unsigned int component) const;
+
+  /** Get the mean of every component, in the same shape as the values. */
+  LargerType GetMean() const;
+
+  /** Get the variance of every component, in the same shape as the values. */
+  LargerType GetVariance() const;
+
+  /** Get the smallest value of each component. */
+  T GetMin() const;
+
+  /** Get the largest value of each component. */
+  T GetMax() const;
+
+private:
+
+  /** Throw if nothing has been pushed yet. */
+  void CheckNotEmpty() const;
+
+  /** Copy one value per component into something shaped like the pushed values. */
+  template <typename TOutput>
+  TOutput CreateOutput(const std::vector<double>& componentValues) const;
+
+  size_t Count;
+
+  /** The first value that was pushed. It is used to give the outputs the right number of components. */
+  T Prototype;
+
+  std::vector<double> Mean;
+  std::vector<double> SumOfSquaredDifferences;
+  std::vector<double> Min;
+  std::vector<double> Max;
+};
+
+} // end namespace
+
+#include "RunningStatistics.hpp"
+
+#endif
@@ -0,0 +1,236 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef RunningStatistics_HPP
+#define RunningStatistics_HPP
+
+// Custom
+#include "RunningStatistics.h"
+#include "ContainerInterface.h"
+
+// STL
+#include <algorithm>
+#include <stdexcept>
+
+namespace Statistics
+{
+
+template <typename T>
+RunningStatistics<T>::RunningStatistics() : Count(0), Prototype()
+{
+}
+
+template <typename T>
+void RunningStatistics<T>::Push(const T& value)
+{
+  const unsigned int numberOfComponents = Helpers::length(value);
+
+  if(this->Count == 0)
+  {
+    this->Prototype = value;
+    this->Mean.assign(numberOfComponents, 0.0);
+    this->SumOfSquaredDifferences.assign(numberOfComponents, 0.0);
+    this->Min.assign(numberOfComponents, 0.0);
+    this->Max.assign(numberOfComponents, 0.0);
+    for(unsigned int component = 0; component < numberOfComponents; ++component)
+    {
+      this->Min[component] = static_cast<double>(Helpers::index(value, component));
+      this->Max[component] = this->Min[component];
+    }
+  }
+  else if(numberOfComponents != this->Mean.size())
+  {
+    throw std::runtime_error("RunningStatistics: all values must have the same number of components!");
+  }
+
+  this->Count++;
+  const double count = static_cast<double>(this->Count);
+
+  for(unsigned int component = 0; component < numberOfComponents; ++component)
+  {
+    const double x = static_cast<double>(Helpers::index(value, component));
+
+    // Welford: update the mean, then accumulate the product of the deviations from the old and new means.
+    const double delta = x - this->Mean[component];
+    this->Mean[component] += delta / count;
+    this->SumOfSquaredDifferences[component] += delta * (x - this->Mean[component]);
+
+    this->Min[component] = std::min(this->Min[component], x);
+    this->Max[component] = std::max(this->Max[component], x);
+  }
+}
+
+template <typename T>
+template <typename TIterator>
+void RunningStatistics<T>::PushRange(TIterator first, TIterator last)
+{
+  for(TIterator iter = first; iter != last; ++iter)
+  {
+    this->Push(*iter);
+  }
+}
+
+template <typename T>
+void RunningStatistics<T>::Merge(const RunningStatistics<T>& other)
+{
+  if(other.Count == 0)
+  {
+    return;
+  }
+
+  if(this->Count == 0)
+  {
+    *this = other;
+    return;
+  }
+
+  if(other.Mean.size() != this->Mean.size())
+  {
+    throw std::runtime_error("RunningStatistics: all values must have the same number of components!");
+  }
+
+  const double countA = static_cast<double>(this->Count);
+  const double countB = static_cast<double>(other.Count);
+  const double combinedCount = countA + countB;
+
+  for(size_t component = 0; component < this->Mean.size(); ++component)
+  {
+    // Chan et al.: the combined sum of squared differences is the sum of the two, plus a term
+    // for the distance between the two means.
+    const double delta = other.Mean[component] - this->Mean[component];
+    this->Mean[component] += delta * countB / combinedCount;
+    this->SumOfSquaredDifferences[component] += other.SumOfSquaredDifferences[component] +
+                                                delta * delta * countA * countB / combinedCount;
+
+    this->Min[component] = std::min(this->Min[component], other.Min[component]);
+    this->Max[component] = std::max(this->Max[component], other.Max[component]);
+  }
+
+  this->Count += other.Count;
+}
+
+template <typename T>
+void RunningStatistics<T>::Clear()
+{
+  this->Count = 0;
+  this->Mean.clear();
+  this->SumOfSquaredDifferences.clear();
+  this->Min.clear();
+  this->Max.clear();
+}
+
+template <typename T>
+size_t RunningStatistics<T>::GetCount() const
+{
+  return this->Count;
+}
+
+template <typename T>
+unsigned int RunningStatistics<T>::GetNumberOfComponents() const
+{
+  return this->Mean.size();
+}
+
+template <typename T>
+void RunningStatistics<T>::CheckNotEmpty() const
+{
+  if(this->Count == 0)
+  {
+    throw std::runtime_error("RunningStatistics: no values have been pushed!");
+  }
+}
+
+template <typename T>
+double RunningStatistics<T>::GetMean(const unsigned int component) const
+{
+  this->CheckNotEmpty();
+  return this->Mean[component];
+}
+
+template <typename T>
+double RunningStatistics<T>::GetVariance(const unsigned int component) const
+{
+  this->CheckNotEmpty();
+
+  // This (N-1) term in the denominator is for the "unbiased" sample variance.
+  return this->SumOfSquaredDifferences[component] / static_cast<double>(this->Count - 1);
+}
+
+template <typename T>
+double RunningStatistics<T>::GetMin(const unsigned int component) const
+{
+  this->CheckNotEmpty();
+  return this->Min[component];
+}
+
+template <typename T>
+double RunningStatistics<T>::GetMax(const unsigned int component) const
+{
+  this->CheckNotEmpty();
+  return this->Max[component];
+}
+
+template <typename T>
+template <typename TOutput>
+TOutput RunningStatistics<T>::CreateOutput(const std::vector<double>& componentValues) const
+{
+  this->CheckNotEmpty();
+
+  // Start from one of the values so that the output has the right number of components.
+  TOutput output = this->Prototype;
+  for(unsigned int component = 0; component < componentValues.size(); ++component)
+  {
+    Helpers::index(output, component) = componentValues[component];
+  }
+  return output;
+}
+
+template <typename T>
+typename RunningStatistics<T>::LargerType RunningStatistics<T>::GetMean() const
+{
+  return this->CreateOutput<LargerType>(this->Mean);
+}
+
+template <typename T>
+typename RunningStatistics<T>::LargerType RunningStatistics<T>::GetVariance() const
+{
+  this->CheckNotEmpty();
+
+  std::vector<double> variance(this->Mean.size());
+  for(unsigned int component = 0; component < variance.size(); ++component)
+  {
+    variance[component] = this->GetVariance(component);
+  }
+  return this->CreateOutput<LargerType>(variance);
+}
+
+template <typename T>
+T RunningStatistics<T>::GetMin() const
+{
+  return this->CreateOutput<T>(this->Min);
+}
+
+template <typename T>
+T RunningStatistics<T>::GetMax() const
+{
+  return this->CreateOutput<T>(this->Max);
+}
+
+} // end namespace
+
+#endif
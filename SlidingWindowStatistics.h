@@ -0,0 +1,164 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef SlidingWindowStatistics_H
+#define SlidingWindowStatistics_H
+
+// STL
+#include <cstddef> // for size_t
+#include <deque>
+#include <utility>
+#include <vector>
+
+// Custom
+#include "TypeTraits.h"
+
+namespace Statistics
+{
+
+/** This class keeps the mean, variance, min and max of the last 'windowSize' values of a stream, updating them in
+  * (amortized) constant time per value instead of recomputing them over the whole window:
+  * - The mean and sum of squared differences are updated with Welford's formula when a value enters the window
+  *   and with its inverse when a value leaves. To keep rounding errors from accumulating over long streams,
+  *   they are recomputed exactly from the window after every 'windowSize' removals.
+  * - The min and max are the fronts of monotonic deques: a value is dropped from the min deque once a newer,
+  *   smaller (or equal) value arrives, because it can never be the minimum again.
+  * Like RunningStatistics, T can be a scalar or a multi-component type, each component is handled separately,
+  * and all of the accumulation is done in double precision.
+  */
+template <typename T>
+class SlidingWindowStatistics
+{
+public:
+
+  typedef typename TypeTraits<T>::LargerType LargerType;
+
+  SlidingWindowStatistics(const size_t windowSize);
+
+  /** Add a value. Once the window is full, this also removes the oldest value. Every value must have
+    * the same number of components as the first one. */
+  void Push(const T& value);
+
+  /** Add every value in [first, last). */
+  template <typename TIterator>
+  void PushRange(TIterator first, TIterator last);
+
+  /** Forget every value that has been pushed. */
+  void Clear();
+
+  /** Get the size of the window. */
+  size_t GetWindowSize() const;
+
+  /** Get the number of values in the window (smaller than the window size until enough values have been pushed). */
+  size_t GetCount() const;
+
+  /** Determine if the window is full. */
+  bool IsFull() const;
+
+  /** Get the number of components of the values (0 if nothing has been pushed yet). */
+  unsigned int GetNumberOfComponents() const;
+
+  /** Get the mean of one component over the window. */
+  double GetMean(const unsigned int component) const;
+
+  /** Get the unbiased (N-1) sample variance of one component over the window. */
+  double GetVariance(const unsigned int component) const;
+
+  /** Get the smallest value of one component in the window. */
+  double GetMin(const unsigned int component) const;
+
+  /** Get the largest value of one component in the window. */
+  double GetMax(const unsigned int component) const;
+
+  /** Get the mean of every component, in the same shape as the values. */
+  LargerType GetMean() const;
+
+  /** Get the variance of every component, in the same shape as the values. */
+  LargerType GetVariance() const;
+
+  /** Get the smallest value of each component in the window. */
+  T GetMin() const;
+
+  /** Get the largest value of each component in the window. */
+  T GetMax() const;
+
+private:
+
+  /** Throw if the window is empty. */
+  void CheckNotEmpty() const;
+
+  /** Copy one value per component into something shaped like the pushed values. */
+  template <typename TOutput>
+  TOutput CreateOutput(const std::vector<double>& componentValues) const;
+
+  /** Recompute the mean and sum of squared differences of every component from the values in the window. */
+  void Recompute();
+
+  size_t WindowSize;
+
+  /** The number of values in the window. */
+  size_t Count;
+
+  /** The number of values that have ever been pushed. This is used as the position of each value in the stream. */
+  size_t NumberOfPushes;
+
+  /** The number of values removed since the last call to Recompute(). */
+  size_t NumberOfRemovals;
+
+  /** The first value that was pushed. It is used to give the outputs the right number of components. */
+  T Prototype;
+
+  unsigned int NumberOfComponents;
+
+  /** The components of the values in the window, in a ring buffer (value i is at (i % WindowSize) * NumberOfComponents). */
+  std::vector<double> Values;
+
+  std::vector<double> Mean;
+  std::vector<double> SumOfSquaredDifferences;
+
+  /** For each component, the positions and values that could still become the min (increasing values)
+    * or the max (decreasing values) of the window. */
+  std::vector<std::deque<std::pair<size_t, double> > > MinCandidates;
+  std::vector<std::deque<std::pair<size_t, double> > > MaxCandidates;
+};
+
+/** Compute the mean of every full window of 'windowSize' consecutive values of 'v'. Element i of the output is the
+  * mean of v[i], ..., v[i + windowSize - 1], so there are v.size() - windowSize + 1 outputs (none if 'v' is shorter
+  * than the window). This takes O(v.size()) time, independent of the window size. */
+template <typename TVector>
+std::vector<typename TypeTraits<typename TVector::value_type>::LargerType>
+MovingAverage(const TVector& v, const size_t windowSize);
+
+/** Compute the variance of every full window of 'windowSize' consecutive values of 'v' (see MovingAverage). */
+template <typename TVector>
+std::vector<typename TypeTraits<typename TVector::value_type>::LargerType>
+MovingVariance(const TVector& v, const size_t windowSize);
+
+/** Compute the min of every full window of 'windowSize' consecutive values of 'v' (see MovingAverage). */
+template <typename TVector>
+std::vector<typename TVector::value_type> MovingMin(const TVector& v, const size_t windowSize);
+
+/** Compute the max of every full window of 'windowSize' consecutive values of 'v' (see MovingAverage). */
+template <typename TVector>
+std::vector<typename TVector::value_type> MovingMax(const TVector& v, const size_t windowSize);
+
+} // end namespace
+
+#include "SlidingWindowStatistics.hpp"
+
+#endif
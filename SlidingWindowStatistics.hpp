@@ -0,0 +1,388 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef SlidingWindowStatistics_HPP
+#define SlidingWindowStatistics_HPP
+
+// Custom
+#include "SlidingWindowStatistics.h"
+#include "ContainerInterface.h"
+
+// STL
+#include <algorithm>
+#include <stdexcept>
+
+namespace Statistics
+{
+
+template <typename T>
+SlidingWindowStatistics<T>::SlidingWindowStatistics(const size_t windowSize) :
+  WindowSize(windowSize), Count(0), NumberOfPushes(0), NumberOfRemovals(0), Prototype(), NumberOfComponents(0)
+{
+  if(windowSize == 0)
+  {
+    throw std::runtime_error("SlidingWindowStatistics: the window size must be at least 1!");
+  }
+}
+
+template <typename T>
+void SlidingWindowStatistics<T>::Push(const T& value)
+{
+  const unsigned int numberOfComponents = Helpers::length(value);
+
+  if(this->NumberOfPushes == 0)
+  {
+    this->Prototype = value;
+    this->NumberOfComponents = numberOfComponents;
+    this->Values.assign(this->WindowSize * numberOfComponents, 0.0);
+    this->Mean.assign(numberOfComponents, 0.0);
+    this->SumOfSquaredDifferences.assign(numberOfComponents, 0.0);
+    this->MinCandidates.assign(numberOfComponents, std::deque<std::pair<size_t, double> >());
+    this->MaxCandidates.assign(numberOfComponents, std::deque<std::pair<size_t, double> >());
+  }
+  else if(numberOfComponents != this->NumberOfComponents)
+  {
+    throw std::runtime_error("SlidingWindowStatistics: all values must have the same number of components!");
+  }
+
+  const size_t position = this->NumberOfPushes;
+  double* slot = &this->Values[(position % this->WindowSize) * numberOfComponents];
+  const bool removing = (this->Count == this->WindowSize);
+  if(!removing)
+  {
+    this->Count++;
+  }
+  const double count = static_cast<double>(this->Count);
+
+  for(unsigned int component = 0; component < numberOfComponents; ++component)
+  {
+    const double x = static_cast<double>(Helpers::index(value, component));
+
+    if(removing)
+    {
+      // Replace the oldest value: remove it with the inverse of Welford's update (the count stays the same),
+      // then add the new one. Together these are:
+      const double oldest = slot[component];
+      const double delta = x - oldest;
+      const double oldMean = this->Mean[component];
+      this->Mean[component] += delta / count;
+      this->SumOfSquaredDifferences[component] += delta * (x - this->Mean[component] + oldest - oldMean);
+    }
+    else
+    {
+      // Welford: update the mean, then accumulate the product of the deviations from the old and new means.
+      const double delta = x - this->Mean[component];
+      this->Mean[component] += delta / count;
+      this->SumOfSquaredDifferences[component] += delta * (x - this->Mean[component]);
+    }
+    slot[component] = x;
+
+    // Values that are not smaller than the new one can never be the min again (and similarly for the max).
+    std::deque<std::pair<size_t, double> >& minCandidates = this->MinCandidates[component];
+    while(!minCandidates.empty() && minCandidates.back().second >= x)
+    {
+      minCandidates.pop_back();
+    }
+    minCandidates.push_back(std::make_pair(position, x));
+
+    std::deque<std::pair<size_t, double> >& maxCandidates = this->MaxCandidates[component];
+    while(!maxCandidates.empty() && maxCandidates.back().second <= x)
+    {
+      maxCandidates.pop_back();
+    }
+    maxCandidates.push_back(std::make_pair(position, x));
+
+    // Drop the candidates that have left the window.
+    if(position >= this->WindowSize)
+    {
+      const size_t firstInWindow = position - this->WindowSize + 1;
+      while(minCandidates.front().first < firstInWindow)
+      {
+        minCandidates.pop_front();
+      }
+      while(maxCandidates.front().first < firstInWindow)
+      {
+        maxCandidates.pop_front();
+      }
+    }
+  }
+
+  this->NumberOfPushes++;
+
+  if(removing)
+  {
+    this->NumberOfRemovals++;
+    if(this->NumberOfRemovals >= this->WindowSize)
+    {
+      Recompute();
+    }
+  }
+}
+
+template <typename T>
+template <typename TIterator>
+void SlidingWindowStatistics<T>::PushRange(TIterator first, TIterator last)
+{
+  for(TIterator iter = first; iter != last; ++iter)
+  {
+    this->Push(*iter);
+  }
+}
+
+template <typename T>
+void SlidingWindowStatistics<T>::Clear()
+{
+  this->Count = 0;
+  this->NumberOfPushes = 0;
+  this->NumberOfRemovals = 0;
+  this->NumberOfComponents = 0;
+  this->Values.clear();
+  this->Mean.clear();
+  this->SumOfSquaredDifferences.clear();
+  this->MinCandidates.clear();
+  this->MaxCandidates.clear();
+}
+
+template <typename T>
+size_t SlidingWindowStatistics<T>::GetWindowSize() const
+{
+  return this->WindowSize;
+}
+
+template <typename T>
+size_t SlidingWindowStatistics<T>::GetCount() const
+{
+  return this->Count;
+}
+
+template <typename T>
+bool SlidingWindowStatistics<T>::IsFull() const
+{
+  return this->Count == this->WindowSize;
+}
+
+template <typename T>
+unsigned int SlidingWindowStatistics<T>::GetNumberOfComponents() const
+{
+  return this->NumberOfComponents;
+}
+
+template <typename T>
+void SlidingWindowStatistics<T>::CheckNotEmpty() const
+{
+  if(this->Count == 0)
+  {
+    throw std::runtime_error("SlidingWindowStatistics: no values have been pushed!");
+  }
+}
+
+template <typename T>
+void SlidingWindowStatistics<T>::Recompute()
+{
+  const double count = static_cast<double>(this->Count);
+  for(unsigned int component = 0; component < this->NumberOfComponents; ++component)
+  {
+    double sum = 0.0;
+    for(size_t i = 0; i < this->Count; ++i)
+    {
+      sum += this->Values[i * this->NumberOfComponents + component];
+    }
+    const double mean = sum / count;
+
+    double sumOfSquaredDifferences = 0.0;
+    for(size_t i = 0; i < this->Count; ++i)
+    {
+      const double difference = this->Values[i * this->NumberOfComponents + component] - mean;
+      sumOfSquaredDifferences += difference * difference;
+    }
+
+    this->Mean[component] = mean;
+    this->SumOfSquaredDifferences[component] = sumOfSquaredDifferences;
+  }
+
+  this->NumberOfRemovals = 0;
+}
+
+template <typename T>
+double SlidingWindowStatistics<T>::GetMean(const unsigned int component) const
+{
+  this->CheckNotEmpty();
+  return this->Mean[component];
+}
+
+template <typename T>
+double SlidingWindowStatistics<T>::GetVariance(const unsigned int component) const
+{
+  this->CheckNotEmpty();
+
+  // This (N-1) term in the denominator is for the "unbiased" sample variance.
+  // Rounding can make the running sum very slightly negative when every value in the window is the same.
+  return std::max(0.0, this->SumOfSquaredDifferences[component]) / static_cast<double>(this->Count - 1);
+}
+
+template <typename T>
+double SlidingWindowStatistics<T>::GetMin(const unsigned int component) const
+{
+  this->CheckNotEmpty();
+  return this->MinCandidates[component].front().second;
+}
+
+template <typename T>
+double SlidingWindowStatistics<T>::GetMax(const unsigned int component) const
+{
+  this->CheckNotEmpty();
+  return this->MaxCandidates[component].front().second;
+}
+
+template <typename T>
+template <typename TOutput>
+TOutput SlidingWindowStatistics<T>::CreateOutput(const std::vector<double>& componentValues) const
+{
+  this->CheckNotEmpty();
+
+  // Start from one of the values so that the output has the right number of components.
+  TOutput output = this->Prototype;
+  for(unsigned int component = 0; component < componentValues.size(); ++component)
+  {
+    Helpers::index(output, component) = componentValues[component];
+  }
+  return output;
+}
+
+template <typename T>
+typename SlidingWindowStatistics<T>::LargerType SlidingWindowStatistics<T>::GetMean() const
+{
+  return this->CreateOutput<LargerType>(this->Mean);
+}
+
+template <typename T>
+typename SlidingWindowStatistics<T>::LargerType SlidingWindowStatistics<T>::GetVariance() const
+{
+  this->CheckNotEmpty();
+
+  std::vector<double> variance(this->NumberOfComponents);
+  for(unsigned int component = 0; component < variance.size(); ++component)
+  {
+    variance[component] = this->GetVariance(component);
+  }
+  return this->CreateOutput<LargerType>(variance);
+}
+
+template <typename T>
+T SlidingWindowStatistics<T>::GetMin() const
+{
+  this->CheckNotEmpty();
+
+  std::vector<double> minimum(this->NumberOfComponents);
+  for(unsigned int component = 0; component < minimum.size(); ++component)
+  {
+    minimum[component] = this->GetMin(component);
+  }
+  return this->CreateOutput<T>(minimum);
+}
+
+template <typename T>
+T SlidingWindowStatistics<T>::GetMax() const
+{
+  this->CheckNotEmpty();
+
+  std::vector<double> maximum(this->NumberOfComponents);
+  for(unsigned int component = 0; component < maximum.size(); ++component)
+  {
+    maximum[component] = this->GetMax(component);
+  }
+  return this->CreateOutput<T>(maximum);
+}
+
+template <typename TVector>
+std::vector<typename TypeTraits<typename TVector::value_type>::LargerType>
+MovingAverage(const TVector& v, const size_t windowSize)
+{
+  typedef typename TVector::value_type ValueType;
+
+  std::vector<typename TypeTraits<ValueType>::LargerType> output;
+  SlidingWindowStatistics<ValueType> window(windowSize);
+  for(size_t i = 0; i < v.size(); ++i)
+  {
+    window.Push(v[i]);
+    if(window.IsFull())
+    {
+      output.push_back(window.GetMean());
+    }
+  }
+  return output;
+}
+
+template <typename TVector>
+std::vector<typename TypeTraits<typename TVector::value_type>::LargerType>
+MovingVariance(const TVector& v, const size_t windowSize)
+{
+  typedef typename TVector::value_type ValueType;
+
+  std::vector<typename TypeTraits<ValueType>::LargerType> output;
+  SlidingWindowStatistics<ValueType> window(windowSize);
+  for(size_t i = 0; i < v.size(); ++i)
+  {
+    window.Push(v[i]);
+    if(window.IsFull())
+    {
+      output.push_back(window.GetVariance());
+    }
+  }
+  return output;
+}
+
+template <typename TVector>
+std::vector<typename TVector::value_type> MovingMin(const TVector& v, const size_t windowSize)
+{
+  typedef typename TVector::value_type ValueType;
+
+  std::vector<ValueType> output;
+  SlidingWindowStatistics<ValueType> window(windowSize);
+  for(size_t i = 0; i < v.size(); ++i)
+  {
+    window.Push(v[i]);
+    if(window.IsFull())
+    {
+      output.push_back(window.GetMin());
+    }
+  }
+  return output;
+}
+
+template <typename TVector>
+std::vector<typename TVector::value_type> MovingMax(const TVector& v, const size_t windowSize)
+{
+  typedef typename TVector::value_type ValueType;
+
+  std::vector<ValueType> output;
+  SlidingWindowStatistics<ValueType> window(windowSize);
+  for(size_t i = 0; i < v.size(); ++i)
+  {
+    window.Push(v[i]);
+    if(window.IsFull())
+    {
+      output.push_back(window.GetMax());
+    }
+  }
+  return output;
+}
+
+} // end namespace
+
+#endif
@@ -19,12 +19,22 @@
 #ifndef Statistics_H
 #define Statistics_H
 
+// STL
+#include <cstddef> // for size_t
+#include <vector>
+
 // Custom
+#include "Parallel.h"
+#include "StatisticsKernels.h"
 #include "TypeTraits.h"
 
 namespace Statistics
 {
 
+/** The parallel overloads below use the serial versions for inputs with fewer elements than this
+    (see Parallel.h). */
+using Helpers::MinimumParallelLength;
+
 /** Average the values in a vector. This function can handle the case
     where the vector contains vector-valued data (e.g. std::vector<RGBPixel>).*/
 template<typename TVector>
@@ -41,10 +51,172 @@ typename TypeTraits<TVector>::LargerComponentType RunningAverage(const TVector&
 template<typename TVector>
 typename TypeTraits<TVector>::LargerComponentType Variance(const TVector& v);
 
-/** Compute the correlation of two vectors. */
+/** Compute the (Pearson) correlation of two vectors in a single pass. To correlate one vector against
+    many others, use BatchCorrelation, which computes the mean and norm of each candidate only once. */
 template<typename TVector>
 typename TypeTraits<TVector>::LargerComponentType Correlation(const TVector& v1, const TVector& v2);
 
+/** This version of Average is used for std::vectors of the scalar types in StatisticsKernels.h,
+    and sums the values with the vectorized kernels in double precision. */
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType Average(const TVector& v, std::true_type);
+
+/** This version of Average is used for all other containers. Each component is summed in the
+    TypeTraits<>::SumType of its scalar type, so integer data is summed exactly. */
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType Average(const TVector& v, std::false_type);
+
+/** This version of Average is used for containers (with begin() and end()) of scalars, and sums them
+    with Helpers::AccumulateSum. */
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType AverageOfElements(const TVector& v, std::true_type);
+
+/** This version of Average is used for containers of multi-component values. */
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType AverageOfElements(const TVector& v, std::false_type);
+
+/** This version of Variance is used for std::vectors of the scalar types in StatisticsKernels.h,
+    and computes the mean and variance in a single vectorized pass. */
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType Variance(const TVector& v, std::true_type);
+
+/** This version of Variance is used for all other containers. */
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType Variance(const TVector& v, std::false_type);
+
+/** Average the values in a vector using 'numberOfThreads' threads (0 means every core).
+    Each thread sums its block in the TypeTraits<>::SumType of the scalars (double for floating point data,
+    exact 64 bit integers for integer data) and the block sums are added at the end, so the
+    result agrees with the serial Average to within the rounding error of the serial accumulation
+    (a relative error of at most about N * epsilon of the component type), and is usually closer to the exact value. */
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType Average(const TVector& v, const unsigned int numberOfThreads);
+
+/** Compute the variance of the values in a vector using 'numberOfThreads' threads (0 means every core).
+    Each thread computes the count, mean and sum of squared differences of its block in double precision,
+    and the blocks are combined with Chan et al.'s pairwise update. The same error bound as the parallel
+    Average applies. */
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType Variance(const TVector& v, const unsigned int numberOfThreads);
+
+/** Compute the correlation of two vectors using 'numberOfThreads' threads (0 means every core).
+    This uses the same definition as the serial Correlation, with the means, variances and co-moment
+    of each block combined with Chan et al.'s pairwise update. */
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType Correlation(const TVector& v1, const TVector& v2,
+                                                              const unsigned int numberOfThreads);
+
+/** The count, mean and sum of squared differences from the mean of part of the data, per component.
+    These are what the parallel functions compute for each block. */
+struct PartialMoments
+{
+  PartialMoments(const unsigned int numberOfComponents = 0) :
+    Count(0), Mean(numberOfComponents, 0.0), SumOfSquaredDifferences(numberOfComponents, 0.0) {}
+
+  /** Combine the moments of another block into these (Chan et al.). */
+  void Merge(const PartialMoments& other)
+  {
+    if(other.Count == 0)
+    {
+      return;
+    }
+
+    const double combinedCount = this->Count + other.Count;
+    for(size_t component = 0; component < this->Mean.size(); ++component)
+    {
+      const double delta = other.Mean[component] - this->Mean[component];
+      this->Mean[component] += delta * other.Count / combinedCount;
+      this->SumOfSquaredDifferences[component] += other.SumOfSquaredDifferences[component] +
+                                                  delta * delta * this->Count * other.Count / combinedCount;
+    }
+    this->Count = combinedCount;
+  }
+
+  double Count;
+  std::vector<double> Mean;
+  std::vector<double> SumOfSquaredDifferences;
+};
+
+/** Compute the count, means and sums of squared differences of v1 and v2 (components 0 and 1 of 'moments')
+    and their co-moment, sum_i (v1[i] - mean1)(v2[i] - mean2), over the elements [begin, end) in a single pass. */
+template<typename TVector>
+void ComputeCoMoments(const TVector& v1, const TVector& v2, const size_t begin, const size_t end,
+                      PartialMoments& moments, double& coMoment);
+
+/** Compute the count, mean and sum of squared differences of every channel of the elements [begin, end)
+    of 'v', reading each element once and updating every channel's sums from it (rather than walking the data
+    once per channel). Elements with 1, 3, 4 or 8 channels use ComputeFixedChannelMoments. */
+template<typename TVector>
+void ComputeChannelMoments(const TVector& v, const size_t begin, const size_t end, PartialMoments& moments);
+
+/** The version of ComputeChannelMoments for elements with exactly NumberOfChannels channels, which
+    lets the compiler keep the sums in registers and unroll the loop over the channels. */
+template<unsigned int NumberOfChannels, typename TVector>
+void ComputeFixedChannelMoments(const TVector& v, const size_t begin, const size_t end, PartialMoments& moments);
+
+/** The version of ComputeChannelMoments for any number of channels. */
+template<typename TVector>
+void ComputeDynamicChannelMoments(const TVector& v, const size_t begin, const size_t end, PartialMoments& moments);
+
+/** The count, mean and co-moments sum_i (x_i[a] - mean[a])(x_i[b] - mean[b]) of every pair of channels (a, b)
+    of part of the data. Only the upper triangle (a <= b) of the row-major CoMoments matrix is used. */
+struct PartialCoMoments
+{
+  PartialCoMoments(const unsigned int numberOfChannels = 0) :
+    Count(0), Mean(numberOfChannels, 0.0), CoMoments(numberOfChannels * numberOfChannels, 0.0) {}
+
+  /** Combine the co-moments of another block into these (Chan et al.). */
+  void Merge(const PartialCoMoments& other)
+  {
+    if(other.Count == 0)
+    {
+      return;
+    }
+
+    const size_t numberOfChannels = this->Mean.size();
+    const double combinedCount = this->Count + other.Count;
+    const double weight = this->Count * other.Count / combinedCount;
+    for(size_t a = 0; a < numberOfChannels; ++a)
+    {
+      const double deltaA = other.Mean[a] - this->Mean[a];
+      for(size_t b = a; b < numberOfChannels; ++b)
+      {
+        const double deltaB = other.Mean[b] - this->Mean[b];
+        this->CoMoments[a * numberOfChannels + b] += other.CoMoments[a * numberOfChannels + b] + deltaA * deltaB * weight;
+      }
+    }
+
+    for(size_t channel = 0; channel < numberOfChannels; ++channel)
+    {
+      this->Mean[channel] += (other.Mean[channel] - this->Mean[channel]) * other.Count / combinedCount;
+    }
+    this->Count = combinedCount;
+  }
+
+  double Count;
+  std::vector<double> Mean;
+  std::vector<double> CoMoments;
+};
+
+/** Compute the count, means and co-moments of every pair of channels of the elements [begin, end) of 'v' in
+    a single pass. The elements are read in tiles: the differences of each tile from the first element are
+    transposed into one contiguous row per channel, and each pair of rows is then accumulated with a
+    (vectorizable) dot product. Only the pairs a <= b are computed, since the matrix is symmetric. */
+template<typename TVector>
+void ComputeCoMoments(const TVector& v, const size_t begin, const size_t end, PartialCoMoments& coMoments);
+
+/** Compute the covariance matrix of the channels of the (vector-valued) elements of 'v', using the same unbiased
+    (N-1) normalization as Variance. The matrix is returned as one row per channel, and each row has the same type
+    as the output of Variance (so the diagonal is the output of Variance). */
+template<typename TVector>
+std::vector<typename TypeTraits<TVector>::LargerComponentType> Covariance(const TVector& v);
+
+/** Compute the covariance matrix using 'numberOfThreads' threads (0 means every core). Each thread computes the
+    co-moments of its block, and these are combined with Chan et al.'s pairwise update. */
+template<typename TVector>
+std::vector<typename TypeTraits<TVector>::LargerComponentType> Covariance(const TVector& v,
+                                                                         const unsigned int numberOfThreads);
+
 }
 
 #include "Statistics.hpp"
@@ -23,8 +23,10 @@
 #include "Helpers.h"
 #include "Statistics.h"
 #include "ContainerInterface.h"
+#include "Parallel.h"
 
 // STL
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <stdexcept>
@@ -60,32 +62,96 @@ typename TypeTraits<TVector>::LargerComponentType RunningAverage(const TVector&
 template<typename TVector>
 typename TypeTraits<TVector>::LargerComponentType Average(const TVector& v)
 {
-  //std::cout << "Helpers::Average" << std::endl;
+  return Average(v, HasStatisticsKernel<TVector>());
+}
+
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType Average(const TVector& v, std::true_type)
+{
   typedef typename TypeTraits<TVector>::LargerComponentType AverageType;
 
+  return static_cast<AverageType>(Sum(v.data(), v.size()) / static_cast<double>(v.size()));
+}
+
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType Average(const TVector& v, std::false_type)
+{
+  typedef typename std::decay<decltype(v[0])>::type ElementType;
+
+  return AverageOfElements(v, std::is_arithmetic<ElementType>());
+}
+
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType AverageOfElements(const TVector& v, std::true_type)
+{
+  typedef typename TypeTraits<TVector>::LargerComponentType AverageType;
+  typedef typename std::decay<decltype(v[0])>::type ElementType;
+  typedef typename TypeTraits<ElementType>::SumType SumType;
+
+  // Sum in the SumType of the elements (exactly, for integers; pairwise, for floating point values) and
+  // convert to the output type only once, when dividing by the number of elements.
+  const SumType sum = Helpers::AccumulateSum<SumType>(v.begin(), v.end());
+  return static_cast<AverageType>(static_cast<double>(sum) / static_cast<double>(Helpers::length(v)));
+}
+
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType AverageOfElements(const TVector& v, std::false_type)
+{
+  typedef typename TypeTraits<TVector>::LargerComponentType AverageType;
+
+  // Each component is summed in the SumType of its scalar type and is converted to the output type
+  // only once, as above.
+  typedef typename std::decay<decltype(Helpers::index(v[0], 0))>::type ScalarType;
+  typedef typename TypeTraits<ScalarType>::SumType SumType;
+
+  const size_t numberOfElements = Helpers::length(v);
+  const unsigned int numberOfComponents = Helpers::length(v[0]);
+
+  std::vector<SumType> sums(numberOfComponents, 0);
+  for(size_t i = 0; i < numberOfElements; ++i)
+  {
+    for(unsigned int component = 0; component < numberOfComponents; ++component)
+    {
+      sums[component] += Helpers::index(v[i], component);
+    }
+  }
+
   // We do this because if the components of 'v' are themselves vectors and their length is not known until runtime
   // (e.g. 'v' is a std::vector, itk::VariableLengthVector, etc), this will make the output/average vector
   // be the correct length.
-  AverageType vectorSum = v[0];
+  AverageType average = v[0];
+  for(unsigned int component = 0; component < numberOfComponents; ++component)
+  {
+    Helpers::index(average, component) = static_cast<double>(sums[component]) / static_cast<double>(numberOfElements);
+  }
 
-  // Zero the initial vector
-  Helpers::SetToZero(vectorSum);
+  return average;
+}
 
-  for(unsigned int i = 0; i < Helpers::length(v); ++i)
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType Variance(const TVector& v)
+{
+  return Variance(v, HasStatisticsKernel<TVector>());
+}
+
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType Variance(const TVector& v, std::true_type)
+{
+  if(v.size() <= 0)
   {
-    vectorSum += Helpers::index(v,i);
+    throw std::runtime_error("Must have more than 0 items to compute a variance!");
   }
 
-  // std::cout << "Average: sum " << vectorSum << std::endl;
-  AverageType vectorAverage = vectorSum / static_cast<float>(Helpers::length(v));
-
-  // std::cout << "Average: average " << vectorAverage << std::endl;
+  typedef typename TypeTraits<TVector>::LargerComponentType VarianceType;
 
-  return vectorAverage;
+  double mean = 0.0;
+  double variance = 0.0;
+  MeanAndVariance(v.data(), v.size(), mean, variance);
+  return static_cast<VarianceType>(variance);
 }
 
 template<typename TVector>
-typename TypeTraits<TVector>::LargerComponentType Variance(const TVector& v)
+typename TypeTraits<TVector>::LargerComponentType Variance(const TVector& v, std::false_type)
 {
   assert(Helpers::length(v) > 0);
   if(Helpers::length(v) <= 0)
@@ -95,9 +161,9 @@ typename TypeTraits<TVector>::LargerComponentType Variance(const TVector& v)
 
   typedef typename TypeTraits<TVector>::LargerComponentType VarianceType;
 
-  // Compute the average, because we need it in the variance calculator.
-  VarianceType average = Average(v);
-  // std::cout << "Variance: average = " << average << std::endl;
+  // Read the (possibly multi-component) elements once, updating every channel per element.
+  PartialMoments moments;
+  ComputeChannelMoments(v, 0, Helpers::length(v), moments);
 
   // We do this (assign variance to the 0th element of the vector 'v') because if the elements of 'v' are
   // themselves vectors and their length is not known until runtime (e.g. they are std::vector, itk::VariableLengthVector, etc.),
@@ -107,16 +173,10 @@ typename TypeTraits<TVector>::LargerComponentType Variance(const TVector& v)
   // Variance = 1/(NumPixels-1) * sum_i (x_i - u)^2
   for(unsigned int component = 0; component < Helpers::length(variance); ++component)
   {
-    float channelVarianceSummation = 0.0f;
-    for(unsigned int i = 0; i < Helpers::length(v); ++i)
-    {
-      channelVarianceSummation += pow(Helpers::index(v[i], component) -
-                                      Helpers::index(average, component), 2);
-    }
     // This (N-1) term in the denominator is for the "unbiased" sample variance.
     // This is what is used by Matlab, Wolfram alpha, etc.
-    float channelVariance = channelVarianceSummation / static_cast<float>(Helpers::length(v) - 1);
-    Helpers::index(variance, component) = channelVariance;
+    Helpers::index(variance, component) = moments.SumOfSquaredDifferences[component] /
+                                          static_cast<double>(Helpers::length(v) - 1);
   }
   return variance;
 }
@@ -125,27 +185,384 @@ template<typename TVector>
 typename TypeTraits<TVector>::LargerComponentType Correlation(const TVector& v1, const TVector& v2)
 {
   // http://docs.opencv.org/doc/tutorials/imgproc/histograms/histogram_comparison/histogram_comparison.html
-  // d(H_1, H_2) = \frac{\sum_i(H_1(i) - \bar{H_1})(H_2(i)-\bar{H_2})}{sqrt(var(H_1)var(H_2))}
+  // d(H_1, H_2) = \frac{\sum_i(H_1(i) - \bar{H_1})(H_2(i)-\bar{H_2})}{sqrt(\sum_i(H_1(i) - \bar{H_1})^2 \sum_i(H_2(i) - \bar{H_2})^2)}
 
   assert(Helpers::length(v1) > 0);
   assert(Helpers::length(v1) == Helpers::length(v2));
 
-  float numerator = 0.0f;
+  // Both means, both sums of squared differences and the co-moment come from a single pass over the data.
+  PartialMoments moments(2);
+  double coMoment = 0.0;
+  ComputeCoMoments(v1, v2, 0, Helpers::length(v1), moments, coMoment);
+
+  return coMoment / sqrt(moments.SumOfSquaredDifferences[0] * moments.SumOfSquaredDifferences[1]);
+}
+
+template<typename TVector>
+void ComputeCoMoments(const TVector& v1, const TVector& v2, const size_t begin, const size_t end,
+                      PartialMoments& moments, double& coMoment)
+{
+  // Accumulate relative to the first values so that large offsets do not cancel catastrophically.
+  const double shift1 = v1[begin];
+  const double shift2 = v2[begin];
+  double sum1 = 0.0;
+  double sum2 = 0.0;
+  double sumOfSquares1 = 0.0;
+  double sumOfSquares2 = 0.0;
+  double sumOfProducts = 0.0;
+  for(size_t i = begin; i < end; ++i)
+  {
+    const double difference1 = v1[i] - shift1;
+    const double difference2 = v2[i] - shift2;
+    sum1 += difference1;
+    sum2 += difference2;
+    sumOfSquares1 += difference1 * difference1;
+    sumOfSquares2 += difference2 * difference2;
+    sumOfProducts += difference1 * difference2;
+  }
+
+  moments.Count = static_cast<double>(end - begin);
+  moments.Mean.resize(2);
+  moments.SumOfSquaredDifferences.resize(2);
+  moments.Mean[0] = shift1 + sum1 / moments.Count;
+  moments.Mean[1] = shift2 + sum2 / moments.Count;
+  moments.SumOfSquaredDifferences[0] = sumOfSquares1 - sum1 * sum1 / moments.Count;
+  moments.SumOfSquaredDifferences[1] = sumOfSquares2 - sum2 * sum2 / moments.Count;
+  coMoment = sumOfProducts - sum1 * sum2 / moments.Count;
+}
+
+template<typename TVector>
+void ComputeChannelMoments(const TVector& v, const size_t begin, const size_t end, PartialMoments& moments)
+{
+  switch(Helpers::length(v[begin]))
+  {
+    case 1:
+      ComputeFixedChannelMoments<1>(v, begin, end, moments);
+      break;
+    case 3:
+      ComputeFixedChannelMoments<3>(v, begin, end, moments);
+      break;
+    case 4:
+      ComputeFixedChannelMoments<4>(v, begin, end, moments);
+      break;
+    case 8:
+      ComputeFixedChannelMoments<8>(v, begin, end, moments);
+      break;
+    default:
+      ComputeDynamicChannelMoments(v, begin, end, moments);
+      break;
+  }
+}
+
+template<unsigned int NumberOfChannels, typename TVector>
+void ComputeFixedChannelMoments(const TVector& v, const size_t begin, const size_t end, PartialMoments& moments)
+{
+  // Accumulate the sums in one pass, relative to the first element so that
+  // large offsets do not cancel catastrophically.
+  double shift[NumberOfChannels];
+  double sum[NumberOfChannels];
+  double sumOfSquares[NumberOfChannels];
+  for(unsigned int channel = 0; channel < NumberOfChannels; ++channel)
+  {
+    shift[channel] = Helpers::index(v[begin], channel);
+    sum[channel] = 0.0;
+    sumOfSquares[channel] = 0.0;
+  }
+
+  for(size_t i = begin; i < end; ++i)
+  {
+    assert(Helpers::length(v[i]) == NumberOfChannels);
+    for(unsigned int channel = 0; channel < NumberOfChannels; ++channel)
+    {
+      const double difference = Helpers::index(v[i], channel) - shift[channel];
+      sum[channel] += difference;
+      sumOfSquares[channel] += difference * difference;
+    }
+  }
+
+  moments.Count = static_cast<double>(end - begin);
+  moments.Mean.resize(NumberOfChannels);
+  moments.SumOfSquaredDifferences.resize(NumberOfChannels);
+  for(unsigned int channel = 0; channel < NumberOfChannels; ++channel)
+  {
+    moments.Mean[channel] = shift[channel] + sum[channel] / moments.Count;
+    moments.SumOfSquaredDifferences[channel] = sumOfSquares[channel] - sum[channel] * sum[channel] / moments.Count;
+  }
+}
+
+template<typename TVector>
+void ComputeDynamicChannelMoments(const TVector& v, const size_t begin, const size_t end, PartialMoments& moments)
+{
+  const unsigned int numberOfChannels = Helpers::length(v[begin]);
+
+  std::vector<double> shift(numberOfChannels);
+  std::vector<double> sum(numberOfChannels, 0.0);
+  std::vector<double> sumOfSquares(numberOfChannels, 0.0);
+  for(unsigned int channel = 0; channel < numberOfChannels; ++channel)
+  {
+    shift[channel] = Helpers::index(v[begin], channel);
+  }
+
+  for(size_t i = begin; i < end; ++i)
+  {
+    for(unsigned int channel = 0; channel < numberOfChannels; ++channel)
+    {
+      const double difference = Helpers::index(v[i], channel) - shift[channel];
+      sum[channel] += difference;
+      sumOfSquares[channel] += difference * difference;
+    }
+  }
+
+  moments.Count = static_cast<double>(end - begin);
+  moments.Mean.resize(numberOfChannels);
+  moments.SumOfSquaredDifferences.resize(numberOfChannels);
+  for(unsigned int channel = 0; channel < numberOfChannels; ++channel)
+  {
+    moments.Mean[channel] = shift[channel] + sum[channel] / moments.Count;
+    moments.SumOfSquaredDifferences[channel] = sumOfSquares[channel] - sum[channel] * sum[channel] / moments.Count;
+  }
+}
+
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType Average(const TVector& v, const unsigned int numberOfThreads)
+{
+  const size_t numberOfElements = Helpers::length(v);
+  const unsigned int numberOfBlocks = Helpers::GetNumberOfThreads(numberOfThreads);
+  if(numberOfElements < MinimumParallelLength || numberOfBlocks == 1)
+  {
+    return Average(v);
+  }
+
+  typedef typename TypeTraits<TVector>::LargerComponentType AverageType;
+  typedef typename std::decay<decltype(Helpers::index(v[0], 0))>::type ScalarType;
+  typedef typename TypeTraits<ScalarType>::SumType SumType;
+
+  const unsigned int numberOfComponents = Helpers::length(v[0]);
+
+  std::vector<std::vector<SumType> > blockSums(numberOfBlocks, std::vector<SumType>(numberOfComponents, 0));
+  Helpers::ParallelForBlocks(numberOfElements, numberOfBlocks,
+                             [&](const size_t blockBegin, const size_t blockEnd, const unsigned int blockId)
+  {
+    std::vector<SumType>& sum = blockSums[blockId];
+    for(size_t i = blockBegin; i < blockEnd; ++i)
+    {
+      for(unsigned int component = 0; component < numberOfComponents; ++component)
+      {
+        sum[component] += Helpers::index(v[i], component);
+      }
+    }
+  });
+
+  // As in the serial version, start from v[0] so that the output has the right number of components.
+  AverageType average = v[0];
+  for(unsigned int component = 0; component < numberOfComponents; ++component)
+  {
+    SumType sum = 0;
+    for(unsigned int blockId = 0; blockId < numberOfBlocks; ++blockId)
+    {
+      sum += blockSums[blockId][component];
+    }
+    Helpers::index(average, component) = static_cast<double>(sum) / static_cast<double>(numberOfElements);
+  }
+
+  return average;
+}
+
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType Variance(const TVector& v, const unsigned int numberOfThreads)
+{
+  const size_t numberOfElements = Helpers::length(v);
+  const unsigned int numberOfBlocks = Helpers::GetNumberOfThreads(numberOfThreads);
+  if(numberOfElements < MinimumParallelLength || numberOfBlocks == 1)
+  {
+    return Variance(v);
+  }
+
+  typedef typename TypeTraits<TVector>::LargerComponentType VarianceType;
+
+  const unsigned int numberOfComponents = Helpers::length(v[0]);
+
+  std::vector<PartialMoments> blockMoments(numberOfBlocks, PartialMoments(numberOfComponents));
+  Helpers::ParallelForBlocks(numberOfElements, numberOfBlocks,
+                             [&](const size_t blockBegin, const size_t blockEnd, const unsigned int blockId)
+  {
+    ComputeChannelMoments(v, blockBegin, blockEnd, blockMoments[blockId]);
+  });
+
+  for(unsigned int blockId = 1; blockId < numberOfBlocks; ++blockId)
+  {
+    blockMoments[0].Merge(blockMoments[blockId]);
+  }
+
+  VarianceType variance = v[0];
+  for(unsigned int component = 0; component < numberOfComponents; ++component)
+  {
+    // This (N-1) term in the denominator is for the "unbiased" sample variance.
+    Helpers::index(variance, component) = blockMoments[0].SumOfSquaredDifferences[component] /
+                                          static_cast<double>(numberOfElements - 1);
+  }
+
+  return variance;
+}
+
+template<typename TVector>
+typename TypeTraits<TVector>::LargerComponentType Correlation(const TVector& v1, const TVector& v2,
+                                                              const unsigned int numberOfThreads)
+{
+  assert(Helpers::length(v1) == Helpers::length(v2));
+
+  const size_t numberOfElements = Helpers::length(v1);
+  const unsigned int numberOfBlocks = Helpers::GetNumberOfThreads(numberOfThreads);
+  if(numberOfElements < MinimumParallelLength || numberOfBlocks == 1)
+  {
+    return Correlation(v1, v2);
+  }
 
-  float meanV1 = Average(v1);
-  float meanV2 = Average(v2);
+  // Component 0 holds the moments of v1 and component 1 the moments of v2.
+  std::vector<PartialMoments> blockMoments(numberOfBlocks, PartialMoments(2));
+  std::vector<double> blockCoMoments(numberOfBlocks, 0.0);
+  Helpers::ParallelForBlocks(numberOfElements, numberOfBlocks,
+                             [&](const size_t blockBegin, const size_t blockEnd, const unsigned int blockId)
+  {
+    ComputeCoMoments(v1, v2, blockBegin, blockEnd, blockMoments[blockId], blockCoMoments[blockId]);
+  });
 
-  float varianceV1 = Variance(v1);
-  float varianceV2 = Variance(v2);
+  // The co-moment is merged like the sums of squared differences, with the product of the
+  // two mean differences in place of the squared mean difference.
+  PartialMoments combined = blockMoments[0];
+  double coMoment = blockCoMoments[0];
+  for(unsigned int blockId = 1; blockId < numberOfBlocks; ++blockId)
+  {
+    const PartialMoments& other = blockMoments[blockId];
+    const double combinedCount = combined.Count + other.Count;
+    coMoment += blockCoMoments[blockId] + (other.Mean[0] - combined.Mean[0]) * (other.Mean[1] - combined.Mean[1]) *
+                combined.Count * other.Count / combinedCount;
+    combined.Merge(other);
+  }
+
+  return coMoment / sqrt(combined.SumOfSquaredDifferences[0] * combined.SumOfSquaredDifferences[1]);
+}
+
+template<typename TVector>
+void ComputeCoMoments(const TVector& v, const size_t begin, const size_t end, PartialCoMoments& coMoments)
+{
+  const unsigned int numberOfChannels = Helpers::length(v[begin]);
+  const size_t tileSize = 64;
 
-  for(unsigned int i = 0; i < Helpers::length(v1); ++i)
+  // Accumulate relative to the first element so that large offsets do not cancel catastrophically.
+  std::vector<double> shift(numberOfChannels);
+  for(unsigned int channel = 0; channel < numberOfChannels; ++channel)
   {
-    numerator += (v1[i] - meanV1)*(v2[i] - meanV2);
+    shift[channel] = Helpers::index(v[begin], channel);
   }
 
-  float correlation = numerator/(sqrt(varianceV1 * varianceV2));
+  std::vector<double> sums(numberOfChannels, 0.0);
+  std::vector<double> products(numberOfChannels * numberOfChannels, 0.0);
+  std::vector<double> tile(numberOfChannels * tileSize);
+
+  for(size_t tileBegin = begin; tileBegin < end; tileBegin += tileSize)
+  {
+    const size_t tileLength = std::min(tileSize, end - tileBegin);
+
+    // Transpose the tile, so that each channel's differences are contiguous.
+    for(size_t i = 0; i < tileLength; ++i)
+    {
+      for(unsigned int channel = 0; channel < numberOfChannels; ++channel)
+      {
+        tile[channel * tileSize + i] = Helpers::index(v[tileBegin + i], channel) - shift[channel];
+      }
+    }
+
+    for(unsigned int a = 0; a < numberOfChannels; ++a)
+    {
+      const double* rowA = &tile[a * tileSize];
+      double sum = 0.0;
+      for(size_t i = 0; i < tileLength; ++i)
+      {
+        sum += rowA[i];
+      }
+      sums[a] += sum;
+
+      for(unsigned int b = a; b < numberOfChannels; ++b)
+      {
+        const double* rowB = &tile[b * tileSize];
+        double product = 0.0;
+        for(size_t i = 0; i < tileLength; ++i)
+        {
+          product += rowA[i] * rowB[i];
+        }
+        products[a * numberOfChannels + b] += product;
+      }
+    }
+  }
+
+  coMoments.Count = static_cast<double>(end - begin);
+  coMoments.Mean.resize(numberOfChannels);
+  coMoments.CoMoments.assign(numberOfChannels * numberOfChannels, 0.0);
+  for(unsigned int a = 0; a < numberOfChannels; ++a)
+  {
+    coMoments.Mean[a] = shift[a] + sums[a] / coMoments.Count;
+    for(unsigned int b = a; b < numberOfChannels; ++b)
+    {
+      coMoments.CoMoments[a * numberOfChannels + b] = products[a * numberOfChannels + b] -
+                                                      sums[a] * sums[b] / coMoments.Count;
+    }
+  }
+}
+
+template<typename TVector>
+std::vector<typename TypeTraits<TVector>::LargerComponentType> Covariance(const TVector& v)
+{
+  return Covariance(v, 1);
+}
+
+template<typename TVector>
+std::vector<typename TypeTraits<TVector>::LargerComponentType> Covariance(const TVector& v,
+                                                                         const unsigned int numberOfThreads)
+{
+  const size_t numberOfElements = Helpers::length(v);
+  if(numberOfElements <= 0)
+  {
+    throw std::runtime_error("Must have more than 0 items to compute a covariance!");
+  }
+
+  typedef typename TypeTraits<TVector>::LargerComponentType RowType;
+
+  const unsigned int numberOfChannels = Helpers::length(v[0]);
+  unsigned int numberOfBlocks = Helpers::GetNumberOfThreads(numberOfThreads);
+  if(numberOfElements < MinimumParallelLength)
+  {
+    numberOfBlocks = 1;
+  }
+
+  std::vector<PartialCoMoments> blockCoMoments(numberOfBlocks, PartialCoMoments(numberOfChannels));
+  Helpers::ParallelForBlocks(numberOfElements, numberOfBlocks,
+                             [&](const size_t blockBegin, const size_t blockEnd, const unsigned int blockId)
+  {
+    ComputeCoMoments(v, blockBegin, blockEnd, blockCoMoments[blockId]);
+  });
+
+  for(unsigned int blockId = 1; blockId < numberOfBlocks; ++blockId)
+  {
+    blockCoMoments[0].Merge(blockCoMoments[blockId]);
+  }
+
+  // We do this (assign each row to the 0th element of the vector 'v') for the same reason as in Variance,
+  // so that the rows have the right number of components.
+  std::vector<RowType> covariance(numberOfChannels, v[0]);
+  for(unsigned int a = 0; a < numberOfChannels; ++a)
+  {
+    for(unsigned int b = a; b < numberOfChannels; ++b)
+    {
+      // This (N-1) term in the denominator is for the "unbiased" sample covariance.
+      const double value = blockCoMoments[0].CoMoments[a * numberOfChannels + b] /
+                           static_cast<double>(numberOfElements - 1);
+      Helpers::index(covariance[a], b) = value;
+      Helpers::index(covariance[b], a) = value;
+    }
+  }
 
-  return correlation;
+  return covariance;
 }
 
 }
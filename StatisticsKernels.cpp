@@ -0,0 +1,654 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "StatisticsKernels.h"
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+// The vectorized kernels need GCC/Clang style target attributes so that they can be compiled without
+// -mavx2 etc. and only be called on CPUs that support them.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define STATISTICS_KERNELS_X86
+#include <immintrin.h>
+#define KERNEL_TARGET(instructionSet) __attribute__((target(instructionSet)))
+// Some versions of GCC's AVX-512 headers initialize their "undefined" vectors from themselves, which
+// triggers false uninitialized warnings once the intrinsics are inlined.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#endif
+
+namespace Statistics
+{
+
+namespace
+{
+
+/** The sum of (x - shift) and of (x - shift)^2 over a buffer. Computing these relative to one of the
+  * values (rather than to 0) keeps the variance from cancelling catastrophically when the mean is large. */
+struct ShiftedSums
+{
+  double Sum;
+  double SumOfSquares;
+};
+
+/** Every kernel has a TSquares flag: if it is false, the sum of squares is not computed (and is left at 0),
+  * so that a plain Sum does half the arithmetic. */
+template <bool TSquares, typename T>
+ShiftedSums GenericShiftedSums(const T* data, const size_t length, const double shift)
+{
+  ShiftedSums sums = {0.0, 0.0};
+  for(size_t i = 0; i < length; ++i)
+  {
+    const double difference = static_cast<double>(data[i]) - shift;
+    sums.Sum += difference;
+    if(TSquares)
+    {
+      sums.SumOfSquares += difference * difference;
+    }
+  }
+  return sums;
+}
+
+/** Exact integer sums of a buffer of unsigned char. */
+template <bool TSquares>
+void GenericByteSums(const unsigned char* data, const size_t length, uint64_t& sum, uint64_t& sumOfSquares)
+{
+  for(size_t i = 0; i < length; ++i)
+  {
+    sum += data[i];
+    if(TSquares)
+    {
+      sumOfSquares += static_cast<uint64_t>(data[i]) * data[i];
+    }
+  }
+}
+
+KernelInstructionSet DetectKernelInstructionSet()
+{
+#ifdef STATISTICS_KERNELS_X86
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+  {
+    return AVX512_INSTRUCTIONS;
+  }
+  if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+  {
+    return AVX2_INSTRUCTIONS;
+  }
+  if(__builtin_cpu_supports("sse2"))
+  {
+    return SSE2_INSTRUCTIONS;
+  }
+#endif
+  return GENERIC_INSTRUCTIONS;
+}
+
+std::atomic<int>& ActiveKernelInstructionSet()
+{
+  static std::atomic<int> activeInstructionSet(GetSupportedKernelInstructionSet());
+  return activeInstructionSet;
+}
+
+#ifdef STATISTICS_KERNELS_X86
+
+/** The SSE2, AVX2 and AVX-512 loaders read 2, 4 and 8 elements and convert them to doubles. */
+template <typename T>
+struct SSE2Loader;
+
+template <>
+struct SSE2Loader<float>
+{
+  KERNEL_TARGET("sse2") static inline __m128d Load(const float* data)
+  {
+    return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(data))));
+  }
+};
+
+template <>
+struct SSE2Loader<double>
+{
+  KERNEL_TARGET("sse2") static inline __m128d Load(const double* data)
+  {
+    return _mm_loadu_pd(data);
+  }
+};
+
+template <>
+struct SSE2Loader<unsigned short>
+{
+  KERNEL_TARGET("sse2") static inline __m128d Load(const unsigned short* data)
+  {
+    const __m128i values = _mm_cvtsi32_si128(static_cast<int>(data[0] | (static_cast<unsigned int>(data[1]) << 16)));
+    return _mm_cvtepi32_pd(_mm_unpacklo_epi16(values, _mm_setzero_si128()));
+  }
+};
+
+template <>
+struct SSE2Loader<int>
+{
+  KERNEL_TARGET("sse2") static inline __m128d Load(const int* data)
+  {
+    return _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(data)));
+  }
+};
+
+template <typename T>
+struct AVX2Loader;
+
+template <>
+struct AVX2Loader<float>
+{
+  KERNEL_TARGET("avx2,fma") static inline __m256d Load(const float* data)
+  {
+    return _mm256_cvtps_pd(_mm_loadu_ps(data));
+  }
+};
+
+template <>
+struct AVX2Loader<double>
+{
+  KERNEL_TARGET("avx2,fma") static inline __m256d Load(const double* data)
+  {
+    return _mm256_loadu_pd(data);
+  }
+};
+
+template <>
+struct AVX2Loader<unsigned short>
+{
+  KERNEL_TARGET("avx2,fma") static inline __m256d Load(const unsigned short* data)
+  {
+    return _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(data))));
+  }
+};
+
+template <>
+struct AVX2Loader<int>
+{
+  KERNEL_TARGET("avx2,fma") static inline __m256d Load(const int* data)
+  {
+    return _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+  }
+};
+
+template <typename T>
+struct AVX512Loader;
+
+template <>
+struct AVX512Loader<float>
+{
+  KERNEL_TARGET("avx512f,avx512bw") static inline __m512d Load(const float* data)
+  {
+    return _mm512_cvtps_pd(_mm256_loadu_ps(data));
+  }
+};
+
+template <>
+struct AVX512Loader<double>
+{
+  KERNEL_TARGET("avx512f,avx512bw") static inline __m512d Load(const double* data)
+  {
+    return _mm512_loadu_pd(data);
+  }
+};
+
+template <>
+struct AVX512Loader<unsigned short>
+{
+  KERNEL_TARGET("avx512f,avx512bw") static inline __m512d Load(const unsigned short* data)
+  {
+    return _mm512_cvtepi32_pd(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data))));
+  }
+};
+
+template <>
+struct AVX512Loader<int>
+{
+  KERNEL_TARGET("avx512f,avx512bw") static inline __m512d Load(const int* data)
+  {
+    return _mm512_cvtepi32_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)));
+  }
+};
+
+// Each kernel uses two independent pairs of accumulators so that consecutive iterations do not
+// wait on each other, and finishes the elements that do not fill a whole vector with the generic loop.
+
+template <bool TSquares, typename T>
+KERNEL_TARGET("sse2") ShiftedSums SSE2ShiftedSums(const T* data, const size_t length, const double shift)
+{
+  const size_t width = 2;
+  const __m128d shiftVector = _mm_set1_pd(shift);
+  __m128d sum0 = _mm_setzero_pd();
+  __m128d sum1 = _mm_setzero_pd();
+  __m128d squares0 = _mm_setzero_pd();
+  __m128d squares1 = _mm_setzero_pd();
+
+  size_t i = 0;
+  for(; i + 2 * width <= length; i += 2 * width)
+  {
+    const __m128d difference0 = _mm_sub_pd(SSE2Loader<T>::Load(data + i), shiftVector);
+    const __m128d difference1 = _mm_sub_pd(SSE2Loader<T>::Load(data + i + width), shiftVector);
+    sum0 = _mm_add_pd(sum0, difference0);
+    sum1 = _mm_add_pd(sum1, difference1);
+    if(TSquares)
+    {
+      squares0 = _mm_add_pd(squares0, _mm_mul_pd(difference0, difference0));
+      squares1 = _mm_add_pd(squares1, _mm_mul_pd(difference1, difference1));
+    }
+  }
+
+  double sumLanes[width];
+  double squaresLanes[width];
+  _mm_storeu_pd(sumLanes, _mm_add_pd(sum0, sum1));
+  _mm_storeu_pd(squaresLanes, _mm_add_pd(squares0, squares1));
+
+  ShiftedSums sums = GenericShiftedSums<TSquares>(data + i, length - i, shift);
+  sums.Sum += sumLanes[0] + sumLanes[1];
+  sums.SumOfSquares += squaresLanes[0] + squaresLanes[1];
+  return sums;
+}
+
+template <bool TSquares, typename T>
+KERNEL_TARGET("avx2,fma") ShiftedSums AVX2ShiftedSums(const T* data, const size_t length, const double shift)
+{
+  const size_t width = 4;
+  const __m256d shiftVector = _mm256_set1_pd(shift);
+  __m256d sum0 = _mm256_setzero_pd();
+  __m256d sum1 = _mm256_setzero_pd();
+  __m256d squares0 = _mm256_setzero_pd();
+  __m256d squares1 = _mm256_setzero_pd();
+
+  size_t i = 0;
+  for(; i + 2 * width <= length; i += 2 * width)
+  {
+    const __m256d difference0 = _mm256_sub_pd(AVX2Loader<T>::Load(data + i), shiftVector);
+    const __m256d difference1 = _mm256_sub_pd(AVX2Loader<T>::Load(data + i + width), shiftVector);
+    sum0 = _mm256_add_pd(sum0, difference0);
+    sum1 = _mm256_add_pd(sum1, difference1);
+    if(TSquares)
+    {
+      squares0 = _mm256_fmadd_pd(difference0, difference0, squares0);
+      squares1 = _mm256_fmadd_pd(difference1, difference1, squares1);
+    }
+  }
+
+  double sumLanes[width];
+  double squaresLanes[width];
+  _mm256_storeu_pd(sumLanes, _mm256_add_pd(sum0, sum1));
+  _mm256_storeu_pd(squaresLanes, _mm256_add_pd(squares0, squares1));
+
+  ShiftedSums sums = GenericShiftedSums<TSquares>(data + i, length - i, shift);
+  sums.Sum += (sumLanes[0] + sumLanes[1]) + (sumLanes[2] + sumLanes[3]);
+  sums.SumOfSquares += (squaresLanes[0] + squaresLanes[1]) + (squaresLanes[2] + squaresLanes[3]);
+  return sums;
+}
+
+template <bool TSquares, typename T>
+KERNEL_TARGET("avx512f,avx512bw") ShiftedSums AVX512ShiftedSums(const T* data, const size_t length, const double shift)
+{
+  const size_t width = 8;
+  const __m512d shiftVector = _mm512_set1_pd(shift);
+  __m512d sum0 = _mm512_setzero_pd();
+  __m512d sum1 = _mm512_setzero_pd();
+  __m512d squares0 = _mm512_setzero_pd();
+  __m512d squares1 = _mm512_setzero_pd();
+
+  size_t i = 0;
+  for(; i + 2 * width <= length; i += 2 * width)
+  {
+    const __m512d difference0 = _mm512_sub_pd(AVX512Loader<T>::Load(data + i), shiftVector);
+    const __m512d difference1 = _mm512_sub_pd(AVX512Loader<T>::Load(data + i + width), shiftVector);
+    sum0 = _mm512_add_pd(sum0, difference0);
+    sum1 = _mm512_add_pd(sum1, difference1);
+    if(TSquares)
+    {
+      squares0 = _mm512_fmadd_pd(difference0, difference0, squares0);
+      squares1 = _mm512_fmadd_pd(difference1, difference1, squares1);
+    }
+  }
+
+  double sumLanes[width];
+  double squaresLanes[width];
+  _mm512_storeu_pd(sumLanes, _mm512_add_pd(sum0, sum1));
+  _mm512_storeu_pd(squaresLanes, _mm512_add_pd(squares0, squares1));
+
+  ShiftedSums sums = GenericShiftedSums<TSquares>(data + i, length - i, shift);
+  for(size_t lane = 0; lane < width; ++lane)
+  {
+    sums.Sum += sumLanes[lane];
+    sums.SumOfSquares += squaresLanes[lane];
+  }
+  return sums;
+}
+
+// The unsigned char kernels are exact: the sums use SAD against 0, and the squares are accumulated
+// with madd in 32 bit lanes. Each iteration adds at most 2 * 2 * 255^2 to a 32 bit lane, so the lanes
+// are flushed to 64 bits every ByteBlockIterations iterations, long before they could overflow.
+const size_t ByteBlockIterations = 4096;
+
+template <bool TSquares>
+KERNEL_TARGET("sse2") void SSE2ByteSums(const unsigned char* data, const size_t length,
+                                        uint64_t& sum, uint64_t& sumOfSquares)
+{
+  const size_t width = 16;
+  const __m128i zero = _mm_setzero_si128();
+  __m128i sumVector = zero;
+  __m128i squaresVector = zero;
+
+  size_t i = 0;
+  while(i + width <= length)
+  {
+    __m128i squares32 = zero;
+    for(size_t iteration = 0; iteration < ByteBlockIterations && i + width <= length; ++iteration, i += width)
+    {
+      const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+      sumVector = _mm_add_epi64(sumVector, _mm_sad_epu8(values, zero));
+      if(TSquares)
+      {
+        const __m128i low = _mm_unpacklo_epi8(values, zero);
+        const __m128i high = _mm_unpackhi_epi8(values, zero);
+        squares32 = _mm_add_epi32(squares32, _mm_madd_epi16(low, low));
+        squares32 = _mm_add_epi32(squares32, _mm_madd_epi16(high, high));
+      }
+    }
+    squaresVector = _mm_add_epi64(squaresVector, _mm_unpacklo_epi32(squares32, zero));
+    squaresVector = _mm_add_epi64(squaresVector, _mm_unpackhi_epi32(squares32, zero));
+  }
+
+  uint64_t sumLanes[2];
+  uint64_t squaresLanes[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(sumLanes), sumVector);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(squaresLanes), squaresVector);
+  sum += sumLanes[0] + sumLanes[1];
+  sumOfSquares += squaresLanes[0] + squaresLanes[1];
+
+  GenericByteSums<TSquares>(data + i, length - i, sum, sumOfSquares);
+}
+
+template <bool TSquares>
+KERNEL_TARGET("avx2,fma") void AVX2ByteSums(const unsigned char* data, const size_t length,
+                                            uint64_t& sum, uint64_t& sumOfSquares)
+{
+  const size_t width = 32;
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i sumVector = zero;
+  __m256i squaresVector = zero;
+
+  size_t i = 0;
+  while(i + width <= length)
+  {
+    __m256i squares32 = zero;
+    for(size_t iteration = 0; iteration < ByteBlockIterations && i + width <= length; ++iteration, i += width)
+    {
+      const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+      sumVector = _mm256_add_epi64(sumVector, _mm256_sad_epu8(values, zero));
+      if(TSquares)
+      {
+        const __m256i low = _mm256_unpacklo_epi8(values, zero);
+        const __m256i high = _mm256_unpackhi_epi8(values, zero);
+        squares32 = _mm256_add_epi32(squares32, _mm256_madd_epi16(low, low));
+        squares32 = _mm256_add_epi32(squares32, _mm256_madd_epi16(high, high));
+      }
+    }
+    squaresVector = _mm256_add_epi64(squaresVector, _mm256_unpacklo_epi32(squares32, zero));
+    squaresVector = _mm256_add_epi64(squaresVector, _mm256_unpackhi_epi32(squares32, zero));
+  }
+
+  uint64_t sumLanes[4];
+  uint64_t squaresLanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(sumLanes), sumVector);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(squaresLanes), squaresVector);
+  sum += sumLanes[0] + sumLanes[1] + sumLanes[2] + sumLanes[3];
+  sumOfSquares += squaresLanes[0] + squaresLanes[1] + squaresLanes[2] + squaresLanes[3];
+
+  GenericByteSums<TSquares>(data + i, length - i, sum, sumOfSquares);
+}
+
+template <bool TSquares>
+KERNEL_TARGET("avx512f,avx512bw") void AVX512ByteSums(const unsigned char* data, const size_t length,
+                                                      uint64_t& sum, uint64_t& sumOfSquares)
+{
+  const size_t width = 64;
+  const __m512i zero = _mm512_setzero_si512();
+  __m512i sumVector = zero;
+
+  size_t i = 0;
+  while(i + width <= length)
+  {
+    __m512i squares32 = zero;
+    for(size_t iteration = 0; iteration < ByteBlockIterations && i + width <= length; ++iteration, i += width)
+    {
+      const __m512i values = _mm512_loadu_si512(reinterpret_cast<const void*>(data + i));
+      sumVector = _mm512_add_epi64(sumVector, _mm512_sad_epu8(values, zero));
+      if(TSquares)
+      {
+        const __m512i low = _mm512_unpacklo_epi8(values, zero);
+        const __m512i high = _mm512_unpackhi_epi8(values, zero);
+        squares32 = _mm512_add_epi32(squares32, _mm512_madd_epi16(low, low));
+        squares32 = _mm512_add_epi32(squares32, _mm512_madd_epi16(high, high));
+      }
+    }
+    uint32_t squaresLanes[16];
+    _mm512_storeu_si512(reinterpret_cast<void*>(squaresLanes), squares32);
+    for(unsigned int lane = 0; lane < 16; ++lane)
+    {
+      sumOfSquares += squaresLanes[lane];
+    }
+  }
+
+  uint64_t sumLanes[8];
+  _mm512_storeu_si512(reinterpret_cast<void*>(sumLanes), sumVector);
+  for(unsigned int lane = 0; lane < 8; ++lane)
+  {
+    sum += sumLanes[lane];
+  }
+
+  GenericByteSums<TSquares>(data + i, length - i, sum, sumOfSquares);
+}
+
+#endif
+
+/** Call the kernel for the active instruction set. */
+template <bool TSquares, typename T>
+ShiftedSums ComputeShiftedSums(const T* data, const size_t length, const double shift)
+{
+#ifdef STATISTICS_KERNELS_X86
+  switch(GetKernelInstructionSet())
+  {
+    case AVX512_INSTRUCTIONS:
+      return AVX512ShiftedSums<TSquares>(data, length, shift);
+    case AVX2_INSTRUCTIONS:
+      return AVX2ShiftedSums<TSquares>(data, length, shift);
+    case SSE2_INSTRUCTIONS:
+      return SSE2ShiftedSums<TSquares>(data, length, shift);
+    default:
+      break;
+  }
+#endif
+  return GenericShiftedSums<TSquares>(data, length, shift);
+}
+
+template <bool TSquares>
+ShiftedSums ComputeShiftedSums(const unsigned char* data, const size_t length, const double shift)
+{
+  uint64_t sum = 0;
+  uint64_t sumOfSquares = 0;
+
+#ifdef STATISTICS_KERNELS_X86
+  switch(GetKernelInstructionSet())
+  {
+    case AVX512_INSTRUCTIONS:
+      AVX512ByteSums<TSquares>(data, length, sum, sumOfSquares);
+      break;
+    case AVX2_INSTRUCTIONS:
+      AVX2ByteSums<TSquares>(data, length, sum, sumOfSquares);
+      break;
+    case SSE2_INSTRUCTIONS:
+      SSE2ByteSums<TSquares>(data, length, sum, sumOfSquares);
+      break;
+    default:
+      GenericByteSums<TSquares>(data, length, sum, sumOfSquares);
+      break;
+  }
+#else
+  GenericByteSums<TSquares>(data, length, sum, sumOfSquares);
+#endif
+
+  // The integer sums are exact, so shifting them afterwards does not lose anything
+  // (every term is an integer smaller than 2^53 for any realistic length).
+  const double count = static_cast<double>(length);
+  const double exactSum = static_cast<double>(sum);
+  ShiftedSums sums;
+  sums.Sum = exactSum - shift * count;
+  sums.SumOfSquares = static_cast<double>(sumOfSquares) - 2.0 * shift * exactSum + shift * shift * count;
+  return sums;
+}
+
+template <typename T>
+void ComputeMeanAndVariance(const T* data, const size_t length, double& mean, double& variance)
+{
+  if(length == 0)
+  {
+    throw std::runtime_error("Must have more than 0 items to compute a variance!");
+  }
+
+  const double shift = static_cast<double>(data[0]);
+  const ShiftedSums sums = ComputeShiftedSums<true>(data, length, shift);
+  const double count = static_cast<double>(length);
+
+  mean = shift + sums.Sum / count;
+
+  // This (N-1) term in the denominator is for the "unbiased" sample variance.
+  variance = (sums.SumOfSquares - sums.Sum * sums.Sum / count) / (count - 1.0);
+}
+
+} // end anonymous namespace
+
+KernelInstructionSet GetSupportedKernelInstructionSet()
+{
+  static const KernelInstructionSet supportedInstructionSet = DetectKernelInstructionSet();
+  return supportedInstructionSet;
+}
+
+KernelInstructionSet GetKernelInstructionSet()
+{
+  return static_cast<KernelInstructionSet>(ActiveKernelInstructionSet().load());
+}
+
+void SetKernelInstructionSet(const KernelInstructionSet instructionSet)
+{
+  ActiveKernelInstructionSet() = std::min(instructionSet, GetSupportedKernelInstructionSet());
+}
+
+std::string GetKernelInstructionSetName(const KernelInstructionSet instructionSet)
+{
+  switch(instructionSet)
+  {
+    case AVX512_INSTRUCTIONS:
+      return "AVX-512";
+    case AVX2_INSTRUCTIONS:
+      return "AVX2";
+    case SSE2_INSTRUCTIONS:
+      return "SSE2";
+    default:
+      return "Generic";
+  }
+}
+
+double Sum(const float* data, const size_t length)
+{
+  return ComputeShiftedSums<false>(data, length, 0.0).Sum;
+}
+
+double Sum(const double* data, const size_t length)
+{
+  return ComputeShiftedSums<false>(data, length, 0.0).Sum;
+}
+
+double Sum(const unsigned char* data, const size_t length)
+{
+  return ComputeShiftedSums<false>(data, length, 0.0).Sum;
+}
+
+double Sum(const unsigned short* data, const size_t length)
+{
+  return ComputeShiftedSums<false>(data, length, 0.0).Sum;
+}
+
+double Sum(const int* data, const size_t length)
+{
+  return ComputeShiftedSums<false>(data, length, 0.0).Sum;
+}
+
+double SumOfSquares(const float* data, const size_t length)
+{
+  return ComputeShiftedSums<true>(data, length, 0.0).SumOfSquares;
+}
+
+double SumOfSquares(const double* data, const size_t length)
+{
+  return ComputeShiftedSums<true>(data, length, 0.0).SumOfSquares;
+}
+
+double SumOfSquares(const unsigned char* data, const size_t length)
+{
+  return ComputeShiftedSums<true>(data, length, 0.0).SumOfSquares;
+}
+
+double SumOfSquares(const unsigned short* data, const size_t length)
+{
+  return ComputeShiftedSums<true>(data, length, 0.0).SumOfSquares;
+}
+
+double SumOfSquares(const int* data, const size_t length)
+{
+  return ComputeShiftedSums<true>(data, length, 0.0).SumOfSquares;
+}
+
+void MeanAndVariance(const float* data, const size_t length, double& mean, double& variance)
+{
+  ComputeMeanAndVariance(data, length, mean, variance);
+}
+
+void MeanAndVariance(const double* data, const size_t length, double& mean, double& variance)
+{
+  ComputeMeanAndVariance(data, length, mean, variance);
+}
+
+void MeanAndVariance(const unsigned char* data, const size_t length, double& mean, double& variance)
+{
+  ComputeMeanAndVariance(data, length, mean, variance);
+}
+
+void MeanAndVariance(const unsigned short* data, const size_t length, double& mean, double& variance)
+{
+  ComputeMeanAndVariance(data, length, mean, variance);
+}
+
+void MeanAndVariance(const int* data, const size_t length, double& mean, double& variance)
+{
+  ComputeMeanAndVariance(data, length, mean, variance);
+}
+
+} // end namespace
@@ -0,0 +1,102 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef StatisticsKernels_H
+#define StatisticsKernels_H
+
+// STL
+#include <cstddef> // for size_t
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/** These are vectorized (SSE2/AVX2/AVX-512) kernels for the reductions behind Statistics::Average and
+  * Statistics::Variance on contiguous buffers of float, double, unsigned char, unsigned short and int.
+  * The widest instruction set that the CPU supports is chosen the first time a kernel is called.
+  * On compilers/architectures where the intrinsics are not available, a scalar version is used.
+  * All of the kernels accumulate in double precision (unsigned char is accumulated exactly in integers).
+  */
+namespace Statistics
+{
+
+/** The instruction sets that the kernels can use, from narrowest to widest. */
+enum KernelInstructionSet
+{
+  GENERIC_INSTRUCTIONS,
+  SSE2_INSTRUCTIONS,
+  AVX2_INSTRUCTIONS,
+  AVX512_INSTRUCTIONS
+};
+
+/** Get the widest instruction set that this CPU (and this build) supports. */
+KernelInstructionSet GetSupportedKernelInstructionSet();
+
+/** Get the instruction set that the kernels currently use. */
+KernelInstructionSet GetKernelInstructionSet();
+
+/** Limit the kernels to 'instructionSet' (e.g. for testing or benchmarking). Requests for an instruction set
+  * that is not supported use the widest supported one instead. */
+void SetKernelInstructionSet(const KernelInstructionSet instructionSet);
+
+/** Get a name for an instruction set, e.g. "AVX2". */
+std::string GetKernelInstructionSetName(const KernelInstructionSet instructionSet);
+
+/** Sum the elements of a buffer. */
+double Sum(const float* data, const size_t length);
+double Sum(const double* data, const size_t length);
+double Sum(const unsigned char* data, const size_t length);
+double Sum(const unsigned short* data, const size_t length);
+double Sum(const int* data, const size_t length);
+
+/** Sum the squares of the elements of a buffer. */
+double SumOfSquares(const float* data, const size_t length);
+double SumOfSquares(const double* data, const size_t length);
+double SumOfSquares(const unsigned char* data, const size_t length);
+double SumOfSquares(const unsigned short* data, const size_t length);
+double SumOfSquares(const int* data, const size_t length);
+
+/** Compute the mean and the unbiased (N-1) variance of a buffer in a single pass. */
+void MeanAndVariance(const float* data, const size_t length, double& mean, double& variance);
+void MeanAndVariance(const double* data, const size_t length, double& mean, double& variance);
+void MeanAndVariance(const unsigned char* data, const size_t length, double& mean, double& variance);
+void MeanAndVariance(const unsigned short* data, const size_t length, double& mean, double& variance);
+void MeanAndVariance(const int* data, const size_t length, double& mean, double& variance);
+
+/** Determine if a container type has contiguous storage with a kernel above. Statistics::Average and
+  * Statistics::Variance use the kernels for these types. */
+template <typename TVector>
+struct HasStatisticsKernel : std::false_type {};
+
+template <>
+struct HasStatisticsKernel<std::vector<float> > : std::true_type {};
+
+template <>
+struct HasStatisticsKernel<std::vector<double> > : std::true_type {};
+
+template <>
+struct HasStatisticsKernel<std::vector<unsigned char> > : std::true_type {};
+
+template <>
+struct HasStatisticsKernel<std::vector<unsigned short> > : std::true_type {};
+
+template <>
+struct HasStatisticsKernel<std::vector<int> > : std::true_type {};
+
+} // end namespace
+
+#endif
@@ -0,0 +1,341 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef StridedView_H
+#define StridedView_H
+
+// STL
+#include <cstddef> // for size_t, ptrdiff_t
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+// Custom
+#include "ContainerInterface.h"
+#include "TypeTraits.h"
+
+/** These classes let the Statistics and Helpers templates run directly on data that lives in someone
+  * else's buffer (an interleaved RGB image, the planes of a planar image, a rectangular region of either,
+  * every other sample of a signal, ...) without copying it into a std::vector first.
+  * None of them own their data: the buffer must outlive the view, and writing through a view (or running
+  * something like VectorMedian that reorders its input) modifies the buffer.
+  */
+
+namespace Helpers
+{
+
+/** A random access iterator over any of the views below. Dereferencing returns whatever the view's
+  * operator[] returns (a reference for StridedView, a PixelView proxy for StridedPixelView). */
+template <typename TView>
+class StridedViewIterator
+{
+public:
+  typedef std::random_access_iterator_tag iterator_category;
+  typedef typename TView::value_type value_type;
+  typedef typename TView::reference reference;
+  typedef typename TView::pointer pointer;
+  typedef std::ptrdiff_t difference_type;
+
+  StridedViewIterator() : View(nullptr), Index(0) {}
+
+  StridedViewIterator(const TView* const view, const size_t index) : View(view), Index(index) {}
+
+  reference operator*() const { return (*this->View)[this->Index]; }
+
+  reference operator[](const difference_type offset) const { return (*this->View)[this->Index + offset]; }
+
+  StridedViewIterator& operator++() { ++this->Index; return *this; }
+  StridedViewIterator operator++(int) { StridedViewIterator old = *this; ++this->Index; return old; }
+  StridedViewIterator& operator--() { --this->Index; return *this; }
+  StridedViewIterator operator--(int) { StridedViewIterator old = *this; --this->Index; return old; }
+
+  StridedViewIterator& operator+=(const difference_type offset) { this->Index += offset; return *this; }
+  StridedViewIterator& operator-=(const difference_type offset) { this->Index -= offset; return *this; }
+
+  StridedViewIterator operator+(const difference_type offset) const
+  { return StridedViewIterator(this->View, this->Index + offset); }
+  StridedViewIterator operator-(const difference_type offset) const
+  { return StridedViewIterator(this->View, this->Index - offset); }
+
+  difference_type operator-(const StridedViewIterator& other) const
+  { return static_cast<difference_type>(this->Index) - static_cast<difference_type>(other.Index); }
+
+  bool operator==(const StridedViewIterator& other) const { return this->Index == other.Index; }
+  bool operator!=(const StridedViewIterator& other) const { return this->Index != other.Index; }
+  bool operator<(const StridedViewIterator& other) const { return this->Index < other.Index; }
+  bool operator>(const StridedViewIterator& other) const { return this->Index > other.Index; }
+  bool operator<=(const StridedViewIterator& other) const { return this->Index <= other.Index; }
+  bool operator>=(const StridedViewIterator& other) const { return this->Index >= other.Index; }
+
+private:
+  const TView* View;
+  size_t Index;
+};
+
+template <typename TView>
+StridedViewIterator<TView> operator+(const typename StridedViewIterator<TView>::difference_type offset,
+                                     const StridedViewIterator<TView>& iterator)
+{
+  return iterator + offset;
+}
+
+/** A view of scalar elements. Element i of a one row view is data[i * stride]. A view can also have
+  * several rows (e.g. a rectangular region of an image): element i is then in row i / rowLength, and
+  * the start of each row is 'rowStride' elements after the start of the previous one.
+  * Strides are in elements (not bytes) and may be negative.
+  * The view models enough of std::vector (value_type, size(), operator[], begin()/end()) for the
+  * container templates in this library to accept it.
+  */
+template <typename T>
+class StridedView
+{
+public:
+  typedef typename std::remove_const<T>::type value_type;
+  typedef T& reference;
+  typedef T* pointer;
+  typedef size_t size_type;
+  typedef StridedViewIterator<StridedView<T> > iterator;
+  typedef iterator const_iterator;
+
+  /** An empty view. */
+  StridedView();
+
+  /** A single row of 'length' elements, 'stride' elements apart. */
+  StridedView(T* const data, const size_t length, const std::ptrdiff_t stride = 1);
+
+  /** 'numberOfRows' rows of 'rowLength' elements each. */
+  StridedView(T* const data, const size_t rowLength, const size_t numberOfRows,
+              const std::ptrdiff_t stride, const std::ptrdiff_t rowStride);
+
+  /** Access element 'i'. This is const because it does not change the view (only, possibly, the data). */
+  reference operator[](const size_t i) const
+  {
+    return this->Data[this->GetOffset(i)];
+  }
+
+  /** The offset of element 'i' from the start of the buffer, in elements. */
+  std::ptrdiff_t GetOffset(const size_t i) const
+  {
+    if(this->NumberOfRows == 1)
+    {
+      return static_cast<std::ptrdiff_t>(i) * this->Stride;
+    }
+
+    const size_t row = i / this->RowLength;
+    const size_t column = i - row * this->RowLength;
+    return static_cast<std::ptrdiff_t>(row) * this->RowStride + static_cast<std::ptrdiff_t>(column) * this->Stride;
+  }
+
+  size_t size() const;
+
+  bool empty() const;
+
+  iterator begin() const;
+
+  iterator end() const;
+
+  T* GetData() const;
+
+  std::ptrdiff_t GetStride() const;
+
+  size_t GetRowLength() const;
+
+  size_t GetNumberOfRows() const;
+
+  std::ptrdiff_t GetRowStride() const;
+
+  /** Determine if the elements are adjacent in memory (so data() style access is possible). */
+  bool IsContiguous() const;
+
+private:
+  T* Data;
+  size_t RowLength;
+  size_t NumberOfRows;
+  std::ptrdiff_t Stride;
+  std::ptrdiff_t RowStride;
+};
+
+/** One multi-channel element (e.g. a pixel) of a StridedPixelView. Channel c is data[c * channelStride],
+  * so this is 1 for interleaved data and the size of a plane for planar data.
+  * It converts to a std::vector of any component type, which is how the Statistics functions create
+  * their (multi-component) outputs from an element of the input.
+  */
+template <typename T>
+class PixelView
+{
+public:
+  typedef typename std::remove_const<T>::type value_type;
+  typedef T& reference;
+  typedef T* pointer;
+  typedef size_t size_type;
+
+  PixelView(T* const data, const unsigned int numberOfChannels, const std::ptrdiff_t channelStride = 1)
+    : Data(data), NumberOfChannels(numberOfChannels), ChannelStride(channelStride) {}
+
+  reference operator[](const size_t channel) const
+  {
+    return this->Data[static_cast<std::ptrdiff_t>(channel) * this->ChannelStride];
+  }
+
+  size_t size() const
+  {
+    return this->NumberOfChannels;
+  }
+
+  /** Copy the channels into a std::vector. */
+  template <typename TOutput>
+  operator std::vector<TOutput>() const;
+
+  T* GetData() const;
+
+  std::ptrdiff_t GetChannelStride() const;
+
+private:
+  T* Data;
+  unsigned int NumberOfChannels;
+  std::ptrdiff_t ChannelStride;
+};
+
+/** A view of multi-channel elements: element i is the PixelView whose first channel is element i of
+  * 'firstChannel' and whose other channels follow 'channelStride' elements apart. Each channel on its
+  * own is a StridedView (see GetChannel()).
+  */
+template <typename T>
+class StridedPixelView
+{
+public:
+  typedef PixelView<T> value_type;
+  typedef PixelView<T> reference;
+  typedef void pointer;
+  typedef size_t size_type;
+  typedef StridedViewIterator<StridedPixelView<T> > iterator;
+  typedef iterator const_iterator;
+
+  /** An empty view. */
+  StridedPixelView();
+
+  StridedPixelView(const StridedView<T>& firstChannel, const unsigned int numberOfChannels,
+                   const std::ptrdiff_t channelStride);
+
+  reference operator[](const size_t i) const
+  {
+    return PixelView<T>(&this->FirstChannel[i], this->NumberOfChannels, this->ChannelStride);
+  }
+
+  size_t size() const;
+
+  bool empty() const;
+
+  iterator begin() const;
+
+  iterator end() const;
+
+  unsigned int GetNumberOfChannels() const;
+
+  std::ptrdiff_t GetChannelStride() const;
+
+  /** Get a view of only channel 'channel' of every element. */
+  StridedView<T> GetChannel(const unsigned int channel) const;
+
+private:
+  StridedView<T> FirstChannel;
+  unsigned int NumberOfChannels;
+  std::ptrdiff_t ChannelStride;
+};
+
+/** View 'length' elements of 'data', 'stride' elements apart. */
+template <typename T>
+StridedView<T> MakeStridedView(T* const data, const size_t length, const std::ptrdiff_t stride = 1);
+
+/** View channel 'channel' of 'numberOfPixels' interleaved pixels (e.g. the G of RGBRGBRGB...). */
+template <typename T>
+StridedView<T> MakeChannelView(T* const data, const size_t numberOfPixels, const unsigned int numberOfChannels,
+                               const unsigned int channel);
+
+/** View the 'width' x 'height' region whose top left corner is ('x', 'y') of a single channel image
+  * with rows 'imageWidth' elements long. */
+template <typename T>
+StridedView<T> MakeRegionView(T* const data, const size_t imageWidth,
+                              const size_t x, const size_t y, const size_t width, const size_t height);
+
+/** View 'numberOfPixels' interleaved pixels (RGBRGBRGB...). */
+template <typename T>
+StridedPixelView<T> MakeInterleavedView(T* const data, const size_t numberOfPixels,
+                                        const unsigned int numberOfChannels);
+
+/** View 'numberOfPixels' planar pixels (RRR...GGG...BBB...). */
+template <typename T>
+StridedPixelView<T> MakePlanarView(T* const data, const size_t numberOfPixels,
+                                   const unsigned int numberOfChannels);
+
+/** View a region (as in MakeRegionView) of an interleaved image. */
+template <typename T>
+StridedPixelView<T> MakeInterleavedRegionView(T* const data, const size_t imageWidth,
+                                              const unsigned int numberOfChannels,
+                                              const size_t x, const size_t y,
+                                              const size_t width, const size_t height);
+
+/** View a region (as in MakeRegionView) of a planar image, whose planes are 'imageWidth' x 'imageHeight'. */
+template <typename T>
+StridedPixelView<T> MakePlanarRegionView(T* const data, const size_t imageWidth, const size_t imageHeight,
+                                         const unsigned int numberOfChannels,
+                                         const size_t x, const size_t y,
+                                         const size_t width, const size_t height);
+
+} // end namespace
+
+/** A view of scalars behaves like a std::vector of them. */
+template <typename T>
+struct TypeTraits<Helpers::StridedView<T> >
+{
+  typedef typename std::remove_const<T>::type ValueType;
+
+  typedef std::vector<ValueType> LargerType;
+  typedef typename TypeTraits<ValueType>::LargerType LargerComponentType;
+  typedef ValueType ComponentType;
+  typedef std::vector<typename TypeTraits<ValueType>::SumType> SumType;
+};
+
+/** A single multi-channel element. Unlike std::vector<T>, LargerType also widens the components, so that
+  * the average or variance of unsigned char pixels is not truncated. */
+template <typename T>
+struct TypeTraits<Helpers::PixelView<T> >
+{
+  typedef typename std::remove_const<T>::type ValueType;
+
+  typedef std::vector<typename TypeTraits<ValueType>::LargerType> LargerType;
+  typedef typename TypeTraits<ValueType>::LargerType LargerComponentType;
+  typedef ValueType ComponentType;
+  typedef std::vector<typename TypeTraits<ValueType>::SumType> SumType;
+};
+
+/** A view of multi-channel elements behaves like a std::vector of std::vectors. */
+template <typename T>
+struct TypeTraits<Helpers::StridedPixelView<T> >
+{
+  typedef typename std::remove_const<T>::type ValueType;
+
+  typedef std::vector<std::vector<ValueType> > LargerType;
+  typedef typename TypeTraits<Helpers::PixelView<T> >::LargerType LargerComponentType;
+  typedef Helpers::PixelView<T> ComponentType;
+  typedef std::vector<std::vector<typename TypeTraits<ValueType>::SumType> > SumType;
+};
+
+#include "StridedView.hpp"
+
+#endif
@@ -0,0 +1,305 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef StridedView_HPP
+#define StridedView_HPP
+
+#include "StridedView.h"
+
+// STL
+#include <stdexcept>
+
+namespace Helpers
+{
+
+// StridedView
+template <typename T>
+StridedView<T>::StridedView() : Data(nullptr), RowLength(0), NumberOfRows(1), Stride(1), RowStride(0)
+{
+}
+
+template <typename T>
+StridedView<T>::StridedView(T* const data, const size_t length, const std::ptrdiff_t stride) :
+  Data(data), RowLength(length), NumberOfRows(1), Stride(stride), RowStride(0)
+{
+}
+
+template <typename T>
+StridedView<T>::StridedView(T* const data, const size_t rowLength, const size_t numberOfRows,
+                            const std::ptrdiff_t stride, const std::ptrdiff_t rowStride) :
+  Data(data), RowLength(rowLength), NumberOfRows(numberOfRows), Stride(stride), RowStride(rowStride)
+{
+  if(this->RowLength == 0 || this->NumberOfRows == 0)
+  {
+    // Keep the single row invariant that GetOffset() relies on for empty views.
+    this->RowLength = 0;
+    this->NumberOfRows = 1;
+  }
+}
+
+template <typename T>
+size_t StridedView<T>::size() const
+{
+  return this->RowLength * this->NumberOfRows;
+}
+
+template <typename T>
+bool StridedView<T>::empty() const
+{
+  return this->size() == 0;
+}
+
+template <typename T>
+typename StridedView<T>::iterator StridedView<T>::begin() const
+{
+  return iterator(this, 0);
+}
+
+template <typename T>
+typename StridedView<T>::iterator StridedView<T>::end() const
+{
+  return iterator(this, this->size());
+}
+
+template <typename T>
+T* StridedView<T>::GetData() const
+{
+  return this->Data;
+}
+
+template <typename T>
+std::ptrdiff_t StridedView<T>::GetStride() const
+{
+  return this->Stride;
+}
+
+template <typename T>
+size_t StridedView<T>::GetRowLength() const
+{
+  return this->RowLength;
+}
+
+template <typename T>
+size_t StridedView<T>::GetNumberOfRows() const
+{
+  return this->NumberOfRows;
+}
+
+template <typename T>
+std::ptrdiff_t StridedView<T>::GetRowStride() const
+{
+  return this->RowStride;
+}
+
+template <typename T>
+bool StridedView<T>::IsContiguous() const
+{
+  return this->Stride == 1 &&
+         (this->NumberOfRows == 1 || this->RowStride == static_cast<std::ptrdiff_t>(this->RowLength));
+}
+
+// PixelView
+template <typename T>
+template <typename TOutput>
+PixelView<T>::operator std::vector<TOutput>() const
+{
+  std::vector<TOutput> output(this->NumberOfChannels);
+  for(unsigned int channel = 0; channel < this->NumberOfChannels; ++channel)
+  {
+    output[channel] = static_cast<TOutput>((*this)[channel]);
+  }
+  return output;
+}
+
+template <typename T>
+T* PixelView<T>::GetData() const
+{
+  return this->Data;
+}
+
+template <typename T>
+std::ptrdiff_t PixelView<T>::GetChannelStride() const
+{
+  return this->ChannelStride;
+}
+
+// StridedPixelView
+template <typename T>
+StridedPixelView<T>::StridedPixelView() : NumberOfChannels(0), ChannelStride(1)
+{
+}
+
+template <typename T>
+StridedPixelView<T>::StridedPixelView(const StridedView<T>& firstChannel, const unsigned int numberOfChannels,
+                                      const std::ptrdiff_t channelStride) :
+  FirstChannel(firstChannel), NumberOfChannels(numberOfChannels), ChannelStride(channelStride)
+{
+  if(numberOfChannels == 0)
+  {
+    throw std::runtime_error("StridedPixelView: the elements must have at least one channel!");
+  }
+}
+
+template <typename T>
+size_t StridedPixelView<T>::size() const
+{
+  return this->FirstChannel.size();
+}
+
+template <typename T>
+bool StridedPixelView<T>::empty() const
+{
+  return this->FirstChannel.empty();
+}
+
+template <typename T>
+typename StridedPixelView<T>::iterator StridedPixelView<T>::begin() const
+{
+  return iterator(this, 0);
+}
+
+template <typename T>
+typename StridedPixelView<T>::iterator StridedPixelView<T>::end() const
+{
+  return iterator(this, this->size());
+}
+
+template <typename T>
+unsigned int StridedPixelView<T>::GetNumberOfChannels() const
+{
+  return this->NumberOfChannels;
+}
+
+template <typename T>
+std::ptrdiff_t StridedPixelView<T>::GetChannelStride() const
+{
+  return this->ChannelStride;
+}
+
+template <typename T>
+StridedView<T> StridedPixelView<T>::GetChannel(const unsigned int channel) const
+{
+  if(channel >= this->NumberOfChannels)
+  {
+    throw std::runtime_error("StridedPixelView::GetChannel: channel is out of range!");
+  }
+
+  return StridedView<T>(this->FirstChannel.GetData() + static_cast<std::ptrdiff_t>(channel) * this->ChannelStride,
+                        this->FirstChannel.GetRowLength(), this->FirstChannel.GetNumberOfRows(),
+                        this->FirstChannel.GetStride(), this->FirstChannel.GetRowStride());
+}
+
+// Length functions
+template<typename T>
+unsigned int length(const StridedView<T>& v)
+{
+  return v.size();
+}
+
+template<typename T>
+unsigned int length(const PixelView<T>& v)
+{
+  return v.size();
+}
+
+template<typename T>
+unsigned int length(const StridedPixelView<T>& v)
+{
+  return v.size();
+}
+
+// Factories
+template <typename T>
+StridedView<T> MakeStridedView(T* const data, const size_t length, const std::ptrdiff_t stride)
+{
+  return StridedView<T>(data, length, stride);
+}
+
+template <typename T>
+StridedView<T> MakeChannelView(T* const data, const size_t numberOfPixels, const unsigned int numberOfChannels,
+                               const unsigned int channel)
+{
+  if(channel >= numberOfChannels)
+  {
+    throw std::runtime_error("MakeChannelView: channel must be less than numberOfChannels!");
+  }
+
+  return StridedView<T>(data + channel, numberOfPixels, numberOfChannels);
+}
+
+template <typename T>
+StridedView<T> MakeRegionView(T* const data, const size_t imageWidth,
+                              const size_t x, const size_t y, const size_t width, const size_t height)
+{
+  if(x + width > imageWidth)
+  {
+    throw std::runtime_error("MakeRegionView: the region extends past the right side of the image!");
+  }
+
+  return StridedView<T>(data + y * imageWidth + x, width, height, 1, imageWidth);
+}
+
+template <typename T>
+StridedPixelView<T> MakeInterleavedView(T* const data, const size_t numberOfPixels,
+                                        const unsigned int numberOfChannels)
+{
+  return StridedPixelView<T>(StridedView<T>(data, numberOfPixels, numberOfChannels), numberOfChannels, 1);
+}
+
+template <typename T>
+StridedPixelView<T> MakePlanarView(T* const data, const size_t numberOfPixels,
+                                   const unsigned int numberOfChannels)
+{
+  return StridedPixelView<T>(StridedView<T>(data, numberOfPixels, 1), numberOfChannels, numberOfPixels);
+}
+
+template <typename T>
+StridedPixelView<T> MakeInterleavedRegionView(T* const data, const size_t imageWidth,
+                                              const unsigned int numberOfChannels,
+                                              const size_t x, const size_t y,
+                                              const size_t width, const size_t height)
+{
+  if(x + width > imageWidth)
+  {
+    throw std::runtime_error("MakeInterleavedRegionView: the region extends past the right side of the image!");
+  }
+
+  const size_t rowStride = imageWidth * numberOfChannels;
+  StridedView<T> firstChannel(data + y * rowStride + x * numberOfChannels, width, height,
+                              numberOfChannels, rowStride);
+  return StridedPixelView<T>(firstChannel, numberOfChannels, 1);
+}
+
+template <typename T>
+StridedPixelView<T> MakePlanarRegionView(T* const data, const size_t imageWidth, const size_t imageHeight,
+                                         const unsigned int numberOfChannels,
+                                         const size_t x, const size_t y,
+                                         const size_t width, const size_t height)
+{
+  if(x + width > imageWidth || y + height > imageHeight)
+  {
+    throw std::runtime_error("MakePlanarRegionView: the region extends past the edge of the image!");
+  }
+
+  StridedView<T> firstChannel(data + y * imageWidth + x, width, height, 1, imageWidth);
+  return StridedPixelView<T>(firstChannel, numberOfChannels, imageWidth * imageHeight);
+}
+
+} // end namespace
+
+#endif
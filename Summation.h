@@ -0,0 +1,176 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef Summation_H
+#define Summation_H
+
+// STL
+#include <cstddef> // for size_t
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace Helpers
+{
+
+/** The ways AccumulateSum can add up a range of values. Both only matter for floating point
+  * accumulators; integer accumulators are always summed exactly (modulo overflow of the accumulator).
+  * Neither works if the code is compiled with -ffast-math (or anything else that lets the compiler
+  * reassociate floating point additions), as that can optimize the compensation away. */
+enum SummationMethod
+{
+  /** Sum blocks of SummationBlockSize values, each with SummationLanes independent accumulators (which
+    * the compiler can keep in SIMD registers), and add the block sums pairwise. The error grows as
+    * O(log N) rather than the O(N) of a single running sum, at about the speed of a plain loop. */
+  SUMMATION_PAIRWISE,
+
+  /** Neumaier's variant of Kahan summation: each accumulator carries the rounding error of its additions
+    * in a compensation term. The error does not grow with N, but this is a few times slower than
+    * SUMMATION_PAIRWISE. */
+  SUMMATION_COMPENSATED
+};
+
+/** The number of values that are summed directly before the block sums are combined pairwise. */
+const size_t SummationBlockSize = 128;
+
+/** The number of independent accumulators used within a block. */
+const unsigned int SummationLanes = 8;
+
+/** The number of values of 16 bits or fewer whose sum fits in 32 bits, so SumOfIntegers can add blocks
+  * of this many in 32 bit lanes (which vectorize twice as wide as 64 bit ones). */
+const size_t IntegerSummationBlockSize = 65536;
+
+/** The type in which SumOfIntegers sums a block of TValue's that will be added to a TAccumulator. */
+template <typename TValue, typename TAccumulator>
+struct BlockSumType
+{
+  typedef typename std::conditional<std::is_integral<TValue>::value && sizeof(TValue) <= 2 &&
+                                    std::is_integral<TAccumulator>::value && (sizeof(TAccumulator) > 4),
+                                    typename std::conditional<std::is_signed<TValue>::value,
+                                                              std::int32_t, std::uint32_t>::type,
+                                    TAccumulator>::type Type;
+};
+
+/** Sum the values in [first, last) in a TAccumulator (e.g. AccumulateSum<double>(floats.begin(), floats.end())).
+  * Random access (including contiguous) iterators are read by index; other forward iterators are read
+  * sequentially. Either way each value is read exactly once. */
+template<typename TAccumulator, typename TIterator>
+TAccumulator AccumulateSum(const TIterator first, const TIterator last,
+                           const SummationMethod method = SUMMATION_PAIRWISE);
+
+/** Sum the values in [first, last) as above, using 'numberOfThreads' threads (0 means every core) for random
+  * access ranges of at least MinimumParallelLength values. The result is exactly that of the serial version
+  * for SUMMATION_PAIRWISE and for integers: each thread sums whole runs of 2^k blocks (complete subtrees of the
+  * pairwise tree), and those are combined in the same order as the serial version combines them.
+  * A SUMMATION_COMPENSATED sum can differ from the serial one in its last bit. */
+template<typename TAccumulator, typename TIterator>
+TAccumulator AccumulateSum(const TIterator first, const TIterator last, const SummationMethod method,
+                           const unsigned int numberOfThreads);
+
+/** This version of the threaded AccumulateSum is used for random access iterators. */
+template<typename TAccumulator, typename TIterator>
+TAccumulator ParallelAccumulateSum(const TIterator first, const size_t count, const SummationMethod method,
+                                   const unsigned int numberOfThreads, std::random_access_iterator_tag);
+
+/** This version of the threaded AccumulateSum is used for other iterators, and sums on the calling thread. */
+template<typename TAccumulator, typename TIterator>
+TAccumulator ParallelAccumulateSum(const TIterator first, const size_t count, const SummationMethod method,
+                                   const unsigned int numberOfThreads, std::forward_iterator_tag);
+
+/** Combine the sums of consecutive runs of 'chunkLength' values (the last one may be shorter) into the
+  * sum that AccumulateSum would have computed over all of them. For SUMMATION_PAIRWISE, 'chunkLength' must be
+  * SummationBlockSize times a power of 2. */
+template<typename TAccumulator>
+TAccumulator CombineChunkSums(const std::vector<TAccumulator>& chunkSums, const bool lastChunkIsPartial,
+                              const SummationMethod method);
+
+/** This version of AccumulateSum is used for floating point accumulators. */
+template<typename TAccumulator, typename TIterator>
+TAccumulator AccumulateSum(const TIterator first, const size_t count, const SummationMethod method,
+                           std::true_type);
+
+/** This version of AccumulateSum is used for all other (integer) accumulators, and ignores 'method'. */
+template<typename TAccumulator, typename TIterator>
+TAccumulator AccumulateSum(const TIterator first, const size_t count, const SummationMethod method,
+                           std::false_type);
+
+/** Sum 'count' values starting at 'iterator' with SummationLanes accumulators, and advance 'iterator' past them. */
+template<typename TAccumulator, typename TIterator>
+TAccumulator SumBlock(TIterator& iterator, const size_t count, std::random_access_iterator_tag);
+
+/** The same, for iterators that can only be incremented. */
+template<typename TAccumulator, typename TIterator>
+TAccumulator SumBlock(TIterator& iterator, const size_t count, std::forward_iterator_tag);
+
+/** Sum 'count' values with SUMMATION_PAIRWISE. */
+template<typename TAccumulator, typename TIterator>
+TAccumulator PairwiseSum(TIterator iterator, const size_t count);
+
+/** Sum 'count' values with SUMMATION_COMPENSATED. */
+template<typename TAccumulator, typename TIterator>
+TAccumulator CompensatedSum(TIterator iterator, const size_t count);
+
+/** Sum 'count' values into an integer accumulator, using BlockSumType for each block. */
+template<typename TAccumulator, typename TIterator>
+TAccumulator SumOfIntegers(TIterator iterator, const size_t count);
+
+/** Add 'value' to 'sum', accumulating the rounding error of the addition in 'compensation'. */
+template<typename T>
+void NeumaierAdd(T& sum, T& compensation, const T value);
+
+/** A random access iterator whose value at position i is function(i). It lets AccumulateSum sum values that
+  * are computed on the fly (e.g. |a[i] - b[i]|) without storing them. 'function' must outlive the iterator. */
+template <typename TFunction, typename TValue>
+class FunctionIterator
+{
+public:
+  typedef std::random_access_iterator_tag iterator_category;
+  typedef TValue value_type;
+  typedef TValue reference;
+  typedef void pointer;
+  typedef std::ptrdiff_t difference_type;
+
+  FunctionIterator(const TFunction* const function, const size_t index) : Function(function), Index(index) {}
+
+  TValue operator*() const { return (*this->Function)(this->Index); }
+
+  TValue operator[](const difference_type offset) const { return (*this->Function)(this->Index + offset); }
+
+  FunctionIterator& operator++() { ++this->Index; return *this; }
+  FunctionIterator& operator+=(const difference_type offset) { this->Index += offset; return *this; }
+
+  FunctionIterator operator+(const difference_type offset) const
+  { return FunctionIterator(this->Function, this->Index + offset); }
+
+  difference_type operator-(const FunctionIterator& other) const
+  { return static_cast<difference_type>(this->Index) - static_cast<difference_type>(other.Index); }
+
+  bool operator==(const FunctionIterator& other) const { return this->Index == other.Index; }
+  bool operator!=(const FunctionIterator& other) const { return this->Index != other.Index; }
+
+private:
+  const TFunction* Function;
+  size_t Index;
+};
+
+} // end namespace
+
+#include "Summation.hpp"
+
+#endif
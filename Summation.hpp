@@ -0,0 +1,332 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef Summation_HPP
+#define Summation_HPP
+
+#include "Summation.h"
+#include "Parallel.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+
+namespace Helpers
+{
+
+template<typename TAccumulator, typename TIterator>
+TAccumulator AccumulateSum(const TIterator first, const TIterator last, const SummationMethod method)
+{
+  const size_t count = std::distance(first, last);
+  return AccumulateSum<TAccumulator>(first, count, method, std::is_floating_point<TAccumulator>());
+}
+
+template<typename TAccumulator, typename TIterator>
+TAccumulator AccumulateSum(const TIterator first, const TIterator last, const SummationMethod method,
+                           const unsigned int numberOfThreads)
+{
+  typedef typename std::iterator_traits<TIterator>::iterator_category IteratorCategory;
+
+  const size_t count = std::distance(first, last);
+  const unsigned int numberOfBlocks = GetNumberOfThreads(numberOfThreads);
+  if(count < MinimumParallelLength || numberOfBlocks == 1)
+  {
+    return AccumulateSum<TAccumulator>(first, count, method, std::is_floating_point<TAccumulator>());
+  }
+
+  return ParallelAccumulateSum<TAccumulator>(first, count, method, numberOfBlocks, IteratorCategory());
+}
+
+template<typename TAccumulator, typename TIterator>
+TAccumulator ParallelAccumulateSum(const TIterator first, const size_t count, const SummationMethod method,
+                                   const unsigned int numberOfThreads, std::random_access_iterator_tag)
+{
+  // Split the values into chunks of SummationBlockSize * 2^k values, with k chosen to give each thread
+  // 4 to 8 chunks (so that uneven threads still finish together).
+  size_t chunkLength = SummationBlockSize;
+  while(chunkLength * 2 * 4 * numberOfThreads <= count)
+  {
+    chunkLength *= 2;
+  }
+
+  const size_t numberOfChunks = (count + chunkLength - 1) / chunkLength;
+  std::vector<TAccumulator> chunkSums(numberOfChunks);
+  ParallelForBlocks(numberOfChunks, std::min<size_t>(numberOfThreads, numberOfChunks),
+                    [&](const size_t blockBegin, const size_t blockEnd, const unsigned int)
+  {
+    for(size_t chunk = blockBegin; chunk < blockEnd; ++chunk)
+    {
+      const size_t chunkBegin = chunk * chunkLength;
+      chunkSums[chunk] = AccumulateSum<TAccumulator>(first + chunkBegin, std::min(chunkLength, count - chunkBegin),
+                                                     method, std::is_floating_point<TAccumulator>());
+    }
+  });
+
+  return CombineChunkSums(chunkSums, count % chunkLength != 0, method);
+}
+
+template<typename TAccumulator, typename TIterator>
+TAccumulator ParallelAccumulateSum(const TIterator first, const size_t count, const SummationMethod method,
+                                   const unsigned int, std::forward_iterator_tag)
+{
+  return AccumulateSum<TAccumulator>(first, count, method, std::is_floating_point<TAccumulator>());
+}
+
+template<typename TAccumulator>
+TAccumulator CombineChunkSums(const std::vector<TAccumulator>& chunkSums, const bool lastChunkIsPartial,
+                              const SummationMethod method)
+{
+  if(!std::is_floating_point<TAccumulator>::value)
+  {
+    TAccumulator total = 0;
+    for(size_t chunk = 0; chunk < chunkSums.size(); ++chunk)
+    {
+      total += chunkSums[chunk];
+    }
+    return total;
+  }
+
+  if(method == SUMMATION_COMPENSATED)
+  {
+    TAccumulator sum = 0;
+    TAccumulator compensation = 0;
+    for(size_t chunk = 0; chunk < chunkSums.size(); ++chunk)
+    {
+      NeumaierAdd(sum, compensation, chunkSums[chunk]);
+    }
+    return sum + compensation;
+  }
+
+  // Each full chunk is one node of the pairwise tree, so continue PairwiseSum's binary counter with them. The
+  // partial chunk's sum is what PairwiseSum adds up from the levels below a chunk before adding the higher ones.
+  const size_t numberOfFullChunks = chunkSums.size() - (lastChunkIsPartial ? 1 : 0);
+
+  TAccumulator levels[64];
+  for(size_t chunk = 0; chunk < numberOfFullChunks; ++chunk)
+  {
+    TAccumulator sum = chunkSums[chunk];
+    unsigned int level = 0;
+    for(size_t carry = chunk; carry & 1; carry >>= 1, ++level)
+    {
+      sum = levels[level] + sum;
+    }
+    levels[level] = sum;
+  }
+
+  TAccumulator total = lastChunkIsPartial ? chunkSums.back() : 0;
+  for(unsigned int level = 0; (numberOfFullChunks >> level) != 0; ++level)
+  {
+    if((numberOfFullChunks >> level) & 1)
+    {
+      total += levels[level];
+    }
+  }
+
+  return total;
+}
+
+template<typename TAccumulator, typename TIterator>
+TAccumulator AccumulateSum(const TIterator first, const size_t count, const SummationMethod method,
+                           std::true_type)
+{
+  if(method == SUMMATION_COMPENSATED)
+  {
+    return CompensatedSum<TAccumulator>(first, count);
+  }
+
+  return PairwiseSum<TAccumulator>(first, count);
+}
+
+template<typename TAccumulator, typename TIterator>
+TAccumulator AccumulateSum(const TIterator first, const size_t count, const SummationMethod,
+                           std::false_type)
+{
+  return SumOfIntegers<TAccumulator>(first, count);
+}
+
+template<typename TAccumulator, typename TIterator>
+TAccumulator SumBlock(TIterator& iterator, const size_t count, std::random_access_iterator_tag)
+{
+  TAccumulator lanes[SummationLanes] = {};
+
+  // The lanes are independent, so this loop has no serial dependency chain and can be vectorized.
+  const size_t vectorizedCount = count - count % SummationLanes;
+  for(size_t i = 0; i < vectorizedCount; i += SummationLanes)
+  {
+    for(unsigned int lane = 0; lane < SummationLanes; ++lane)
+    {
+      lanes[lane] += static_cast<TAccumulator>(iterator[i + lane]);
+    }
+  }
+
+  for(size_t i = vectorizedCount; i < count; ++i)
+  {
+    lanes[i - vectorizedCount] += static_cast<TAccumulator>(iterator[i]);
+  }
+
+  iterator += count;
+
+  // Combine the lanes pairwise too.
+  for(unsigned int width = SummationLanes / 2; width > 0; width /= 2)
+  {
+    for(unsigned int lane = 0; lane < width; ++lane)
+    {
+      lanes[lane] += lanes[lane + width];
+    }
+  }
+
+  return lanes[0];
+}
+
+template<typename TAccumulator, typename TIterator>
+TAccumulator SumBlock(TIterator& iterator, const size_t count, std::forward_iterator_tag)
+{
+  TAccumulator lanes[SummationLanes] = {};
+
+  for(size_t i = 0; i < count; ++i, ++iterator)
+  {
+    lanes[i % SummationLanes] += static_cast<TAccumulator>(*iterator);
+  }
+
+  for(unsigned int width = SummationLanes / 2; width > 0; width /= 2)
+  {
+    for(unsigned int lane = 0; lane < width; ++lane)
+    {
+      lanes[lane] += lanes[lane + width];
+    }
+  }
+
+  return lanes[0];
+}
+
+template<typename TAccumulator, typename TIterator>
+TAccumulator PairwiseSum(TIterator iterator, const size_t count)
+{
+  typedef typename std::iterator_traits<TIterator>::iterator_category IteratorCategory;
+
+  // Rather than recursing, combine the block sums like a binary counter: levels[level] holds the sum of
+  // 2^level blocks, and bit 'level' of numberOfBlocks says whether it is occupied. This gives the same
+  // pairwise tree as recursive halving, for any kind of iterator, with one pass and no extra memory.
+  TAccumulator levels[64];
+  size_t numberOfBlocks = 0;
+
+  for(size_t blockBegin = 0; blockBegin < count; blockBegin += SummationBlockSize)
+  {
+    TAccumulator sum = SumBlock<TAccumulator>(iterator, std::min(SummationBlockSize, count - blockBegin),
+                                              IteratorCategory());
+
+    unsigned int level = 0;
+    for(size_t carry = numberOfBlocks; carry & 1; carry >>= 1, ++level)
+    {
+      sum = levels[level] + sum;
+    }
+    levels[level] = sum;
+    ++numberOfBlocks;
+  }
+
+  // Add the partial sums that are left, smallest first.
+  TAccumulator total = 0;
+  for(unsigned int level = 0; (numberOfBlocks >> level) != 0; ++level)
+  {
+    if((numberOfBlocks >> level) & 1)
+    {
+      total += levels[level];
+    }
+  }
+
+  return total;
+}
+
+template<typename T>
+void NeumaierAdd(T& sum, T& compensation, const T value)
+{
+  const T newSum = sum + value;
+
+  // Whichever of 'sum' and 'value' is smaller lost its low order bits in the addition; recover them.
+  if(std::abs(sum) >= std::abs(value))
+  {
+    compensation += (sum - newSum) + value;
+  }
+  else
+  {
+    compensation += (value - newSum) + sum;
+  }
+
+  sum = newSum;
+}
+
+template<typename TAccumulator, typename TIterator>
+TAccumulator CompensatedSum(TIterator iterator, const size_t count)
+{
+  TAccumulator sums[SummationLanes] = {};
+  TAccumulator compensations[SummationLanes] = {};
+
+  // The compensation terms are themselves summed plainly, so when the rounding errors are systematic (e.g. when
+  // adding the same value many times) they grow until they lose precision of their own. Folding them back into
+  // the sums every few additions keeps each one no larger than the rounding error of its sum.
+  const size_t renormalizationInterval = 16 * SummationLanes;
+
+  for(size_t i = 0; i < count; ++i, ++iterator)
+  {
+    const unsigned int lane = i % SummationLanes;
+    NeumaierAdd(sums[lane], compensations[lane], static_cast<TAccumulator>(*iterator));
+
+    if(i % renormalizationInterval == renormalizationInterval - 1)
+    {
+      for(unsigned int renormalizedLane = 0; renormalizedLane < SummationLanes; ++renormalizedLane)
+      {
+        const TAccumulator compensation = compensations[renormalizedLane];
+        compensations[renormalizedLane] = 0;
+        NeumaierAdd(sums[renormalizedLane], compensations[renormalizedLane], compensation);
+      }
+    }
+  }
+
+  TAccumulator sum = 0;
+  TAccumulator compensation = 0;
+  for(unsigned int lane = 0; lane < SummationLanes; ++lane)
+  {
+    NeumaierAdd(sum, compensation, sums[lane]);
+    compensation += compensations[lane];
+  }
+
+  return sum + compensation;
+}
+
+template<typename TAccumulator, typename TIterator>
+TAccumulator SumOfIntegers(TIterator iterator, const size_t count)
+{
+  typedef typename std::iterator_traits<TIterator>::iterator_category IteratorCategory;
+  typedef typename std::iterator_traits<TIterator>::value_type ValueType;
+  typedef typename BlockSumType<ValueType, TAccumulator>::Type BlockAccumulator;
+
+  // Integer addition is associative, so the order does not matter; the blocks only keep the narrow
+  // block accumulators from overflowing.
+  TAccumulator total = 0;
+  for(size_t blockBegin = 0; blockBegin < count; blockBegin += IntegerSummationBlockSize)
+  {
+    total += SumBlock<BlockAccumulator>(iterator, std::min(IntegerSummationBlockSize, count - blockBegin),
+                                        IteratorCategory());
+  }
+
+  return total;
+}
+
+} // end namespace
+
+#endif
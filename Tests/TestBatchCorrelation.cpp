@@ -0,0 +1,119 @@
+#include "BatchCorrelation.h"
+#include "Statistics.h"
+
+// STL
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+static bool TestMatchesCorrelation();
+static bool TestMultiThreaded();
+static bool TestLengthMismatch();
+
+int main()
+{
+  bool allPass = true;
+
+  allPass &= TestMatchesCorrelation();
+  allPass &= TestMultiThreaded();
+  allPass &= TestLengthMismatch();
+
+  if(allPass)
+  {
+    return EXIT_SUCCESS;
+  }
+  else
+  {
+    return EXIT_FAILURE;
+  }
+}
+
+static std::vector<std::vector<float> > CreateHistograms(const unsigned int numberOfHistograms,
+                                                         const unsigned int numberOfBins)
+{
+  std::vector<std::vector<float> > histograms(numberOfHistograms, std::vector<float>(numberOfBins));
+  for(unsigned int histogramId = 0; histogramId < numberOfHistograms; ++histogramId)
+  {
+    for(unsigned int bin = 0; bin < numberOfBins; ++bin)
+    {
+      histograms[histogramId][bin] = static_cast<float>(rand() % 1000);
+    }
+  }
+  return histograms;
+}
+
+bool TestMatchesCorrelation()
+{
+  // 31 bins so that the unrolled loop also has a tail.
+  std::vector<std::vector<float> > candidates = CreateHistograms(50, 31);
+  std::vector<float> query = CreateHistograms(1, 31)[0];
+
+  Statistics::BatchCorrelation<std::vector<float> > batchCorrelation(candidates);
+  std::vector<float> correlations = batchCorrelation.Correlate(query, 1);
+
+  if(batchCorrelation.GetNumberOfCandidates() != candidates.size() || correlations.size() != candidates.size())
+  {
+    std::cerr << "TestMatchesCorrelation failed! Wrong number of candidates." << std::endl;
+    return false;
+  }
+
+  for(unsigned int candidateId = 0; candidateId < candidates.size(); ++candidateId)
+  {
+    const float correct = Statistics::Correlation(query, candidates[candidateId]);
+    if(fabs(correlations[candidateId] - correct) > 1e-5f ||
+       fabs(batchCorrelation.CorrelateCandidate(query, candidateId) - correct) > 1e-5f)
+    {
+      std::cerr << "TestMatchesCorrelation failed! Candidate " << candidateId << ": "
+                << correlations[candidateId] << " vs " << correct << std::endl;
+      return false;
+    }
+  }
+
+  // A candidate correlates perfectly with itself.
+  if(fabs(batchCorrelation.CorrelateCandidate(candidates[7], 7) - 1.0f) > 1e-6f)
+  {
+    std::cerr << "TestMatchesCorrelation failed! Self correlation is not 1." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestMultiThreaded()
+{
+  // Enough candidates * bins to pass Statistics::MinimumParallelLength.
+  std::vector<std::vector<float> > candidates = CreateHistograms(2000, 64);
+  std::vector<float> query = CreateHistograms(1, 64)[0];
+
+  Statistics::BatchCorrelation<std::vector<float> > batchCorrelation(candidates);
+  std::vector<float> serial = batchCorrelation.Correlate(query, 1);
+  std::vector<float> parallel = batchCorrelation.Correlate(query, 4);
+
+  if(serial != parallel)
+  {
+    std::cerr << "TestMultiThreaded failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestLengthMismatch()
+{
+  Statistics::BatchCorrelation<std::vector<float> > batchCorrelation;
+  batchCorrelation.AddCandidate(std::vector<float>(10, 1.0f));
+
+  try
+  {
+    batchCorrelation.AddCandidate(std::vector<float>(11, 1.0f));
+    std::cerr << "TestLengthMismatch failed! No exception was thrown." << std::endl;
+    return false;
+  }
+  catch(const std::runtime_error&)
+  {
+  }
+
+  return true;
+}
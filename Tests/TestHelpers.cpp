@@ -1,6 +1,8 @@
 #include "Helpers.h"
 
 // STL
+#include <algorithm>
+#include <cstdlib>
 #include <sstream>
 #include <limits>
 
@@ -32,6 +34,8 @@ static bool TestMinOfAllIndices_Scalar();
 static bool TestMaxOfAllIndices_Vector();
 static bool TestMaxOfAllIndices_Scalar();
 
+static bool TestMinMaxOfAllIndices();
+
 static bool TestHasBracketOperator();
 
 static bool TestNegativeLog();
@@ -60,6 +64,8 @@ static bool TestArgmin();
 
 static bool TestArgmax();
 
+static bool TestMinMaxWithIndex();
+
 static bool TestMaxOfIndex();
 
 static bool TestVectorMedian();
@@ -98,6 +104,8 @@ static bool TestForce0to255();
 
 static bool TestHSV_H_Difference();
 
+static bool TestExecutionPolicies();
+
 int main()
 {
   bool AllTestsPass = true;
@@ -127,6 +135,8 @@ int main()
   AllTestsPass &= TestMaxOfAllIndices_Vector();
   AllTestsPass &= TestMaxOfAllIndices_Scalar();
 
+  AllTestsPass &= TestMinMaxOfAllIndices();
+
   AllTestsPass &= TestHasBracketOperator();
 
   AllTestsPass &= TestNegativeLog();
@@ -155,6 +165,8 @@ int main()
 
   AllTestsPass &= TestArgmax();
 
+  AllTestsPass &= TestMinMaxWithIndex();
+
   AllTestsPass &= TestMaxOfIndex();
 
   AllTestsPass &= TestMin();
@@ -196,6 +208,8 @@ int main()
 
   AllTestsPass &= TestHSV_H_Difference();
 
+  AllTestsPass &= TestExecutionPolicies();
+
   if(AllTestsPass)
   {
     std::cerr << "All tests passed!" << std::endl;
@@ -208,6 +222,54 @@ int main()
   }
 }
 
+bool TestMinMaxOfAllIndices()
+{
+  // Both the fixed (3) and dynamic (5) numbers of components, compared to MinOfIndex and MaxOfIndex.
+  const unsigned int numbersOfComponents[] = {3, 5};
+  for(unsigned int test = 0; test < 2; ++test)
+  {
+    const unsigned int numberOfComponents = numbersOfComponents[test];
+    std::vector<std::vector<float> > pixels(1000, std::vector<float>(numberOfComponents));
+    for(size_t i = 0; i < pixels.size(); ++i)
+    {
+      for(unsigned int component = 0; component < numberOfComponents; ++component)
+      {
+        pixels[i][component] = static_cast<float>(rand() % 1000) - 500.0f;
+      }
+    }
+    pixels[0][1] = std::numeric_limits<float>::quiet_NaN();
+
+    std::vector<float> minimum(numberOfComponents);
+    std::vector<float> maximum(numberOfComponents);
+    std::vector<float> minimumOnly(numberOfComponents);
+    Helpers::MinMaxOfAllIndices(pixels, minimum, maximum);
+    Helpers::MinOfAllIndices(pixels, minimumOnly);
+
+    for(unsigned int component = 0; component < numberOfComponents; ++component)
+    {
+      float correctMinimum = std::numeric_limits<float>::max();
+      float correctMaximum = -std::numeric_limits<float>::max();
+      for(size_t i = (component == 1) ? 1 : 0; i < pixels.size(); ++i)
+      {
+        correctMinimum = std::min(correctMinimum, pixels[i][component]);
+        correctMaximum = std::max(correctMaximum, pixels[i][component]);
+      }
+
+      if(minimum[component] != correctMinimum || maximum[component] != correctMaximum ||
+         minimumOnly[component] != correctMinimum ||
+         Helpers::MinOfIndex(pixels, component) != correctMinimum ||
+         Helpers::MaxOfIndex(pixels, component) != correctMaximum)
+      {
+        std::cerr << "TestMinMaxOfAllIndices failed for component " << component << " of "
+                  << numberOfComponents << "!" << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 bool TestNormalizeVector_Int()
 {
   std::cout << "TestNormalizeVector_Int()" << std::endl;
@@ -762,6 +824,76 @@ bool TestArgmax()
     std::cerr << "TestArgmax failed!" << std::endl;
     return false;
   }
+
+  // Every element is smaller than numeric_limits<float>::min() (the smallest positive float).
+  std::vector<float> negative = {-3.0f, -1.0f, -2.0f};
+  if(Helpers::Argmax(negative) != 1)
+  {
+    std::cerr << "TestArgmax failed for negative floats!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestMinMaxWithIndex()
+{
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+
+  // Ties resolve to the first occurrence, and NaNs (including a leading one) are ignored.
+  std::vector<float> v = {nan, 3.0f, -1.0f, 7.0f, nan, -1.0f, 7.0f};
+  Helpers::MinMaxResult<float> result = Helpers::MinMaxWithIndex(v);
+  if(result.Min != -1.0f || result.Argmin != 2 || result.Max != 7.0f || result.Argmax != 3)
+  {
+    std::cerr << "TestMinMaxWithIndex failed! min " << result.Min << " at " << result.Argmin
+              << " max " << result.Max << " at " << result.Argmax << std::endl;
+    return false;
+  }
+
+  std::vector<float> allNaN(3, nan);
+  result = Helpers::MinMaxWithIndex(allNaN);
+  if(result.Argmin != 0 || result.Argmax != 0)
+  {
+    std::cerr << "TestMinMaxWithIndex failed for all NaNs!" << std::endl;
+    return false;
+  }
+
+  // Compare to a brute force search for lengths around the lane and block sizes, and for enough elements
+  // that the parallel version really splits the work. The values repeat, so there are many ties.
+  const size_t lengths[] = {1, 15, 16, 17, 1023, 1024, 1025, 5000, 2 * Helpers::MinimumParallelLength + 3};
+  for(unsigned int lengthId = 0; lengthId < sizeof(lengths) / sizeof(lengths[0]); ++lengthId)
+  {
+    std::vector<int> values(lengths[lengthId]);
+    for(size_t i = 0; i < values.size(); ++i)
+    {
+      values[i] = rand() % 100000;
+    }
+
+    size_t argmin = 0;
+    size_t argmax = 0;
+    for(size_t i = 1; i < values.size(); ++i)
+    {
+      if(values[i] < values[argmin])
+      {
+        argmin = i;
+      }
+      if(values[i] > values[argmax])
+      {
+        argmax = i;
+      }
+    }
+
+    Helpers::MinMaxResult<int> serial = Helpers::MinMaxWithIndex(values);
+    Helpers::MinMaxResult<int> parallel = Helpers::MinMaxWithIndex(values, 4u);
+    if(serial.Argmin != argmin || serial.Argmax != argmax ||
+       serial.Min != values[argmin] || serial.Max != values[argmax] ||
+       parallel.Argmin != argmin || parallel.Argmax != argmax ||
+       Helpers::Min(values) != values[argmin] || Helpers::Max(values) != values[argmax])
+    {
+      std::cerr << "TestMinMaxWithIndex failed for length " << lengths[lengthId] << "!" << std::endl;
+      return false;
+    }
+  }
+
   return true;
 }
 
@@ -841,6 +973,15 @@ bool TestSum()
     return false;
   }
 
+  // Summing in float would stop counting at 2^24.
+  std::vector<unsigned char> ones((1 << 24) + 3, 1);
+  if(Helpers::Sum(ones.begin(), ones.end()) != (1u << 24) + 3)
+  {
+    std::cerr << "TestSum failed! The sum of " << ones.size() << " ones is "
+              << Helpers::Sum(ones.begin(), ones.end()) << std::endl;
+    return false;
+  }
+
   return true;
 }
 
@@ -1088,3 +1229,41 @@ bool TestFuzzyCompare()
 
   return true;
 }
+
+bool TestExecutionPolicies()
+{
+  // Large enough to be split over the threads.
+  const size_t length = 3 * Helpers::MinimumParallelLength + 11;
+  std::vector<float> a(length);
+  std::vector<float> b(length);
+  for(size_t i = 0; i < length; ++i)
+  {
+    a[i] = static_cast<float>(rand()) / RAND_MAX - 0.5f;
+    b[i] = static_cast<float>(rand()) / RAND_MAX - 0.5f;
+  }
+  a[length - 5] = 2.0f;
+
+  bool pass = true;
+  pass &= Helpers::Sum(Helpers::Sequential, a.begin(), a.end()) == Helpers::Sum(a.begin(), a.end());
+  pass &= Helpers::Sum(Helpers::Parallel, a.begin(), a.end()) == Helpers::Sum(a.begin(), a.end());
+  pass &= Helpers::Min(Helpers::Parallel, a) == Helpers::Min(a);
+  pass &= Helpers::Max(Helpers::ParallelVectorized, a) == 2.0f;
+  pass &= Helpers::Argmin(Helpers::Parallel, a) == Helpers::Argmin(a);
+  pass &= Helpers::Argmax(Helpers::Parallel, a) == length - 5;
+  pass &= Helpers::Argmax(Helpers::Parallel, std::vector<float>()) == 0;
+  pass &= Helpers::Contains(Helpers::Parallel, a, 2.0f);
+  pass &= !Helpers::Contains(Helpers::Parallel, a, 3.0f);
+  pass &= !Helpers::ContainsNaN(Helpers::Parallel, a);
+  pass &= Helpers::VectorSumOfAbsoluteDifferences(Helpers::Parallel, a, b) ==
+          Helpers::VectorSumOfAbsoluteDifferences(a, b);
+
+  a[7] = std::numeric_limits<float>::quiet_NaN();
+  pass &= Helpers::ContainsNaN(Helpers::Parallel, a);
+
+  if(!pass)
+  {
+    std::cerr << "TestExecutionPolicies failed!" << std::endl;
+  }
+
+  return pass;
+}
@@ -0,0 +1,203 @@
+#include "Histogram.h"
+
+// STL
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+static bool TestFixedWidth();
+static bool TestEdges();
+static bool TestJoint();
+static bool TestByteLookup();
+static bool TestMultiThreaded();
+static bool TestComparison();
+
+int main()
+{
+  bool allPass = true;
+
+  allPass &= TestFixedWidth();
+  allPass &= TestEdges();
+  allPass &= TestJoint();
+  allPass &= TestByteLookup();
+  allPass &= TestMultiThreaded();
+  allPass &= TestComparison();
+
+  if(allPass)
+  {
+    return EXIT_SUCCESS;
+  }
+  else
+  {
+    return EXIT_FAILURE;
+  }
+}
+
+bool TestFixedWidth()
+{
+  // Bins [0,1), [1,2), [2,3), [3,4]
+  Statistics::Histogram histogram(4, 0.0, 4.0);
+  std::vector<float> values = {0.0f, 0.5f, 1.0f, 2.9f, 3.0f, 4.0f, -0.1f, 4.1f, NAN};
+  histogram.Add(values, 1);
+
+  std::vector<double> correct = {2, 1, 1, 2};
+  if(histogram.GetCounts() != correct || histogram.GetTotal() != 6.0 || histogram.GetNumberOfOutliers() != 3)
+  {
+    std::cerr << "TestFixedWidth failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestEdges()
+{
+  std::vector<double> edges = {0.0, 1.0, 10.0, 100.0};
+  Statistics::Histogram histogram(edges);
+  std::vector<int> values = {0, 1, 5, 9, 10, 99, 100, 101};
+  histogram.Add(values, 1);
+
+  std::vector<double> correct = {1, 3, 3};
+  if(histogram.GetCounts() != correct || histogram.GetNumberOfOutliers() != 1)
+  {
+    std::cerr << "TestEdges failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestJoint()
+{
+  // 2 x 3 bins. The last channel varies fastest.
+  std::vector<std::vector<double> > edges = {{0.0, 1.0, 2.0}, {0.0, 1.0, 2.0, 3.0}};
+  Statistics::Histogram histogram(edges);
+  std::vector<std::vector<float> > values = {{0.5f, 0.5f}, {0.5f, 2.5f}, {1.5f, 1.5f}, {1.5f, 1.5f}, {5.0f, 0.5f}};
+  histogram.Add(values, 1);
+
+  std::vector<double> correct = {1, 0, 1, 0, 2, 0};
+  if(histogram.GetNumberOfBins() != 6 || histogram.GetCounts() != correct || histogram.GetNumberOfOutliers() != 1)
+  {
+    std::cerr << "TestJoint failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestByteLookup()
+{
+  // The unsigned char lookup table must put every value in the same bin as the generic path does.
+  std::vector<unsigned char> bytes(10001);
+  std::vector<int> ints(bytes.size());
+  for(unsigned int i = 0; i < bytes.size(); ++i)
+  {
+    bytes[i] = static_cast<unsigned char>(rand() % 256);
+    ints[i] = bytes[i];
+  }
+
+  Statistics::Histogram byteHistogram(256, 0.0, 256.0);
+  byteHistogram.Add(bytes, 1);
+  Statistics::Histogram intHistogram(256, 0.0, 256.0);
+  intHistogram.Add(ints, 1);
+
+  // 10 bins over part of the range, so some values are outliers.
+  Statistics::Histogram byteRangeHistogram(10, 20.0, 200.0);
+  byteRangeHistogram.Add(bytes, 1);
+  Statistics::Histogram intRangeHistogram(10, 20.0, 200.0);
+  intRangeHistogram.Add(ints, 1);
+
+  // Joint RGB-like data.
+  std::vector<std::vector<unsigned char> > pixels(bytes.size() / 3, std::vector<unsigned char>(3));
+  std::vector<std::vector<int> > intPixels(pixels.size(), std::vector<int>(3));
+  for(unsigned int i = 0; i < pixels.size(); ++i)
+  {
+    for(unsigned int channel = 0; channel < 3; ++channel)
+    {
+      pixels[i][channel] = bytes[3 * i + channel];
+      intPixels[i][channel] = bytes[3 * i + channel];
+    }
+  }
+  Statistics::Histogram pixelHistogram(8, 0.0, 255.0, 3);
+  pixelHistogram.Add(pixels, 1);
+  Statistics::Histogram intPixelHistogram(8, 0.0, 255.0, 3);
+  intPixelHistogram.Add(intPixels, 1);
+
+  if(byteHistogram.GetCounts() != intHistogram.GetCounts() || byteHistogram.GetTotal() != bytes.size() ||
+     byteRangeHistogram.GetCounts() != intRangeHistogram.GetCounts() ||
+     byteRangeHistogram.GetNumberOfOutliers() != intRangeHistogram.GetNumberOfOutliers() ||
+     pixelHistogram.GetCounts() != intPixelHistogram.GetCounts())
+  {
+    std::cerr << "TestByteLookup failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestMultiThreaded()
+{
+  std::vector<float> values(500000);
+  for(unsigned int i = 0; i < values.size(); ++i)
+  {
+    values[i] = static_cast<float>(rand() % 1000) / 10.0f;
+  }
+
+  Statistics::Histogram serial(50, 0.0, 90.0);
+  serial.Add(values, 1);
+  Statistics::Histogram parallel(50, 0.0, 90.0);
+  parallel.Add(values, 4);
+
+  if(serial.GetCounts() != parallel.GetCounts() || serial.GetNumberOfOutliers() != parallel.GetNumberOfOutliers())
+  {
+    std::cerr << "TestMultiThreaded failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestComparison()
+{
+  std::vector<double> a = {1, 2, 3, 0};
+  std::vector<double> b = {0, 2, 3, 1};
+
+  // Identical histograms
+  if(fabs(Statistics::CompareHistograms(a, a, Statistics::HISTOGRAM_CORRELATION) - 1.0) > 1e-12 ||
+     Statistics::CompareHistograms(a, a, Statistics::HISTOGRAM_CHI_SQUARE) != 0.0 ||
+     Statistics::CompareHistograms(a, a, Statistics::HISTOGRAM_INTERSECTION) != 6.0 ||
+     Statistics::CompareHistograms(a, a, Statistics::HISTOGRAM_BHATTACHARYYA) > 1e-7 ||
+     Statistics::CompareHistograms(a, a, Statistics::HISTOGRAM_EARTH_MOVERS) != 0.0)
+  {
+    std::cerr << "TestComparison failed for identical histograms!" << std::endl;
+    return false;
+  }
+
+  // chi-square: (1-0)^2/1 = 1
+  // intersection: 0 + 2 + 3 + 0 = 5
+  // Bhattacharyya: sqrt(1 - (sqrt(4) + sqrt(9)) / 6)
+  // earth mover's: cumulative sums 1/6, 3/6, 6/6, 6/6 and 0, 2/6, 5/6, 6/6, so |differences| = 1/6 + 1/6 + 1/6
+  if(Statistics::CompareHistograms(a, b, Statistics::HISTOGRAM_CHI_SQUARE) != 1.0 ||
+     Statistics::CompareHistograms(a, b, Statistics::HISTOGRAM_INTERSECTION) != 5.0 ||
+     fabs(Statistics::CompareHistograms(a, b, Statistics::HISTOGRAM_BHATTACHARYYA) - sqrt(1.0 - 5.0 / 6.0)) > 1e-12 ||
+     fabs(Statistics::CompareHistograms(a, b, Statistics::HISTOGRAM_EARTH_MOVERS) - 0.5) > 1e-12)
+  {
+    std::cerr << "TestComparison failed!" << std::endl;
+    return false;
+  }
+
+  // The Histogram overload gives the same result as comparing the counts.
+  Statistics::Histogram histogramA(4, 0.0, 4.0);
+  histogramA.Add(std::vector<float>{0.5f, 1.5f, 1.5f, 2.5f, 2.5f, 2.5f}, 1);
+  Statistics::Histogram histogramB(4, 0.0, 4.0);
+  histogramB.Add(std::vector<float>{1.5f, 1.5f, 2.5f, 2.5f, 2.5f, 3.5f}, 1);
+  if(fabs(Statistics::CompareHistograms(histogramA, histogramB, Statistics::HISTOGRAM_EARTH_MOVERS) - 0.5) > 1e-12 ||
+     Statistics::CompareHistograms(histogramA, histogramB, Statistics::HISTOGRAM_INTERSECTION) != 5.0)
+  {
+    std::cerr << "TestComparison failed for Histogram objects!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
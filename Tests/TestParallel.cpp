@@ -0,0 +1,176 @@
+#include "Parallel.h"
+
+// STL
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+static bool TestThreadPool();
+static bool TestParallelForBlocks();
+static bool TestNested();
+static bool TestExceptions();
+static bool TestParallelAnyOf();
+
+int main()
+{
+  bool allPass = true;
+
+  allPass &= TestThreadPool();
+  allPass &= TestParallelForBlocks();
+  allPass &= TestNested();
+  allPass &= TestExceptions();
+  allPass &= TestParallelAnyOf();
+
+  if(allPass)
+  {
+    return EXIT_SUCCESS;
+  }
+  else
+  {
+    return EXIT_FAILURE;
+  }
+}
+
+bool TestThreadPool()
+{
+  std::atomic<int> numberOfTasksRun(0);
+  {
+    Helpers::ThreadPool pool(3);
+    if(pool.GetNumberOfThreads() != 3)
+    {
+      std::cerr << "TestThreadPool failed! The pool has " << pool.GetNumberOfThreads() << " threads." << std::endl;
+      return false;
+    }
+
+    for(unsigned int i = 0; i < 1000; ++i)
+    {
+      pool.Submit([&numberOfTasksRun]() { ++numberOfTasksRun; });
+    }
+  } // The destructor waits for the queued tasks.
+
+  if(numberOfTasksRun != 1000)
+  {
+    std::cerr << "TestThreadPool failed! Only " << numberOfTasksRun << " of 1000 tasks were run." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestParallelForBlocks()
+{
+  const size_t numberOfItems = 1000003;
+  const unsigned int numberOfBlocks = 7;
+
+  // Every item must be visited exactly once, by the block that owns it.
+  std::vector<unsigned char> visits(numberOfItems, 0);
+  std::vector<unsigned int> blockIds(numberOfItems, 0);
+  Helpers::ParallelForBlocks(numberOfItems, numberOfBlocks,
+                             [&](const size_t blockBegin, const size_t blockEnd, const unsigned int blockId)
+  {
+    for(size_t i = blockBegin; i < blockEnd; ++i)
+    {
+      ++visits[i];
+      blockIds[i] = blockId;
+    }
+  });
+
+  for(size_t i = 0; i < numberOfItems; ++i)
+  {
+    if(visits[i] != 1 || i < Helpers::BlockBegin(numberOfItems, numberOfBlocks, blockIds[i]) ||
+       i >= Helpers::BlockBegin(numberOfItems, numberOfBlocks, blockIds[i] + 1))
+    {
+      std::cerr << "TestParallelForBlocks failed at item " << i << "!" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool TestNested()
+{
+  // The outer blocks occupy the pool threads, so the inner calls only finish because
+  // the calling threads work on their own blocks.
+  std::atomic<size_t> total(0);
+  Helpers::ParallelForBlocks(16, 16, [&](const size_t, const size_t, const unsigned int)
+  {
+    Helpers::ParallelForBlocks(1000, 8, [&](const size_t blockBegin, const size_t blockEnd, const unsigned int)
+    {
+      total += blockEnd - blockBegin;
+    });
+  });
+
+  if(total != 16 * 1000)
+  {
+    std::cerr << "TestNested failed! total: " << total << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestExceptions()
+{
+  std::atomic<unsigned int> numberOfBlocksRun(0);
+  try
+  {
+    Helpers::ParallelForBlockIds(8, [&](const unsigned int blockId)
+    {
+      ++numberOfBlocksRun;
+      if(blockId == 5)
+      {
+        throw std::runtime_error("Block 5 failed");
+      }
+    });
+  }
+  catch(const std::runtime_error&)
+  {
+    // The exception must only reach the caller once every block is done.
+    if(numberOfBlocksRun != 8)
+    {
+      std::cerr << "TestExceptions failed! Only " << numberOfBlocksRun << " of 8 blocks were run." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  std::cerr << "TestExceptions failed! The exception was not rethrown." << std::endl;
+  return false;
+}
+
+bool TestParallelAnyOf()
+{
+  const size_t numberOfItems = 1000000;
+  std::vector<int> values(numberOfItems, 0);
+  values[numberOfItems - 3] = 1;
+
+  auto containsOne = [&values](const size_t begin, const size_t end)
+  {
+    for(size_t i = begin; i < end; ++i)
+    {
+      if(values[i] == 1)
+      {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  if(!Helpers::ParallelAnyOf(numberOfItems, 4, containsOne) || !Helpers::ParallelAnyOf(numberOfItems, 1, containsOne))
+  {
+    std::cerr << "TestParallelAnyOf failed! The 1 was not found." << std::endl;
+    return false;
+  }
+
+  values[numberOfItems - 3] = 0;
+  if(Helpers::ParallelAnyOf(numberOfItems, 4, containsOne))
+  {
+    std::cerr << "TestParallelAnyOf failed! A 1 was found that is not there." << std::endl;
+    return false;
+  }
+
+  return true;
+}
@@ -1,6 +1,57 @@
 #include "ParallelSort.h"
 
+// STL
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+static bool TestParallelSortAscending();
+static bool TestParallelSortDescending();
+static bool TestMultiThreaded();
+static bool TestArgSort();
+static bool TestApplyPermutation();
+static bool TestLargeIndexType();
+static bool TestRadixSort();
+static bool TestTopK();
+static bool TestComparator();
+static bool TestSortByKey();
+static bool TestZipSort();
+static bool TestExternalSort();
+static bool TestMerge();
+
+template <typename T>
+static bool MatchesComparisonSort(const std::vector<T>& vec);
+
 int main()
+{
+  bool allPass = true;
+
+  allPass &= TestParallelSortAscending();
+  allPass &= TestParallelSortDescending();
+  allPass &= TestMultiThreaded();
+  allPass &= TestArgSort();
+  allPass &= TestApplyPermutation();
+  allPass &= TestLargeIndexType();
+  allPass &= TestRadixSort();
+  allPass &= TestTopK();
+  allPass &= TestComparator();
+  allPass &= TestSortByKey();
+  allPass &= TestZipSort();
+  allPass &= TestExternalSort();
+  allPass &= TestMerge();
+
+  if(allPass)
+  {
+    return EXIT_SUCCESS;
+  }
+  else
+  {
+    return EXIT_FAILURE;
+  }
+}
+
+bool TestParallelSortAscending()
 {
   std::vector<float> vec;
   vec.push_back(2);
@@ -9,5 +60,478 @@ int main()
 
   ParallelSort<float>::IndexedVectorType sorted = ParallelSort<float>::ParallelSortAscending(vec);
 
-  return 0;
+  if(sorted[0].index != 1 || sorted[1].index != 0 || sorted[2].index != 2)
+  {
+    std::cerr << "TestParallelSortAscending failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestParallelSortDescending()
+{
+  std::vector<float> vec = {2, 1, 3};
+
+  ParallelSort<float>::IndexedVectorType sorted = ParallelSort<float>::ParallelSortDescending(vec);
+
+  if(sorted[0].index != 2 || sorted[1].index != 0 || sorted[2].index != 1)
+  {
+    std::cerr << "TestParallelSortDescending failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestMultiThreaded()
+{
+  // Use few distinct values so that there are many ties - the result must still match
+  // the single threaded sort exactly.
+  std::vector<int> vec(100000);
+  for(size_t i = 0; i < vec.size(); ++i)
+  {
+    vec[i] = rand() % 1000;
+  }
+
+  typedef ParallelSort<int> SortType;
+
+  SortType::IndexedVectorType serialAscending = SortType::ParallelSortAscending(vec, 1);
+  SortType::IndexedVectorType serialDescending = SortType::ParallelSortDescending(vec, 1);
+
+  // 7 threads gives an odd number of runs to merge.
+  SortType::IndexedVectorType parallelAscending = SortType::ParallelSortAscending(vec, 7);
+  SortType::IndexedVectorType parallelDescending = SortType::ParallelSortDescending(vec, 7);
+
+  for(size_t i = 0; i < vec.size(); ++i)
+  {
+    if(parallelAscending[i].index != serialAscending[i].index ||
+       parallelDescending[i].index != serialDescending[i].index)
+    {
+      std::cerr << "TestMultiThreaded failed at position " << i << "!" << std::endl;
+      return false;
+    }
+  }
+
+  for(size_t i = 1; i < vec.size(); ++i)
+  {
+    if(parallelAscending[i].value < parallelAscending[i-1].value ||
+       parallelDescending[i-1].value < parallelDescending[i].value)
+    {
+      std::cerr << "TestMultiThreaded failed: result is not sorted!" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool TestArgSort()
+{
+  std::vector<int> vec(50000);
+  for(size_t i = 0; i < vec.size(); ++i)
+  {
+    vec[i] = rand() % 100;
+  }
+
+  typedef ParallelSort<int> SortType;
+
+  SortType::IndexedVectorType ascending = SortType::ParallelSortAscending(vec);
+  SortType::IndexedVectorType descending = SortType::ParallelSortDescending(vec);
+  SortType::PermutationType ascendingPermutation = SortType::ArgSortAscending(vec, 3);
+  SortType::PermutationType descendingPermutation = SortType::ArgSortDescending(vec, 3);
+
+  for(size_t i = 0; i < vec.size(); ++i)
+  {
+    if(ascendingPermutation[i] != ascending[i].index ||
+       descendingPermutation[i] != descending[i].index)
+    {
+      std::cerr << "TestArgSort failed at position " << i << "!" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool TestApplyPermutation()
+{
+  std::vector<float> values = {3, 1, 2, 0};
+  std::vector<std::string> names = {"three", "one", "two", "zero"};
+
+  ParallelSort<float>::PermutationType permutation = ParallelSort<float>::ArgSortAscending(values);
+  ParallelSort<float>::ApplyPermutation(permutation, values, names);
+
+  std::vector<float> correctValues = {0, 1, 2, 3};
+  std::vector<std::string> correctNames = {"zero", "one", "two", "three"};
+  if(values != correctValues || names != correctNames)
+  {
+    std::cerr << "TestApplyPermutation failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestLargeIndexType()
+{
+  std::vector<double> vec = {2, 1, 3};
+
+  typedef ParallelSort<double, size_t> SortType;
+  SortType::IndexedVectorType sorted = SortType::ParallelSortDescending(vec);
+
+  static_assert(sizeof(SortType::IndexType) == sizeof(size_t), "IndexType should be size_t!");
+
+  if(sorted[0].index != 2 || sorted[1].index != 0 || sorted[2].index != 1)
+  {
+    std::cerr << "TestLargeIndexType failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+template <typename T>
+bool MatchesComparisonSort(const std::vector<T>& vec)
+{
+  typedef ParallelSort<T> SortType;
+
+  typename SortType::IndexedVectorType ascending = SortType::ParallelSortAscending(vec, 2);
+  typename SortType::IndexedVectorType descending = SortType::ParallelSortDescending(vec, 2);
+
+  typename SortType::IndexedVectorType correctAscending = SortType::CreateInternalData(vec);
+  std::sort(correctAscending.begin(), correctAscending.end(), typename SortType::AscendingCompare());
+  typename SortType::IndexedVectorType correctDescending = SortType::CreateInternalData(vec);
+  std::sort(correctDescending.begin(), correctDescending.end(), typename SortType::DescendingCompare());
+
+  for(size_t i = 0; i < vec.size(); ++i)
+  {
+    if(ascending[i].index != correctAscending[i].index ||
+       descending[i].index != correctDescending[i].index)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool TestRadixSort()
+{
+  const size_t numberOfElements = 30000;
+
+  std::vector<unsigned char> ucharVector(numberOfElements);
+  std::vector<int> intVector(numberOfElements);
+  std::vector<unsigned int> uintVector(numberOfElements);
+  std::vector<float> floatVector(numberOfElements);
+  std::vector<double> doubleVector(numberOfElements);
+  for(size_t i = 0; i < numberOfElements; ++i)
+  {
+    ucharVector[i] = rand() % 256;
+    intVector[i] = rand() - RAND_MAX / 2;
+    uintVector[i] = rand() % 5000;
+    floatVector[i] = static_cast<float>(rand() % 2000 - 1000) / 7.0f;
+    doubleVector[i] = static_cast<double>(rand()) / RAND_MAX - 0.5;
+  }
+
+  // -0 and +0 compare equal, so they must be treated as ties.
+  floatVector[10] = -0.0f;
+  floatVector[20] = 0.0f;
+  floatVector[30] = -0.0f;
+
+  bool pass = true;
+  pass &= MatchesComparisonSort(ucharVector);
+  pass &= MatchesComparisonSort(intVector);
+  pass &= MatchesComparisonSort(uintVector);
+  pass &= MatchesComparisonSort(floatVector);
+  pass &= MatchesComparisonSort(doubleVector);
+
+  if(!pass)
+  {
+    std::cerr << "TestRadixSort failed!" << std::endl;
+  }
+
+  return pass;
+}
+
+bool TestTopK()
+{
+  std::vector<float> vec(100000);
+  for(size_t i = 0; i < vec.size(); ++i)
+  {
+    vec[i] = rand() % 500;
+  }
+
+  typedef ParallelSort<float> SortType;
+
+  SortType::IndexedVectorType ascending = SortType::ParallelSortAscending(vec);
+  SortType::IndexedVectorType descending = SortType::ParallelSortDescending(vec);
+
+  const size_t k = 300;
+  SortType::IndexedVectorType ascendingTopK = SortType::ParallelSortAscendingTopK(vec, k, 4);
+  SortType::IndexedVectorType descendingTopK = SortType::ParallelSortDescendingTopK(vec, k, 4);
+
+  if(ascendingTopK.size() != k || descendingTopK.size() != k)
+  {
+    std::cerr << "TestTopK failed: wrong number of elements returned!" << std::endl;
+    return false;
+  }
+
+  for(size_t i = 0; i < k; ++i)
+  {
+    if(ascendingTopK[i].index != ascending[i].index ||
+       descendingTopK[i].index != descending[i].index)
+    {
+      std::cerr << "TestTopK failed at position " << i << "!" << std::endl;
+      return false;
+    }
+  }
+
+  // Asking for more elements than there are returns all of them.
+  std::vector<float> small = {2, 1, 3};
+  if(SortType::ParallelSortDescendingTopK(small, 10).size() != 3)
+  {
+    std::cerr << "TestTopK failed: k larger than the input!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/** Compare only the tens digit, so that there are lots of equivalent elements. */
+struct TensDigitCompare
+{
+  bool operator()(const int a, const int b) const
+  {
+    return a / 10 < b / 10;
+  }
+};
+
+bool TestComparator()
+{
+  std::vector<int> vec = {25, 13, 21, 17, 29, 11};
+
+  typedef ParallelSort<int> SortType;
+
+  SortType::IndexedVectorType ascending = SortType::ParallelSortWithComparator(vec, TensDigitCompare(), false, true);
+  std::vector<int> correctAscending = {13, 17, 11, 25, 21, 29};
+
+  SortType::IndexedVectorType descending = SortType::ParallelSortWithComparator(vec, TensDigitCompare(), true, true);
+  std::vector<int> correctDescending = {25, 21, 29, 13, 17, 11};
+
+  for(size_t i = 0; i < vec.size(); ++i)
+  {
+    if(ascending[i].value != correctAscending[i] || descending[i].value != correctDescending[i])
+    {
+      std::cerr << "TestComparator failed at position " << i << "!" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/** Sort pixels by their second channel, and count how many times the key is extracted. */
+struct SecondChannel
+{
+  SecondChannel(unsigned int& numberOfCalls) : NumberOfCalls(numberOfCalls) {}
+
+  float operator()(const std::vector<float>& pixel) const
+  {
+    this->NumberOfCalls++;
+    return pixel[1];
+  }
+
+  unsigned int& NumberOfCalls;
+};
+
+bool TestSortByKey()
+{
+  std::vector<std::vector<float> > pixels;
+  for(unsigned int i = 0; i < 1000; ++i)
+  {
+    std::vector<float> pixel = {static_cast<float>(i), static_cast<float>(rand() % 50), 0};
+    pixels.push_back(pixel);
+  }
+
+  typedef ParallelSort<std::vector<float> > SortType;
+
+  unsigned int numberOfCalls = 0;
+  SortType::IndexedVectorType sorted = SortType::ParallelSortByKey(pixels, SecondChannel(numberOfCalls), true, true, 1);
+
+  if(numberOfCalls != pixels.size())
+  {
+    std::cerr << "TestSortByKey failed: the key was extracted " << numberOfCalls << " times!" << std::endl;
+    return false;
+  }
+
+  for(size_t i = 1; i < sorted.size(); ++i)
+  {
+    // Descending by key, and stable (increasing index) within a key.
+    if(sorted[i-1].value[1] < sorted[i].value[1] ||
+       (sorted[i-1].value[1] == sorted[i].value[1] && sorted[i-1].index > sorted[i].index) ||
+       sorted[i].value != pixels[sorted[i].index])
+    {
+      std::cerr << "TestSortByKey failed at position " << i << "!" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool TestZipSort()
+{
+  std::vector<float> costs = {0.5f, 0.1f, 0.9f, 0.3f};
+  std::vector<std::pair<int, int> > pixels = {{5, 5}, {1, 1}, {9, 9}, {3, 3}};
+  std::vector<unsigned int> patchIds = {50, 10, 90, 30};
+
+  ParallelSort<float>::ZipSortDescending(costs, pixels, patchIds);
+
+  std::vector<float> correctCosts = {0.9f, 0.5f, 0.3f, 0.1f};
+  std::vector<unsigned int> correctPatchIds = {90, 50, 30, 10};
+  for(size_t i = 0; i < costs.size(); ++i)
+  {
+    if(costs[i] != correctCosts[i] || patchIds[i] != correctPatchIds[i] ||
+       pixels[i].first != static_cast<int>(patchIds[i] / 10))
+    {
+      std::cerr << "TestZipSort failed at position " << i << "!" << std::endl;
+      return false;
+    }
+  }
+
+  // Mismatched sizes must be rejected without touching the inputs.
+  std::vector<float> keys = {2, 1};
+  std::vector<int> wrongSize = {1, 2, 3};
+  try
+  {
+    ParallelSort<float>::ZipSortAscending(keys, wrongSize);
+    std::cerr << "TestZipSort failed: mismatched sizes were not detected!" << std::endl;
+    return false;
+  }
+  catch(std::runtime_error&)
+  {
+    if(keys[0] != 2)
+    {
+      std::cerr << "TestZipSort failed: keys were modified!" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool TestExternalSort()
+{
+  std::vector<float> vec(50000);
+  for(size_t i = 0; i < vec.size(); ++i)
+  {
+    vec[i] = rand() % 1000;
+  }
+
+  std::ofstream input("ExternalSortInput.raw", std::ios::binary);
+  input.write(reinterpret_cast<const char*>(vec.data()), vec.size() * sizeof(float));
+  input.close();
+
+  typedef ParallelSort<float> SortType;
+
+  // 64KB of memory gives 16 runs, and they have to be merged in several passes.
+  SortType::ExternalSort("ExternalSortInput.raw", "ExternalSortOutput.raw", true, 64 * 1024, 2);
+
+  SortType::IndexedVectorType sorted(vec.size());
+  std::ifstream output("ExternalSortOutput.raw", std::ios::binary);
+  output.read(reinterpret_cast<char*>(sorted.data()), sorted.size() * sizeof(SortType::IndexedValue));
+  const bool outputSizeIsCorrect = output && output.peek() == EOF;
+  output.close();
+
+  // "." cannot be opened as the output file, so this throws after the run files ("..pass0.run0" etc.) have
+  // been written; they must still be deleted. With 512KB there are a few runs, merged in a single pass.
+  bool threw = false;
+  try
+  {
+    SortType::ExternalSort("ExternalSortInput.raw", ".", true, 512 * 1024, 2);
+  }
+  catch(const std::runtime_error&)
+  {
+    threw = true;
+  }
+  const bool runFilesRemain = std::ifstream("..pass0.run0").good();
+
+  std::remove("ExternalSortInput.raw");
+  std::remove("ExternalSortOutput.raw");
+
+  if(!outputSizeIsCorrect)
+  {
+    std::cerr << "TestExternalSort failed: the output has the wrong size!" << std::endl;
+    return false;
+  }
+
+  if(!threw || runFilesRemain)
+  {
+    std::cerr << "TestExternalSort failed: the run files were not deleted after an error!" << std::endl;
+    return false;
+  }
+
+  SortType::IndexedVectorType correct = SortType::ParallelSortDescending(vec);
+  for(size_t i = 0; i < vec.size(); ++i)
+  {
+    if(sorted[i].index != correct[i].index || sorted[i].value != correct[i].value)
+    {
+      std::cerr << "TestExternalSort failed at position " << i << "!" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool TestMerge()
+{
+  typedef ParallelSort<int> SortType;
+
+  // Sort several batches separately, then merge them. The result must be the same as sorting everything at once.
+  std::vector<int> all;
+  std::vector<SortType::IndexedVectorType> ascendingRuns;
+  std::vector<SortType::IndexedVectorType> descendingRuns;
+  SortType::IndexedVectorType incremental;
+  for(unsigned int batch = 0; batch < 5; ++batch)
+  {
+    std::vector<int> values(10000 + 3000 * batch);
+    for(size_t i = 0; i < values.size(); ++i)
+    {
+      values[i] = rand() % 300;
+    }
+    all.insert(all.end(), values.begin(), values.end());
+
+    ascendingRuns.push_back(SortType::ParallelSortAscending(values));
+    descendingRuns.push_back(SortType::ParallelSortDescending(values));
+
+    incremental = SortType::Merge(incremental, ascendingRuns.back(), false, 3);
+  }
+
+  SortType::IndexedVectorType correctAscending = SortType::ParallelSortAscending(all);
+  SortType::IndexedVectorType correctDescending = SortType::ParallelSortDescending(all);
+
+  SortType::IndexedVectorType mergedAscending = SortType::Merge(ascendingRuns, false, 4);
+  SortType::IndexedVectorType mergedDescending = SortType::Merge(descendingRuns, true, 4);
+
+  if(mergedAscending.size() != all.size() || mergedDescending.size() != all.size() ||
+     incremental.size() != all.size())
+  {
+    std::cerr << "TestMerge failed: wrong number of elements!" << std::endl;
+    return false;
+  }
+
+  for(size_t i = 0; i < all.size(); ++i)
+  {
+    if(mergedAscending[i].index != correctAscending[i].index ||
+       mergedDescending[i].index != correctDescending[i].index ||
+       incremental[i].index != correctAscending[i].index)
+    {
+      std::cerr << "TestMerge failed at position " << i << "!" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
 }
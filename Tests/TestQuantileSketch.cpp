@@ -0,0 +1,136 @@
+#include "QuantileSketch.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+static bool TestSmall();
+static bool TestAccuracy();
+static bool TestMerge();
+static bool TestPushVector();
+
+int main()
+{
+  bool allPass = true;
+
+  allPass &= TestSmall();
+  allPass &= TestAccuracy();
+  allPass &= TestMerge();
+  allPass &= TestPushVector();
+
+  if(allPass)
+  {
+    return EXIT_SUCCESS;
+  }
+  else
+  {
+    return EXIT_FAILURE;
+  }
+}
+
+/** A shuffled 0, 1, ..., n-1, so that the rank of value x is x / n. */
+static std::vector<float> CreateShuffledValues(const unsigned int n)
+{
+  std::vector<float> values(n);
+  for(unsigned int i = 0; i < n; ++i)
+  {
+    values[i] = static_cast<float>(i);
+  }
+  std::random_shuffle(values.begin(), values.end());
+  return values;
+}
+
+/** Check that every quantile has a rank within the documented error. */
+static bool QuantilesAreAccurate(const Statistics::QuantileSketch<float>& sketch)
+{
+  const std::vector<double> p = {0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99};
+  const std::vector<float> quantiles = sketch.GetQuantiles(p);
+  for(size_t i = 0; i < p.size(); ++i)
+  {
+    const double rank = quantiles[i] / static_cast<double>(sketch.GetCount());
+    if(fabs(rank - p[i]) > sketch.GetNormalizedRankError())
+    {
+      std::cerr << "Quantile " << p[i] << " has rank " << rank << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TestSmall()
+{
+  // While nothing has been compacted the sketch is exact.
+  Statistics::QuantileSketch<float> sketch;
+  std::vector<float> values = {5, 1, 3, NAN, 4, 2};
+  sketch.PushRange(values.begin(), values.end());
+
+  if(sketch.GetCount() != 5 || sketch.GetMedian() != 3 || sketch.GetMin() != 1 || sketch.GetMax() != 5 ||
+     sketch.GetQuantile(0.0) != 1 || sketch.GetQuantile(1.0) != 5 || sketch.GetRank(2) != 0.4)
+  {
+    std::cerr << "TestSmall failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestAccuracy()
+{
+  const unsigned int n = 1000000;
+  std::vector<float> values = CreateShuffledValues(n);
+
+  Statistics::QuantileSketch<float> sketch;
+  sketch.PushRange(values.begin(), values.end());
+
+  // The memory is bounded by about 3k values (plus the small levels at the bottom).
+  if(sketch.GetCount() != n || sketch.GetNumberOfRetainedValues() > 4 * sketch.GetK() ||
+     sketch.GetMin() != 0 || sketch.GetMax() != n - 1 || !QuantilesAreAccurate(sketch))
+  {
+    std::cerr << "TestAccuracy failed! Retained " << sketch.GetNumberOfRetainedValues() << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestMerge()
+{
+  const unsigned int n = 1000000;
+  std::vector<float> values = CreateShuffledValues(n);
+
+  Statistics::QuantileSketch<float> merged;
+  for(unsigned int part = 0; part < 4; ++part)
+  {
+    Statistics::QuantileSketch<float> partSketch(200, part);
+    partSketch.PushRange(values.begin() + part * n / 4, values.begin() + (part + 1) * n / 4);
+    merged.Merge(partSketch);
+  }
+
+  if(merged.GetCount() != n || merged.GetNumberOfRetainedValues() > 4 * merged.GetK() || !QuantilesAreAccurate(merged))
+  {
+    std::cerr << "TestMerge failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestPushVector()
+{
+  const unsigned int n = 1000000;
+  std::vector<float> values = CreateShuffledValues(n);
+
+  Statistics::QuantileSketch<float> sketch(1000);
+  sketch.PushVector(values, 4);
+
+  if(sketch.GetCount() != n || !QuantilesAreAccurate(sketch))
+  {
+    std::cerr << "TestPushVector failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,147 @@
+#include "Quantiles.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+static bool TestInterpolation();
+static bool TestMatchesSort();
+static bool TestInPlace();
+static bool TestMultiThreaded();
+static bool TestNoProbabilities();
+
+int main()
+{
+  bool allPass = true;
+
+  allPass &= TestInterpolation();
+  allPass &= TestMatchesSort();
+  allPass &= TestInPlace();
+  allPass &= TestMultiThreaded();
+  allPass &= TestNoProbabilities();
+
+  if(allPass)
+  {
+    return EXIT_SUCCESS;
+  }
+  else
+  {
+    return EXIT_FAILURE;
+  }
+}
+
+bool TestInterpolation()
+{
+//  >>> v = [10, 7, 4, 3, 2, 1]
+//  >>> [numpy.percentile(v, [25, 50], method=m) for m in ['linear', 'lower', 'higher', 'nearest', 'midpoint']]
+//  [[2.25, 3.5], [2, 3], [3, 4], [2, 3], [2.5, 3.5]]
+  std::vector<float> v = {10, 7, 4, 3, 2, 1};
+  std::vector<double> p = {0.25, 0.5};
+
+  if(Statistics::Quantiles(v, p, Statistics::QUANTILE_LINEAR) != std::vector<float>({2.25f, 3.5f}) ||
+     Statistics::Quantiles(v, p, Statistics::QUANTILE_LOWER) != std::vector<float>({2.0f, 3.0f}) ||
+     Statistics::Quantiles(v, p, Statistics::QUANTILE_HIGHER) != std::vector<float>({3.0f, 4.0f}) ||
+     Statistics::Quantiles(v, p, Statistics::QUANTILE_NEAREST) != std::vector<float>({2.0f, 3.0f}) ||
+     Statistics::Quantiles(v, p, Statistics::QUANTILE_MIDPOINT) != std::vector<float>({2.5f, 3.5f}) ||
+     Statistics::Quantile(v, 0.0) != 1.0f || Statistics::Quantile(v, 1.0) != 10.0f)
+  {
+    std::cerr << "TestInterpolation failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/** Compute the quantiles by sorting a copy of 'v'. */
+static std::vector<float> SortedQuantiles(std::vector<float> v, const std::vector<double>& p)
+{
+  std::sort(v.begin(), v.end());
+  std::vector<float> quantiles(p.size());
+  for(size_t i = 0; i < p.size(); ++i)
+  {
+    const double position = (v.size() - 1) * p[i];
+    const size_t lower = static_cast<size_t>(floor(position));
+    const size_t upper = std::min(lower + 1, v.size() - 1);
+    quantiles[i] = static_cast<float>(v[lower] + (position - lower) * (static_cast<double>(v[upper]) - v[lower]));
+  }
+  return quantiles;
+}
+
+bool TestMatchesSort()
+{
+  // Many repeated values, and requested quantiles in no particular order.
+  std::vector<float> v(10007);
+  for(unsigned int i = 0; i < v.size(); ++i)
+  {
+    v[i] = static_cast<float>(rand() % 500);
+  }
+  const std::vector<double> p = {0.95, 0.05, 0.5, 0.25, 0.75, 0.333, 0.0, 1.0};
+
+  if(Statistics::Quantiles(v, p) != SortedQuantiles(v, p))
+  {
+    std::cerr << "TestMatchesSort failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestInPlace()
+{
+  std::vector<int> v = {9, 1, 8, 2, 7, 3, 6, 4, 5};
+  std::vector<float> quartiles = Statistics::QuantilesInPlace(v, {0.25, 0.5, 0.75});
+
+  if(quartiles != std::vector<float>({3.0f, 5.0f, 7.0f}) || v[4] != 5)
+  {
+    std::cerr << "TestInPlace failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestMultiThreaded()
+{
+  std::vector<float> v(500000);
+  for(unsigned int i = 0; i < v.size(); ++i)
+  {
+    v[i] = static_cast<float>(rand() % 100000) / 7.0f;
+  }
+  const std::vector<double> p = {0.05, 0.25, 0.5, 0.75, 0.95};
+  const std::vector<float> correct = SortedQuantiles(v, p);
+
+  std::vector<float> inPlace = v;
+  if(Statistics::Quantiles(v, p, Statistics::QUANTILE_LINEAR, 4) != correct ||
+     Statistics::QuantilesInPlace(inPlace, p, Statistics::QUANTILE_LINEAR, 4) != correct)
+  {
+    std::cerr << "TestMultiThreaded failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestNoProbabilities()
+{
+  // Large enough to take the multi-threaded path, which must not pick a pivot rank when there are no ranks.
+  std::vector<float> v(200000);
+  for(unsigned int i = 0; i < v.size(); ++i)
+  {
+    v[i] = static_cast<float>(rand() % 100000) / 7.0f;
+  }
+  const std::vector<double> p;
+
+  std::vector<float> inPlace = v;
+  if(!Statistics::Quantiles(v, p, Statistics::QUANTILE_LINEAR, 4).empty() ||
+     !Statistics::QuantilesInPlace(inPlace, p, Statistics::QUANTILE_LINEAR, 4).empty() ||
+     !Statistics::Quantiles(v, p).empty())
+  {
+    std::cerr << "TestNoProbabilities failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,117 @@
+#include "RunningStatistics.h"
+#include "Statistics.h"
+
+// STL
+#include <cstdlib>
+#include <iostream>
+
+static bool TestScalar();
+static bool TestMultiComponent();
+static bool TestMerge();
+
+int main()
+{
+  bool allPass = true;
+
+  allPass &= TestScalar();
+  allPass &= TestMultiComponent();
+  allPass &= TestMerge();
+
+  if(allPass)
+  {
+    return EXIT_SUCCESS;
+  }
+  else
+  {
+    return EXIT_FAILURE;
+  }
+}
+
+bool TestScalar()
+{
+//  octave:1> v = [1,10,4];
+//  octave:2> mean(v)
+//  ans =  5
+//  octave:3> var(v)
+//  ans =  21
+
+  std::vector<unsigned char> v = {1,10,4};
+
+  Statistics::RunningStatistics<unsigned char> runningStatistics;
+  runningStatistics.PushRange(v.begin(), v.end());
+
+  float mean = runningStatistics.GetMean();
+  float variance = runningStatistics.GetVariance();
+
+  if(runningStatistics.GetCount() != 3 ||
+     !Helpers::FuzzyCompare(mean, 5.0f, 1e-5f) ||
+     !Helpers::FuzzyCompare(variance, 21.0f, 1e-4f) ||
+     runningStatistics.GetMin() != 1 ||
+     runningStatistics.GetMax() != 10)
+  {
+    std::cerr << "TestScalar failed! mean: " << mean << " variance: " << variance << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestMultiComponent()
+{
+  typedef std::vector<float> PixelType;
+  std::vector<PixelType> pixels = {{1, 2, 3}, {10, 2, 5}};
+
+  Statistics::RunningStatistics<PixelType> runningStatistics;
+  runningStatistics.PushRange(pixels.begin(), pixels.end());
+
+  PixelType mean = runningStatistics.GetMean();
+  PixelType variance = runningStatistics.GetVariance();
+  PixelType minimum = runningStatistics.GetMin();
+  PixelType maximum = runningStatistics.GetMax();
+
+  PixelType correctMean = {5.5f, 2.0f, 4.0f};
+  PixelType correctVariance = {40.5f, 0.0f, 2.0f};
+  PixelType correctMin = {1, 2, 3};
+  PixelType correctMax = {10, 2, 5};
+
+  if(!Helpers::FuzzyCompare(mean, correctMean, 1e-5f) ||
+     !Helpers::FuzzyCompare(variance, correctVariance, 1e-4f) ||
+     minimum != correctMin || maximum != correctMax)
+  {
+    std::cerr << "TestMultiComponent failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestMerge()
+{
+  std::vector<float> v(10000);
+  for(size_t i = 0; i < v.size(); ++i)
+  {
+    v[i] = 1000.0f + static_cast<float>(rand() % 1000) / 10.0f;
+  }
+
+  // Accumulate two halves separately (as two threads would) and combine them.
+  Statistics::RunningStatistics<float> firstHalf;
+  firstHalf.PushRange(v.begin(), v.begin() + 3000);
+  Statistics::RunningStatistics<float> secondHalf;
+  secondHalf.PushRange(v.begin() + 3000, v.end());
+  firstHalf.Merge(secondHalf);
+
+  Statistics::RunningStatistics<float> all;
+  all.PushRange(v.begin(), v.end());
+
+  if(firstHalf.GetCount() != v.size() ||
+     !Helpers::FuzzyCompare(firstHalf.GetMean(0), all.GetMean(0), 1e-9) ||
+     !Helpers::FuzzyCompare(firstHalf.GetVariance(0), all.GetVariance(0), 1e-6) ||
+     !Helpers::FuzzyCompare(firstHalf.GetVariance(), Statistics::Variance(v), 1e-2f) ||
+     firstHalf.GetMin(0) != all.GetMin(0) || firstHalf.GetMax(0) != all.GetMax(0))
+  {
+    std::cerr << "TestMerge failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
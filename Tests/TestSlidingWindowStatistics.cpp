@@ -0,0 +1,133 @@
+#include "SlidingWindowStatistics.h"
+#include "Statistics.h"
+#include "Helpers.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+static bool TestScalar();
+static bool TestMultiComponent();
+static bool TestBatch();
+static bool TestLongStream();
+
+int main()
+{
+  bool allPass = true;
+
+  allPass &= TestScalar();
+  allPass &= TestMultiComponent();
+  allPass &= TestBatch();
+  allPass &= TestLongStream();
+
+  if(allPass)
+  {
+    return EXIT_SUCCESS;
+  }
+  else
+  {
+    return EXIT_FAILURE;
+  }
+}
+
+bool TestScalar()
+{
+  // Compare every window to the statistics of a copy of that window.
+  const size_t windowSize = 7;
+  Statistics::SlidingWindowStatistics<float> window(windowSize);
+  std::vector<float> values(1000);
+  for(size_t i = 0; i < values.size(); ++i)
+  {
+    values[i] = static_cast<float>(rand() % 1000) / 10.0f;
+    window.Push(values[i]);
+
+    const size_t first = (i + 1 >= windowSize) ? i + 1 - windowSize : 0;
+    std::vector<float> contents(values.begin() + first, values.begin() + i + 1);
+    if(window.GetCount() != contents.size() ||
+       window.GetMin() != Helpers::Min(contents) || window.GetMax() != Helpers::Max(contents) ||
+       fabs(window.GetMean() - Statistics::Average(contents)) > 1e-4f ||
+       (contents.size() > 1 && fabs(window.GetVariance() - Statistics::Variance(contents)) > 1e-3f))
+    {
+      std::cerr << "TestScalar failed at value " << i << "!" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool TestMultiComponent()
+{
+  Statistics::SlidingWindowStatistics<std::vector<float> > window(3);
+  window.Push(std::vector<float>{1, 10});
+  window.Push(std::vector<float>{2, 30});
+  window.Push(std::vector<float>{3, 20});
+  window.Push(std::vector<float>{4, 0});
+
+  // The window is {2, 30}, {3, 20}, {4, 0}
+  if(window.GetMean() != std::vector<float>({3, 50.0f / 3.0f}) ||
+     window.GetMin() != std::vector<float>({2, 0}) || window.GetMax() != std::vector<float>({4, 30}) ||
+     fabs(window.GetVariance(0) - 1.0) > 1e-12)
+  {
+    std::cerr << "TestMultiComponent failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestBatch()
+{
+  std::vector<unsigned char> v = {5, 1, 4, 2, 8, 3};
+
+  std::vector<unsigned char> correctMin = {1, 1, 2, 2};
+  std::vector<unsigned char> correctMax = {5, 4, 8, 8};
+  std::vector<float> correctAverage = {10.0f / 3.0f, 7.0f / 3.0f, 14.0f / 3.0f, 13.0f / 3.0f};
+
+  std::vector<float> average = Statistics::MovingAverage(v, 3);
+  std::vector<float> variance = Statistics::MovingVariance(v, 3);
+  if(Statistics::MovingMin(v, 3) != correctMin || Statistics::MovingMax(v, 3) != correctMax ||
+     average.size() != 4 || variance.size() != 4 || Statistics::MovingMin(v, 7).size() != 0)
+  {
+    std::cerr << "TestBatch failed!" << std::endl;
+    return false;
+  }
+
+  for(size_t i = 0; i < average.size(); ++i)
+  {
+    std::vector<unsigned char> contents(v.begin() + i, v.begin() + i + 3);
+    if(fabs(average[i] - correctAverage[i]) > 1e-5f || fabs(variance[i] - Statistics::Variance(contents)) > 1e-5f)
+    {
+      std::cerr << "TestBatch failed at window " << i << "!" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool TestLongStream()
+{
+  // Values far from 0 with a small spread, for long enough that unchecked rounding errors would add up.
+  const size_t windowSize = 100;
+  Statistics::SlidingWindowStatistics<double> window(windowSize);
+  std::vector<double> last(windowSize);
+  for(size_t i = 0; i < 1000000; ++i)
+  {
+    const double value = 1e6 + (rand() % 1000) / 1000.0;
+    window.Push(value);
+    last[i % windowSize] = value;
+  }
+
+  const double correct = Statistics::Variance(last);
+  if(fabs(window.GetVariance() - correct) > 1e-6 * correct)
+  {
+    std::cerr << "TestLongStream failed! " << window.GetVariance() << " vs " << correct << std::endl;
+    return false;
+  }
+
+  return true;
+}
@@ -4,6 +4,9 @@ static bool TestAverage();
 //static bool TestRunningAverage();
 static bool TestVariance();
 static bool TestCorrelation();
+static bool TestParallel();
+static bool TestMultiComponentVariance();
+static bool TestCovariance();
 
 int main()
 {
@@ -13,6 +16,9 @@ int main()
   //allPass &= TestRunningAverage();
   allPass &= TestVariance();
   allPass &= TestCorrelation();
+  allPass &= TestParallel();
+  allPass &= TestMultiComponentVariance();
+  allPass &= TestCovariance();
 
   if(allPass)
   {
@@ -36,6 +42,15 @@ bool TestAverage()
   {
     return false;
   }
+
+  // Integers are summed exactly; a float sum would drop each of the 1s (16777216 + 1 == 16777216 in float).
+  std::vector<unsigned int> large = {16777216, 1, 1, 1, 1};
+  if(Statistics::Average(large) != 3355444.0f || Statistics::Average(large, 2) != 3355444.0f)
+  {
+    std::cerr << "TestAverage failed! Average: " << Statistics::Average(large) << std::endl;
+    return false;
+  }
+
   return true;
 }
 /*
@@ -80,5 +95,152 @@ bool TestCorrelation()
     return false;
   }
 
+//  >>> statistics.correlation([1,2,3,4,7], [2,4,5,9,8])
+//  0.8217117956208941
+  std::vector<float> c = {1,2,3,4,7};
+  std::vector<float> d = {2,4,5,9,8};
+  correlation = Statistics::Correlation(c,d);
+  if(fabs(correlation - 0.8217118f) > 1e-6f)
+  {
+    std::cerr << "TestCorrelation failed! Correlation: " << correlation << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestParallel()
+{
+  std::vector<float> a(500000);
+  std::vector<float> b(a.size());
+  for(size_t i = 0; i < a.size(); ++i)
+  {
+    a[i] = static_cast<float>(rand() % 1000) / 10.0f;
+    b[i] = a[i] + static_cast<float>(rand() % 100) / 10.0f;
+  }
+
+  // The serial versions accumulate in float, so only expect agreement to a few digits.
+  float serialAverage = Statistics::Average(a);
+  float parallelAverage = Statistics::Average(a, 4);
+
+  float serialVariance = Statistics::Variance(a);
+  float parallelVariance = Statistics::Variance(a, 4);
+
+  float serialCorrelation = Statistics::Correlation(a, b);
+  float parallelCorrelation = Statistics::Correlation(a, b, 4);
+
+  if(fabs(serialAverage - parallelAverage) > 1e-3f * fabs(serialAverage) ||
+     fabs(serialVariance - parallelVariance) > 1e-3f * fabs(serialVariance) ||
+     fabs(serialCorrelation - parallelCorrelation) > 1e-3f * fabs(serialCorrelation))
+  {
+    std::cerr << "TestParallel failed!"
+              << " Average: " << serialAverage << " vs " << parallelAverage
+              << " Variance: " << serialVariance << " vs " << parallelVariance
+              << " Correlation: " << serialCorrelation << " vs " << parallelCorrelation << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestMultiComponentVariance()
+{
+  // 3 channels use a fixed-channel specialization and 5 channels use the generic version.
+  // Each channel must match the variance of that channel on its own.
+  const unsigned int numberOfChannelsToTest[] = {3, 5};
+  for(unsigned int test = 0; test < 2; ++test)
+  {
+    const unsigned int numberOfChannels = numberOfChannelsToTest[test];
+    std::vector<std::vector<float> > pixels(1000, std::vector<float>(numberOfChannels));
+    std::vector<std::vector<float> > channels(numberOfChannels, std::vector<float>(pixels.size()));
+    for(unsigned int i = 0; i < pixels.size(); ++i)
+    {
+      for(unsigned int channel = 0; channel < numberOfChannels; ++channel)
+      {
+        pixels[i][channel] = static_cast<float>(rand() % 256) + 100.0f * channel;
+        channels[channel][i] = pixels[i][channel];
+      }
+    }
+
+    std::vector<float> variance = Statistics::Variance(pixels);
+    if(variance.size() != numberOfChannels)
+    {
+      std::cerr << "TestMultiComponentVariance failed! Wrong number of channels." << std::endl;
+      return false;
+    }
+
+    for(unsigned int channel = 0; channel < numberOfChannels; ++channel)
+    {
+      float channelVariance = Statistics::Variance(channels[channel]);
+      if(fabs(variance[channel] - channelVariance) > 1e-4f * channelVariance)
+      {
+        std::cerr << "TestMultiComponentVariance failed! Channel " << channel << ": "
+                  << variance[channel] << " vs " << channelVariance << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool TestCovariance()
+{
+//  octave:1> x = [1 2 3; 2 4 1; 3 7 2; 4 8 5];
+//  octave:2> cov(x)
+//  ans =
+//     1.6667    3.5000    1.1667
+//     3.5000    7.5833    2.0833
+//     1.1667    2.0833    2.9167
+  std::vector<std::vector<float> > x = {{1, 2, 3}, {2, 4, 1}, {3, 7, 2}, {4, 8, 5}};
+  std::vector<std::vector<float> > correct = {{5.0f / 3.0f, 3.5f, 7.0f / 6.0f},
+                                              {3.5f, 91.0f / 12.0f, 25.0f / 12.0f},
+                                              {7.0f / 6.0f, 25.0f / 12.0f, 35.0f / 12.0f}};
+
+  std::vector<std::vector<float> > covariance = Statistics::Covariance(x);
+  for(unsigned int a = 0; a < 3; ++a)
+  {
+    for(unsigned int b = 0; b < 3; ++b)
+    {
+      if(fabs(covariance[a][b] - correct[a][b]) > 1e-5f)
+      {
+        std::cerr << "TestCovariance failed! Element (" << a << ", " << b << "): " << covariance[a][b] << std::endl;
+        return false;
+      }
+    }
+  }
+
+  // More elements than a tile, split across threads, with values far from 0.
+  std::vector<std::vector<float> > pixels(300000, std::vector<float>(5));
+  for(unsigned int i = 0; i < pixels.size(); ++i)
+  {
+    for(unsigned int channel = 0; channel < 5; ++channel)
+    {
+      pixels[i][channel] = 1000.0f + static_cast<float>(rand() % 256) + (channel > 0 ? pixels[i][channel - 1] : 0.0f);
+    }
+  }
+
+  std::vector<std::vector<float> > serial = Statistics::Covariance(pixels);
+  std::vector<std::vector<float> > parallel = Statistics::Covariance(pixels, 4);
+  std::vector<float> variance = Statistics::Variance(pixels);
+  for(unsigned int a = 0; a < 5; ++a)
+  {
+    for(unsigned int b = 0; b < 5; ++b)
+    {
+      if(serial[a][b] != serial[b][a] || fabs(serial[a][b] - parallel[a][b]) > 1e-4f * fabs(serial[a][b]))
+      {
+        std::cerr << "TestCovariance failed! Parallel element (" << a << ", " << b << "): "
+                  << serial[a][b] << " vs " << parallel[a][b] << std::endl;
+        return false;
+      }
+    }
+
+    if(fabs(serial[a][a] - variance[a]) > 1e-4f * variance[a])
+    {
+      std::cerr << "TestCovariance failed! The diagonal does not match Variance." << std::endl;
+      return false;
+    }
+  }
+
   return true;
 }
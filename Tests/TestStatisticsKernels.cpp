@@ -0,0 +1,176 @@
+#include "StatisticsKernels.h"
+#include "Statistics.h"
+#include "Helpers.h"
+
+// STL
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+static bool TestInstructionSets();
+static bool TestByteAccumulation();
+static bool TestAverageAndVariance();
+
+/** Compare the kernels for every supported instruction set to the generic version on a vector
+  * whose length is not a multiple of any vector width (so the tails are exercised). */
+template <typename T>
+static bool MatchesGeneric(const std::vector<T>& v);
+
+int main()
+{
+  std::cout << "Supported instruction set: "
+            << Statistics::GetKernelInstructionSetName(Statistics::GetSupportedKernelInstructionSet()) << std::endl;
+
+  bool allPass = true;
+
+  allPass &= TestInstructionSets();
+  allPass &= TestByteAccumulation();
+  allPass &= TestAverageAndVariance();
+
+  if(allPass)
+  {
+    return EXIT_SUCCESS;
+  }
+  else
+  {
+    return EXIT_FAILURE;
+  }
+}
+
+static bool RelativelyEqual(const double a, const double b, const double tolerance)
+{
+  return std::abs(a - b) <= tolerance * std::max(1.0, std::max(std::abs(a), std::abs(b)));
+}
+
+template <typename T>
+bool MatchesGeneric(const std::vector<T>& v)
+{
+  Statistics::SetKernelInstructionSet(Statistics::GENERIC_INSTRUCTIONS);
+  const double genericSum = Statistics::Sum(v.data(), v.size());
+  const double genericSumOfSquares = Statistics::SumOfSquares(v.data(), v.size());
+  double genericMean = 0.0;
+  double genericVariance = 0.0;
+  Statistics::MeanAndVariance(v.data(), v.size(), genericMean, genericVariance);
+
+  bool pass = true;
+  for(int instructionSet = Statistics::SSE2_INSTRUCTIONS;
+      instructionSet <= Statistics::GetSupportedKernelInstructionSet(); ++instructionSet)
+  {
+    Statistics::SetKernelInstructionSet(static_cast<Statistics::KernelInstructionSet>(instructionSet));
+
+    double mean = 0.0;
+    double variance = 0.0;
+    Statistics::MeanAndVariance(v.data(), v.size(), mean, variance);
+
+    if(!RelativelyEqual(Statistics::Sum(v.data(), v.size()), genericSum, 1e-12) ||
+       !RelativelyEqual(Statistics::SumOfSquares(v.data(), v.size()), genericSumOfSquares, 1e-12) ||
+       !RelativelyEqual(mean, genericMean, 1e-12) ||
+       !RelativelyEqual(variance, genericVariance, 1e-9))
+    {
+      std::cerr << Statistics::GetKernelInstructionSetName(Statistics::GetKernelInstructionSet())
+                << " does not match the generic kernel! mean: " << mean << " vs " << genericMean
+                << " variance: " << variance << " vs " << genericVariance << std::endl;
+      pass = false;
+    }
+  }
+
+  Statistics::SetKernelInstructionSet(Statistics::GetSupportedKernelInstructionSet());
+  return pass;
+}
+
+bool TestInstructionSets()
+{
+  const unsigned int length = 1003;
+
+  std::vector<float> floats(length);
+  std::vector<double> doubles(length);
+  std::vector<unsigned char> chars(length);
+  std::vector<unsigned short> shorts(length);
+  std::vector<int> ints(length);
+  for(unsigned int i = 0; i < length; ++i)
+  {
+    floats[i] = 1000.0f + static_cast<float>(rand() % 1000) / 100.0f;
+    doubles[i] = -5.0 + static_cast<double>(rand() % 10000) / 1000.0;
+    chars[i] = static_cast<unsigned char>(rand() % 256);
+    shorts[i] = static_cast<unsigned short>(rand() % 65536);
+    ints[i] = rand() % 20001 - 10000;
+  }
+
+  bool pass = true;
+  pass &= MatchesGeneric(floats);
+  pass &= MatchesGeneric(doubles);
+  pass &= MatchesGeneric(chars);
+  pass &= MatchesGeneric(shorts);
+  pass &= MatchesGeneric(ints);
+
+  // Lengths shorter than one vector only use the tail loop.
+  pass &= MatchesGeneric(std::vector<float>(floats.begin(), floats.begin() + 3));
+  pass &= MatchesGeneric(std::vector<unsigned char>(chars.begin(), chars.begin() + 7));
+
+  if(!pass)
+  {
+    std::cerr << "TestInstructionSets failed!" << std::endl;
+  }
+
+  return pass;
+}
+
+bool TestByteAccumulation()
+{
+  // Enough 255s that the 32 bit lanes of the vectorized kernels would overflow if they were not flushed.
+  const size_t length = 20000000;
+  std::vector<unsigned char> v(length, 255);
+
+  bool pass = true;
+  for(int instructionSet = Statistics::GENERIC_INSTRUCTIONS;
+      instructionSet <= Statistics::GetSupportedKernelInstructionSet(); ++instructionSet)
+  {
+    Statistics::SetKernelInstructionSet(static_cast<Statistics::KernelInstructionSet>(instructionSet));
+
+    const double sum = Statistics::Sum(v.data(), v.size());
+    const double sumOfSquares = Statistics::SumOfSquares(v.data(), v.size());
+    if(sum != 255.0 * length || sumOfSquares != 255.0 * 255.0 * length)
+    {
+      std::cerr << "TestByteAccumulation failed for "
+                << Statistics::GetKernelInstructionSetName(Statistics::GetKernelInstructionSet())
+                << "! sum: " << sum << " sum of squares: " << sumOfSquares << std::endl;
+      pass = false;
+    }
+  }
+
+  Statistics::SetKernelInstructionSet(Statistics::GetSupportedKernelInstructionSet());
+  return pass;
+}
+
+bool TestAverageAndVariance()
+{
+//  octave:1> v = [1,10,4];
+//  octave:2> mean(v)
+//  ans =  5
+//  octave:3> var(v)
+//  ans =  21
+
+  std::vector<float> floats = {1.0f, 10.0f, 4.0f};
+  std::vector<unsigned char> chars = {1, 10, 4};
+
+  if(!Helpers::FuzzyCompare(Statistics::Average(floats), 5.0f, 1e-6f) ||
+     !Helpers::FuzzyCompare(Statistics::Variance(floats), 21.0f, 1e-5f) ||
+     !Helpers::FuzzyCompare(Statistics::Average(chars), 5.0f, 1e-6f) ||
+     !Helpers::FuzzyCompare(Statistics::Variance(chars), 21.0f, 1e-5f))
+  {
+    std::cerr << "TestAverageAndVariance failed!" << std::endl;
+    return false;
+  }
+
+  // A large offset makes the textbook sum of squares formula cancel catastrophically;
+  // the kernels compute relative to the first element, so they must not.
+  std::vector<double> offset = {1e9 + 1.0, 1e9 + 10.0, 1e9 + 4.0};
+  if(!Helpers::FuzzyCompare(Statistics::Variance(offset), 21.0, 1e-6))
+  {
+    std::cerr << "TestAverageAndVariance failed! Offset variance: " << Statistics::Variance(offset) << std::endl;
+    return false;
+  }
+
+  return true;
+}
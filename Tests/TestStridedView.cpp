@@ -0,0 +1,186 @@
+#include "StridedView.h"
+#include "Statistics.h"
+#include "Helpers.h"
+
+// STL
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+static bool TestChannelView();
+static bool TestRegionView();
+static bool TestInterleavedAndPlanar();
+static bool TestTypeTraits();
+
+int main()
+{
+  bool allPass = true;
+
+  allPass &= TestChannelView();
+  allPass &= TestRegionView();
+  allPass &= TestInterleavedAndPlanar();
+  allPass &= TestTypeTraits();
+
+  if(allPass)
+  {
+    return EXIT_SUCCESS;
+  }
+  else
+  {
+    return EXIT_FAILURE;
+  }
+}
+
+bool TestChannelView()
+{
+  // Interleaved RGB pixels; the G channel is {1, 10, 4}.
+  //  octave:1> v = [1,10,4];
+  //  octave:2> mean(v)
+  //  ans =  5
+  //  octave:3> var(v)
+  //  ans =  21
+  const std::vector<float> rgb = {0, 1, 2,   3, 10, 5,   6, 4, 8};
+  Helpers::StridedView<const float> green = Helpers::MakeChannelView(rgb.data(), 3, 3, 1);
+
+  if(green.size() != 3 || Helpers::length(green) != 3 || green[1] != 10.0f ||
+     !Helpers::FuzzyCompare(Statistics::Average(green), 5.0f, 1e-6f) ||
+     !Helpers::FuzzyCompare(Statistics::Variance(green), 21.0f, 1e-5f) ||
+     !Helpers::FuzzyCompare(Statistics::Variance(green, 2), 21.0f, 1e-5f) ||
+     Helpers::Min(green) != 1.0f || Helpers::Max(green) != 10.0f ||
+     Helpers::Argmin(green) != 0 || Helpers::Argmax(green) != 1 ||
+     Helpers::Sum(green.begin(), green.end()) != 15.0f)
+  {
+    std::cerr << "TestChannelView failed!" << std::endl;
+    return false;
+  }
+
+  // Writing through a view modifies the buffer.
+  std::vector<unsigned char> samples = {1, 2, 3, 4, 5, 6};
+  Helpers::StridedView<unsigned char> everyOther = Helpers::MakeStridedView(samples.data(), 3, 2);
+  everyOther[2] = 7;
+  if(samples[4] != 7 || !Helpers::FuzzyCompare(Statistics::Average(everyOther), 11.0f / 3.0f, 1e-6f))
+  {
+    std::cerr << "TestChannelView failed! Writing through a view did not modify the buffer." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestRegionView()
+{
+  // A 4x3 image; the 2x2 region starting at (1, 1) is {5, 6, 9, 10}.
+  std::vector<int> image(12);
+  for(unsigned int i = 0; i < image.size(); ++i)
+  {
+    image[i] = i;
+  }
+
+  Helpers::StridedView<int> region = Helpers::MakeRegionView(image.data(), 4, 1, 1, 2, 2);
+  std::vector<int> copy(region.begin(), region.end());
+  const std::vector<int> correct = {5, 6, 9, 10};
+
+  //  octave:1> var([5, 6, 9, 10])
+  //  ans =  5.6667
+  if(copy != correct || region.IsContiguous() ||
+     !Helpers::FuzzyCompare(Statistics::Average(region), 7.5f, 1e-6f) ||
+     !Helpers::FuzzyCompare(Statistics::Variance(region), 17.0f / 3.0f, 1e-5f))
+  {
+    std::cerr << "TestRegionView failed!" << std::endl;
+    return false;
+  }
+
+  // Sorting through the iterators (as VectorMedian does) reorders the region in place.
+  std::sort(region.begin(), region.end(), [](int a, int b) { return a > b; });
+  if(image[5] != 10 || image[6] != 9 || image[9] != 6 || image[10] != 5 || image[7] != 7)
+  {
+    std::cerr << "TestRegionView failed! Sorting did not reorder the region." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestInterleavedAndPlanar()
+{
+//  octave:1> x = [1 2 3; 2 4 1; 3 7 2; 4 8 5];
+//  octave:2> var(x)
+//  ans = 1.6667   7.5833   2.9167
+  std::vector<std::vector<float> > pixels = {{1, 2, 3}, {2, 4, 1}, {3, 7, 2}, {4, 8, 5}};
+
+  std::vector<float> interleaved;
+  std::vector<float> planar(12);
+  for(unsigned int i = 0; i < pixels.size(); ++i)
+  {
+    for(unsigned int channel = 0; channel < 3; ++channel)
+    {
+      interleaved.push_back(pixels[i][channel]);
+      planar[channel * pixels.size() + i] = pixels[i][channel];
+    }
+  }
+
+  Helpers::StridedPixelView<float> interleavedView = Helpers::MakeInterleavedView(interleaved.data(), 4, 3);
+  Helpers::StridedPixelView<float> planarView = Helpers::MakePlanarView(planar.data(), 4, 3);
+
+  const std::vector<float> correctVariance = {5.0f / 3.0f, 91.0f / 12.0f, 35.0f / 12.0f};
+  const std::vector<std::vector<float> > correctCovariance = Statistics::Covariance(pixels);
+
+  bool pass = true;
+  const Helpers::StridedPixelView<float> views[] = {interleavedView, planarView};
+  for(unsigned int i = 0; i < 2; ++i)
+  {
+    std::vector<float> variance = Statistics::Variance(views[i]);
+    std::vector<float> parallelVariance = Statistics::Variance(views[i], 3);
+    std::vector<std::vector<float> > covariance = Statistics::Covariance(views[i]);
+    pass &= Helpers::length(views[i][2]) == 3 && views[i][2][1] == 7.0f;
+    pass &= Helpers::FuzzyCompare(variance, correctVariance, 1e-5f);
+    pass &= Helpers::FuzzyCompare(parallelVariance, correctVariance, 1e-5f);
+    for(unsigned int channel = 0; channel < 3; ++channel)
+    {
+      pass &= Helpers::FuzzyCompare(covariance[channel], correctCovariance[channel], 1e-5f);
+    }
+  }
+
+  // A channel of a pixel view is a scalar view.
+  pass &= Helpers::FuzzyCompare(Statistics::Variance(planarView.GetChannel(2)), 35.0f / 12.0f, 1e-5f);
+
+  // The 2x1 region starting at (1, 0) of a 2x2 image made from the same pixels is {2, 4, 1}, {4, 8, 5}.
+  Helpers::StridedPixelView<float> interleavedRegion =
+      Helpers::MakeInterleavedRegionView(interleaved.data(), 2, 3, 1, 0, 1, 2);
+  Helpers::StridedPixelView<float> planarRegion =
+      Helpers::MakePlanarRegionView(planar.data(), 2, 2, 3, 1, 0, 1, 2);
+  const std::vector<float> correctRegionVariance = {2.0f, 8.0f, 8.0f};
+  pass &= Helpers::FuzzyCompare(std::vector<float>(Statistics::Variance(interleavedRegion)),
+                                correctRegionVariance, 1e-5f);
+  pass &= Helpers::FuzzyCompare(std::vector<float>(Statistics::Variance(planarRegion)),
+                                correctRegionVariance, 1e-5f);
+
+  if(!pass)
+  {
+    std::cerr << "TestInterleavedAndPlanar failed!" << std::endl;
+  }
+
+  return pass;
+}
+
+bool TestTypeTraits()
+{
+  // Averages and variances of byte views (and of byte pixels) are not truncated to bytes.
+  bool pass = true;
+  pass &= std::is_same<TypeTraits<Helpers::StridedView<const unsigned char> >::LargerComponentType, float>::value;
+  pass &= std::is_same<TypeTraits<Helpers::StridedView<const unsigned char> >::ComponentType, unsigned char>::value;
+  pass &= std::is_same<TypeTraits<Helpers::StridedPixelView<unsigned char> >::LargerComponentType,
+                       std::vector<float> >::value;
+
+  std::vector<unsigned char> rgb = {10, 20, 30, 20, 40, 60};
+  std::vector<float> variance = Statistics::Variance(Helpers::MakeInterleavedView(rgb.data(), 2, 3));
+  pass &= Helpers::FuzzyCompare(variance, std::vector<float>({50.0f, 200.0f, 450.0f}), 1e-4f);
+
+  if(!pass)
+  {
+    std::cerr << "TestTypeTraits failed!" << std::endl;
+  }
+
+  return pass;
+}
@@ -0,0 +1,187 @@
+#include "Summation.h"
+#include "Helpers.h"
+
+// STL
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <vector>
+
+static bool TestAccuracy();
+static bool TestIterators();
+static bool TestIntegers();
+static bool TestThreads();
+
+int main()
+{
+  bool allPass = true;
+
+  allPass &= TestAccuracy();
+  allPass &= TestIterators();
+  allPass &= TestIntegers();
+  allPass &= TestThreads();
+
+  if(allPass)
+  {
+    return EXIT_SUCCESS;
+  }
+  else
+  {
+    return EXIT_FAILURE;
+  }
+}
+
+bool TestAccuracy()
+{
+  // 0.1f is not exactly representable, so every addition of a single running float sum rounds; after
+  // 2^24 of them the running sum is far from the exact value. The exact sum of these float values
+  // is computed in double (which has enough bits to hold it exactly).
+  const size_t length = 1 << 24;
+  std::vector<float> v(length, 0.1f);
+  const double exact = static_cast<double>(0.1f) * static_cast<double>(length);
+
+  float naive = 0.0f;
+  for(size_t i = 0; i < length; ++i)
+  {
+    naive += v[i];
+  }
+
+  const float pairwise = Helpers::AccumulateSum<float>(v.begin(), v.end(), Helpers::SUMMATION_PAIRWISE);
+  const float compensated = Helpers::AccumulateSum<float>(v.begin(), v.end(), Helpers::SUMMATION_COMPENSATED);
+  const double pairwiseDouble = Helpers::Sum(v.begin(), v.end());
+
+  const double naiveError = std::abs(naive - exact) / exact;
+  const double pairwiseError = std::abs(pairwise - exact) / exact;
+  const double compensatedError = std::abs(compensated - exact) / exact;
+  const double pairwiseDoubleError = std::abs(pairwiseDouble - exact) / exact;
+
+  if(naiveError < 1e-2 || pairwiseError > 1e-6 || compensatedError > 1e-7 || pairwiseDoubleError > 1e-15)
+  {
+    std::cerr << "TestAccuracy failed! Relative errors: naive " << naiveError << " pairwise " << pairwiseError
+              << " compensated " << compensatedError << " pairwise (double) " << pairwiseDoubleError << std::endl;
+    return false;
+  }
+
+  // Values that cancel: a compensated sum recovers the small values that a plain sum loses entirely.
+  std::vector<double> cancelling = {1.0, 1e100, 1.0, -1e100};
+  if(Helpers::Sum(cancelling.begin(), cancelling.end(), Helpers::SUMMATION_COMPENSATED) != 2.0)
+  {
+    std::cerr << "TestAccuracy failed! The compensated sum of {1, 1e100, 1, -1e100} is "
+              << Helpers::Sum(cancelling.begin(), cancelling.end(), Helpers::SUMMATION_COMPENSATED) << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestIterators()
+{
+  // Lengths around the lane and block sizes exercise the tails.
+  const unsigned int lengths[] = {0, 1, 7, 8, 9, 127, 128, 129, 1000, 100000};
+  for(unsigned int i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i)
+  {
+    std::vector<double> v(lengths[i]);
+    double exact = 0.0;
+    for(unsigned int j = 0; j < v.size(); ++j)
+    {
+      v[j] = j % 17; // Small integers, so every ordering of the additions is exact.
+      exact += v[j];
+    }
+
+    std::list<double> l(v.begin(), v.end());
+    const double* data = v.data();
+
+    if(Helpers::Sum(v.begin(), v.end()) != exact || Helpers::Sum(l.begin(), l.end()) != exact ||
+       Helpers::Sum(data, data + v.size()) != exact ||
+       Helpers::Sum(l.begin(), l.end(), Helpers::SUMMATION_COMPENSATED) != exact ||
+       Helpers::Sum(v.begin(), v.end(), Helpers::SUMMATION_COMPENSATED) != exact)
+    {
+      std::cerr << "TestIterators failed for length " << lengths[i] << "!" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool TestIntegers()
+{
+  // Enough values that the 32 bit block accumulators would overflow if the blocks were too long.
+  std::vector<unsigned short> shorts(200000, 65535);
+  std::vector<short> negativeShorts(200000, -32768);
+  std::list<unsigned char> chars(1000, 255);
+
+  if(Helpers::Sum(shorts.begin(), shorts.end()) != 65535ull * 200000ull ||
+     Helpers::Sum(negativeShorts.begin(), negativeShorts.end()) != -32768ll * 200000ll ||
+     Helpers::Sum(chars.begin(), chars.end()) != 255000u ||
+     Helpers::AccumulateSum<std::int64_t>(shorts.begin(), shorts.end()) != 65535ll * 200000ll)
+  {
+    std::cerr << "TestIntegers failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestThreads()
+{
+  // Lengths that are and are not a whole number of blocks and chunks.
+  const size_t lengths[] = {Helpers::MinimumParallelLength, 1000037, 1 << 20};
+  const unsigned int threadCounts[] = {2, 3, 7, 16};
+
+  for(size_t length : lengths)
+  {
+    std::vector<float> floats(length);
+    std::vector<int> ints(length);
+    for(size_t i = 0; i < length; ++i)
+    {
+      floats[i] = static_cast<float>(rand()) / RAND_MAX * 1000.0f - 100.0f;
+      ints[i] = rand() - RAND_MAX / 2;
+    }
+
+    const double pairwise = Helpers::AccumulateSum<double>(floats.begin(), floats.end(), Helpers::SUMMATION_PAIRWISE);
+    const float pairwiseFloat = Helpers::AccumulateSum<float>(floats.begin(), floats.end(),
+                                                              Helpers::SUMMATION_PAIRWISE);
+    const double compensated = Helpers::AccumulateSum<double>(floats.begin(), floats.end(),
+                                                              Helpers::SUMMATION_COMPENSATED);
+    const int64_t integer = Helpers::AccumulateSum<int64_t>(ints.begin(), ints.end());
+
+    for(unsigned int numberOfThreads : threadCounts)
+    {
+      // Pairwise and integer sums must be bit for bit the same as the serial ones.
+      if(Helpers::AccumulateSum<double>(floats.begin(), floats.end(), Helpers::SUMMATION_PAIRWISE,
+                                        numberOfThreads) != pairwise ||
+         Helpers::AccumulateSum<float>(floats.begin(), floats.end(), Helpers::SUMMATION_PAIRWISE,
+                                       numberOfThreads) != pairwiseFloat ||
+         Helpers::AccumulateSum<int64_t>(ints.begin(), ints.end(), Helpers::SUMMATION_PAIRWISE,
+                                         numberOfThreads) != integer)
+      {
+        std::cerr << "TestThreads failed! The threaded sum of " << length << " values with "
+                  << numberOfThreads << " threads does not match the serial one." << std::endl;
+        return false;
+      }
+
+      const double threadedCompensated = Helpers::AccumulateSum<double>(floats.begin(), floats.end(),
+                                                                        Helpers::SUMMATION_COMPENSATED,
+                                                                        numberOfThreads);
+      if(std::abs(threadedCompensated - compensated) > 1e-15 * std::abs(compensated))
+      {
+        std::cerr << "TestThreads failed! Compensated: " << threadedCompensated << " vs " << compensated << std::endl;
+        return false;
+      }
+    }
+  }
+
+  // Other iterators are summed on the calling thread.
+  std::list<double> values(Helpers::MinimumParallelLength, 0.5);
+  if(Helpers::AccumulateSum<double>(values.begin(), values.end(), Helpers::SUMMATION_PAIRWISE, 4) !=
+     0.5 * Helpers::MinimumParallelLength)
+  {
+    std::cerr << "TestThreads failed for a list!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,239 @@
+#include "ValidityScan.h"
+#include "StatisticsKernels.h"
+
+// STL
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+static bool TestInstructionSets();
+static bool TestThreads();
+static bool TestMask();
+static bool TestEmpty();
+
+/** Compare every scan of 'v' to a scalar scan, for every kind of invalid value. */
+template <typename T>
+static bool MatchesScalar(const std::vector<T>& v, const unsigned int numberOfThreads);
+
+/** Make a buffer of random values with NaNs, infinities and other special values at random positions. */
+template <typename T>
+static std::vector<T> MakeBuffer(const size_t length, const size_t numberOfSpecialValues);
+
+int main()
+{
+  bool allPass = true;
+
+  allPass &= TestInstructionSets();
+  allPass &= TestThreads();
+  allPass &= TestMask();
+  allPass &= TestEmpty();
+
+  if(allPass)
+  {
+    return EXIT_SUCCESS;
+  }
+  else
+  {
+    return EXIT_FAILURE;
+  }
+}
+
+template <typename T>
+static bool IsInvalid(const T value, const Helpers::InvalidValueKind kind)
+{
+  return ((kind & Helpers::INVALID_NAN) && std::isnan(value)) ||
+         ((kind & Helpers::INVALID_INFINITY) && std::isinf(value));
+}
+
+template <typename T>
+std::vector<T> MakeBuffer(const size_t length, const size_t numberOfSpecialValues)
+{
+  const T specialValues[] = {std::numeric_limits<T>::quiet_NaN(), -std::numeric_limits<T>::quiet_NaN(),
+                             std::numeric_limits<T>::infinity(), -std::numeric_limits<T>::infinity(),
+                             std::numeric_limits<T>::max(), -std::numeric_limits<T>::max(),
+                             std::numeric_limits<T>::denorm_min(), static_cast<T>(-0.0)};
+  const size_t numberOfKinds = sizeof(specialValues) / sizeof(T);
+
+  std::vector<T> v(length);
+  for(size_t i = 0; i < length; ++i)
+  {
+    v[i] = static_cast<T>(rand()) / RAND_MAX - static_cast<T>(0.5);
+  }
+  for(size_t i = 0; i < numberOfSpecialValues && length > 0; ++i)
+  {
+    v[rand() % length] = specialValues[i % numberOfKinds];
+  }
+  return v;
+}
+
+template <typename T>
+bool MatchesScalar(const std::vector<T>& v, const unsigned int numberOfThreads)
+{
+  const Helpers::InvalidValueKind kinds[] = {Helpers::INVALID_NAN, Helpers::INVALID_INFINITY,
+                                             Helpers::INVALID_NON_FINITE};
+  for(Helpers::InvalidValueKind kind : kinds)
+  {
+    size_t expectedCount = 0;
+    for(size_t i = 0; i < v.size(); ++i)
+    {
+      expectedCount += IsInvalid(v[i], kind);
+    }
+
+    if(Helpers::ContainsInvalid(v.data(), v.size(), kind, numberOfThreads) != (expectedCount > 0) ||
+       Helpers::CountInvalid(v.data(), v.size(), kind, numberOfThreads) != expectedCount)
+    {
+      std::cerr << "The scan of " << v.size() << " values for kind " << kind << " with " << numberOfThreads
+                << " threads found " << Helpers::CountInvalid(v.data(), v.size(), kind, numberOfThreads)
+                << " invalid values rather than " << expectedCount << "!" << std::endl;
+      return false;
+    }
+
+    // Fill the bitmap with garbage first, to check that every bit (including those past the end) is written.
+    std::vector<uint64_t> bitmap(Helpers::GetNumberOfValidityWords(v.size()), 0x5555555555555555ULL);
+    const size_t numberOfValid = Helpers::ComputeValidityBitmap(v.data(), v.size(), kind, bitmap.data(),
+                                                                numberOfThreads);
+    if(numberOfValid != v.size() - expectedCount)
+    {
+      std::cerr << "The bitmap has " << numberOfValid << " valid values rather than "
+                << v.size() - expectedCount << "!" << std::endl;
+      return false;
+    }
+
+    for(size_t i = 0; i < 64 * bitmap.size(); ++i)
+    {
+      const bool expected = i < v.size() && !IsInvalid(v[i], kind);
+      if(((bitmap[i / 64] >> (i % 64)) & 1) != expected)
+      {
+        std::cerr << "Bit " << i << " of the bitmap for kind " << kind << " is wrong!" << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool TestInstructionSets()
+{
+  bool pass = true;
+  for(int instructionSet = Statistics::GENERIC_INSTRUCTIONS;
+      instructionSet <= Statistics::GetSupportedKernelInstructionSet(); ++instructionSet)
+  {
+    Statistics::SetKernelInstructionSet(static_cast<Statistics::KernelInstructionSet>(instructionSet));
+
+    // Lengths that do not fill the last word, and one that is exactly one word, so that the partial
+    // words and the vector loops are both exercised.
+    pass &= MatchesScalar(MakeBuffer<float>(1003, 40), 1);
+    pass &= MatchesScalar(MakeBuffer<double>(1003, 40), 1);
+    pass &= MatchesScalar(MakeBuffer<float>(64, 3), 1);
+    pass &= MatchesScalar(MakeBuffer<double>(7, 2), 1);
+    pass &= MatchesScalar(MakeBuffer<float>(10000, 0), 1);
+
+    // A single NaN in the last element of a word.
+    std::vector<double> lastInWord(128, 1.0);
+    lastInWord[63] = std::numeric_limits<double>::quiet_NaN();
+    pass &= MatchesScalar(lastInWord, 1);
+
+    if(!pass)
+    {
+      std::cerr << "TestInstructionSets failed for "
+                << Statistics::GetKernelInstructionSetName(Statistics::GetKernelInstructionSet()) << "!" << std::endl;
+      break;
+    }
+  }
+
+  Statistics::SetKernelInstructionSet(Statistics::GetSupportedKernelInstructionSet());
+  return pass;
+}
+
+bool TestThreads()
+{
+  const std::vector<float> floats = MakeBuffer<float>(1000037, 100);
+  const std::vector<double> doubles = MakeBuffer<double>(1000037, 3);
+
+  // A buffer whose only NaN is at the very end.
+  std::vector<float> lastIsNaN(1000037, 1.0f);
+  lastIsNaN.back() = std::numeric_limits<float>::quiet_NaN();
+
+  const unsigned int threadCounts[] = {1, 3, 7};
+  bool pass = true;
+  for(unsigned int numberOfThreads : threadCounts)
+  {
+    pass &= MatchesScalar(floats, numberOfThreads);
+    pass &= MatchesScalar(doubles, numberOfThreads);
+    pass &= MatchesScalar(lastIsNaN, numberOfThreads);
+  }
+
+  if(!pass)
+  {
+    std::cerr << "TestThreads failed!" << std::endl;
+  }
+
+  return pass;
+}
+
+bool TestMask()
+{
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const double infinity = std::numeric_limits<double>::infinity();
+  const std::vector<double> a = {1.0, nan, 2.0, 4.0, infinity, 8.0};
+  const std::vector<double> b = {1.0, 1.0, nan, 1.0, 1.0, 1.0};
+
+  Helpers::ValidityBitmap mask(a.data(), a.size(), Helpers::INVALID_NON_FINITE);
+  if(mask.size() != 6 || mask.GetNumberOfValid() != 4 || mask.GetNumberOfInvalid() != 2 ||
+     mask.IsValid(1) || !mask.IsValid(2) || Helpers::SumOfValid(a.data(), mask) != 15.0)
+  {
+    std::cerr << "TestMask failed! Sum of valid values: " << Helpers::SumOfValid(a.data(), mask) << std::endl;
+    return false;
+  }
+
+  // Only the elements that are valid in both buffers.
+  mask.And(Helpers::ValidityBitmap(b.data(), b.size(), Helpers::INVALID_NAN));
+  std::vector<size_t> validIndices;
+  Helpers::ForEachValidIndex(mask, [&validIndices](const size_t i) { validIndices.push_back(i); });
+  if(validIndices != std::vector<size_t>({0, 3, 5}) || mask.GetNumberOfValid() != 3 ||
+     Helpers::SumOfValid(a.data(), mask) != 13.0)
+  {
+    std::cerr << "TestMask failed after And!" << std::endl;
+    return false;
+  }
+
+  // A large buffer summed on several threads. The +-max values would swamp the rest of the sum.
+  std::vector<float> floats = MakeBuffer<float>(1000037, 100);
+  for(size_t i = 0; i < floats.size(); ++i)
+  {
+    if(std::abs(floats[i]) == std::numeric_limits<float>::max())
+    {
+      floats[i] = 0.5f;
+    }
+  }
+  Helpers::ValidityBitmap floatMask(floats.data(), floats.size(), Helpers::INVALID_NON_FINITE, 4);
+  double expectedSum = 0.0;
+  Helpers::ForEachValidIndex(floatMask, [&](const size_t i) { expectedSum += floats[i]; });
+  const double sum = Helpers::SumOfValid(floats.data(), floatMask, Helpers::SUMMATION_PAIRWISE, 4);
+  if(!std::isfinite(sum) || std::abs(sum - expectedSum) > 1e-9 * std::abs(expectedSum) + 1e-3 ||
+     sum != Helpers::SumOfValid(floats.data(), floatMask))
+  {
+    std::cerr << "TestMask failed! Sum: " << sum << " vs " << expectedSum << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TestEmpty()
+{
+  const std::vector<float> empty;
+  Helpers::ValidityBitmap mask(empty.data(), 0, Helpers::INVALID_NAN);
+  if(Helpers::ContainsInvalid(empty.data(), 0, Helpers::INVALID_NAN) ||
+     Helpers::CountInvalid(empty.data(), 0, Helpers::INVALID_NON_FINITE) != 0 ||
+     mask.size() != 0 || mask.GetNumberOfValid() != 0 || Helpers::SumOfValid(empty.data(), mask) != 0.0)
+  {
+    std::cerr << "TestEmpty failed!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
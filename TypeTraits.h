@@ -20,6 +20,8 @@
 #define TypeTraits_H
 
 // STL
+#include <cstdint>
+#include <type_traits>
 #include <vector>
 
 /** These traits allow us to determine the types of values for several kinds o
@@ -28,14 +30,43 @@
     We can also perform the same type of logic on the type of the components of a
     vector type.*/
 
+/** The type in which to accumulate a sum of T's (SumType below). Integers are summed exactly in 64 bit
+  * integers (float stops being exact after 2^24, while 2^48 16 bit values fit in 64 bits), and floating
+  * point values are summed in (at least) double. Other types (e.g. vectors) are summed in their own type. */
+template <class T, class Enable = void>
+struct DefaultSumType
+{
+  typedef T Type;
+};
+
+template <class T>
+struct DefaultSumType<T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type>
+{
+  typedef std::int64_t Type;
+};
+
+template <class T>
+struct DefaultSumType<T, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type>
+{
+  typedef std::uint64_t Type;
+};
+
+template <class T>
+struct DefaultSumType<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+{
+  typedef typename std::conditional<(sizeof(T) > sizeof(double)), T, double>::type Type;
+};
+
 /** For generic types (assume they are scalars). Specializations are needed
-  * for the cases in which they are not. */
+  * for the cases in which they are not. SumType is the type in which a sum of T's is accumulated;
+  * it is converted to LargerType (or whatever the result is) once, at the end. */
 template <class T>
 struct TypeTraits
 {
   typedef T LargerType;
   typedef T LargerComponentType;
   typedef T ComponentType;
+  typedef typename DefaultSumType<T>::Type SumType;
 };
 
 /** For unsigned char, use float as the LargerType. This is an explicit specialization -
@@ -46,6 +77,7 @@ struct TypeTraits<unsigned char>
   typedef float LargerType;
   typedef float LargerComponentType;
   typedef unsigned char ComponentType;
+  typedef DefaultSumType<unsigned char>::Type SumType;
 };
 
 /** For int, use float as the LargerType. This is an explicit specialization -
@@ -56,6 +88,7 @@ struct TypeTraits<int>
   typedef float LargerType;
   typedef float LargerComponentType;
   typedef int ComponentType;
+  typedef DefaultSumType<int>::Type SumType;
 };
 
 /** For unsigned int, use float as the LargerType. This is an explicit specialization -
@@ -66,6 +99,7 @@ struct TypeTraits<unsigned int>
   typedef float LargerType;
   typedef float LargerComponentType;
   typedef unsigned int ComponentType;
+  typedef DefaultSumType<unsigned int>::Type SumType;
 };
 
 /** For generic std::vector. This is a partial specialization (TypeTraits is still a template here),
@@ -76,6 +110,7 @@ struct TypeTraits<std::vector<T> >
   typedef std::vector<T> LargerType;
   typedef typename TypeTraits<T>::LargerType LargerComponentType;
   typedef T ComponentType;
+  typedef std::vector<typename TypeTraits<T>::SumType> SumType;
 };
 
 #endif
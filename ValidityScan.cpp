@@ -0,0 +1,545 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "ValidityScan.h"
+#include "Parallel.h"
+#include "StatisticsKernels.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+// As in StatisticsKernels.cpp, the vectorized kernels use target attributes so that they can be compiled
+// without -mavx2 etc. and only be called on CPUs that support them.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define VALIDITY_SCAN_X86
+#include <immintrin.h>
+#define KERNEL_TARGET(instructionSet) __attribute__((target(instructionSet)))
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#endif
+
+namespace Helpers
+{
+
+namespace
+{
+
+// Every kernel is instantiated for each kind of invalid value (TNaN, TInfinity), so that choosing the
+// comparison costs nothing inside the loops. A kernel computes one 64 bit mask per 64 elements, with
+// bit i set if element i is invalid.
+
+template <bool TNaN, bool TInfinity, typename T>
+inline bool IsInvalid(const T value)
+{
+  if(TNaN && TInfinity)
+  {
+    // Only false for NaN (comparisons with NaN are false) and infinities.
+    return !(std::abs(value) < std::numeric_limits<T>::infinity());
+  }
+  if(TNaN)
+  {
+    return value != value;
+  }
+  return std::abs(value) == std::numeric_limits<T>::infinity();
+}
+
+/** The mask of the (up to 64) elements in [data, data + count). */
+template <bool TNaN, bool TInfinity, typename T>
+uint64_t GenericInvalidMask(const T* data, const size_t count)
+{
+  uint64_t mask = 0;
+  for(size_t i = 0; i < count; ++i)
+  {
+    mask |= static_cast<uint64_t>(IsInvalid<TNaN, TInfinity>(data[i])) << i;
+  }
+  return mask;
+}
+
+template <bool TNaN, bool TInfinity, typename T>
+void GenericInvalidMasks(const T* data, const size_t numberOfWords, uint64_t* const masks)
+{
+  for(size_t word = 0; word < numberOfWords; ++word)
+  {
+    masks[word] = GenericInvalidMask<TNaN, TInfinity>(data + 64 * word, 64);
+  }
+}
+
+#ifdef VALIDITY_SCAN_X86
+
+// The SSE2, AVX2 and AVX-512 testers compare one vector of 4/2, 8/4 and 16/8 floats/doubles and return
+// one bit per element. NaN is the only value that is unordered with itself, and |x| is "not less than"
+// infinity for infinities and (being unordered) NaN.
+
+template <bool TNaN, bool TInfinity>
+KERNEL_TARGET("sse2") inline unsigned int SSE2InvalidBits(const float* data)
+{
+  const __m128 values = _mm_loadu_ps(data);
+  if(!TInfinity)
+  {
+    return _mm_movemask_ps(_mm_cmpunord_ps(values, values));
+  }
+
+  const __m128 magnitudes = _mm_and_ps(values, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+  const __m128 infinity = _mm_set1_ps(std::numeric_limits<float>::infinity());
+  return _mm_movemask_ps(TNaN ? _mm_cmpnlt_ps(magnitudes, infinity) : _mm_cmpeq_ps(magnitudes, infinity));
+}
+
+template <bool TNaN, bool TInfinity>
+KERNEL_TARGET("sse2") inline unsigned int SSE2InvalidBits(const double* data)
+{
+  const __m128d values = _mm_loadu_pd(data);
+  if(!TInfinity)
+  {
+    return _mm_movemask_pd(_mm_cmpunord_pd(values, values));
+  }
+
+  const __m128d magnitudes = _mm_and_pd(values, _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL)));
+  const __m128d infinity = _mm_set1_pd(std::numeric_limits<double>::infinity());
+  return _mm_movemask_pd(TNaN ? _mm_cmpnlt_pd(magnitudes, infinity) : _mm_cmpeq_pd(magnitudes, infinity));
+}
+
+template <bool TNaN, bool TInfinity>
+KERNEL_TARGET("avx2,fma") inline unsigned int AVX2InvalidBits(const float* data)
+{
+  const __m256 values = _mm256_loadu_ps(data);
+  if(!TInfinity)
+  {
+    return _mm256_movemask_ps(_mm256_cmp_ps(values, values, _CMP_UNORD_Q));
+  }
+
+  const __m256 magnitudes = _mm256_and_ps(values, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff)));
+  const __m256 infinity = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+  return _mm256_movemask_ps(TNaN ? _mm256_cmp_ps(magnitudes, infinity, _CMP_NLT_UQ) :
+                                   _mm256_cmp_ps(magnitudes, infinity, _CMP_EQ_OQ));
+}
+
+template <bool TNaN, bool TInfinity>
+KERNEL_TARGET("avx2,fma") inline unsigned int AVX2InvalidBits(const double* data)
+{
+  const __m256d values = _mm256_loadu_pd(data);
+  if(!TInfinity)
+  {
+    return _mm256_movemask_pd(_mm256_cmp_pd(values, values, _CMP_UNORD_Q));
+  }
+
+  const __m256d magnitudes = _mm256_and_pd(values,
+                                           _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL)));
+  const __m256d infinity = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+  return _mm256_movemask_pd(TNaN ? _mm256_cmp_pd(magnitudes, infinity, _CMP_NLT_UQ) :
+                                   _mm256_cmp_pd(magnitudes, infinity, _CMP_EQ_OQ));
+}
+
+template <bool TNaN, bool TInfinity>
+KERNEL_TARGET("avx512f,avx512bw") inline unsigned int AVX512InvalidBits(const float* data)
+{
+  const __m512 values = _mm512_loadu_ps(data);
+  if(!TInfinity)
+  {
+    return _mm512_cmp_ps_mask(values, values, _CMP_UNORD_Q);
+  }
+
+  const __m512 magnitudes = _mm512_abs_ps(values);
+  const __m512 infinity = _mm512_set1_ps(std::numeric_limits<float>::infinity());
+  return TNaN ? _mm512_cmp_ps_mask(magnitudes, infinity, _CMP_NLT_UQ) :
+                _mm512_cmp_ps_mask(magnitudes, infinity, _CMP_EQ_OQ);
+}
+
+template <bool TNaN, bool TInfinity>
+KERNEL_TARGET("avx512f,avx512bw") inline unsigned int AVX512InvalidBits(const double* data)
+{
+  const __m512d values = _mm512_loadu_pd(data);
+  if(!TInfinity)
+  {
+    return _mm512_cmp_pd_mask(values, values, _CMP_UNORD_Q);
+  }
+
+  const __m512d magnitudes = _mm512_abs_pd(values);
+  const __m512d infinity = _mm512_set1_pd(std::numeric_limits<double>::infinity());
+  return TNaN ? _mm512_cmp_pd_mask(magnitudes, infinity, _CMP_NLT_UQ) :
+                _mm512_cmp_pd_mask(magnitudes, infinity, _CMP_EQ_OQ);
+}
+
+// Each mask is assembled from the bits of 64 / width vectors (the inner loops are unrolled completely).
+
+template <bool TNaN, bool TInfinity, typename T>
+KERNEL_TARGET("sse2") void SSE2InvalidMasks(const T* data, const size_t numberOfWords, uint64_t* const masks)
+{
+  const size_t width = 16 / sizeof(T);
+  for(size_t word = 0; word < numberOfWords; ++word, data += 64)
+  {
+    uint64_t mask = 0;
+    for(size_t i = 0; i < 64; i += width)
+    {
+      mask |= static_cast<uint64_t>(SSE2InvalidBits<TNaN, TInfinity>(data + i)) << i;
+    }
+    masks[word] = mask;
+  }
+}
+
+template <bool TNaN, bool TInfinity, typename T>
+KERNEL_TARGET("avx2,fma") void AVX2InvalidMasks(const T* data, const size_t numberOfWords, uint64_t* const masks)
+{
+  const size_t width = 32 / sizeof(T);
+  for(size_t word = 0; word < numberOfWords; ++word, data += 64)
+  {
+    uint64_t mask = 0;
+    for(size_t i = 0; i < 64; i += width)
+    {
+      mask |= static_cast<uint64_t>(AVX2InvalidBits<TNaN, TInfinity>(data + i)) << i;
+    }
+    masks[word] = mask;
+  }
+}
+
+template <bool TNaN, bool TInfinity, typename T>
+KERNEL_TARGET("avx512f,avx512bw") void AVX512InvalidMasks(const T* data, const size_t numberOfWords,
+                                                          uint64_t* const masks)
+{
+  const size_t width = 64 / sizeof(T);
+  for(size_t word = 0; word < numberOfWords; ++word, data += 64)
+  {
+    uint64_t mask = 0;
+    for(size_t i = 0; i < 64; i += width)
+    {
+      mask |= static_cast<uint64_t>(AVX512InvalidBits<TNaN, TInfinity>(data + i)) << i;
+    }
+    masks[word] = mask;
+  }
+}
+#endif
+
+/** The kernels for one element type, kind of invalid value and instruction set: 'Words' computes the masks
+  * of whole words, and 'PartialWord' the mask of the last (partial) word of a buffer. */
+template <typename T>
+struct MaskKernels
+{
+  void (*Words)(const T* data, const size_t numberOfWords, uint64_t* const masks);
+  uint64_t (*PartialWord)(const T* data, const size_t count);
+};
+
+template <bool TNaN, bool TInfinity, typename T>
+MaskKernels<T> GetMaskKernels()
+{
+  MaskKernels<T> kernels;
+  kernels.Words = &GenericInvalidMasks<TNaN, TInfinity, T>;
+  kernels.PartialWord = &GenericInvalidMask<TNaN, TInfinity, T>;
+
+#ifdef VALIDITY_SCAN_X86
+  switch(Statistics::GetKernelInstructionSet())
+  {
+    case Statistics::AVX512_INSTRUCTIONS:
+      kernels.Words = &AVX512InvalidMasks<TNaN, TInfinity, T>;
+      break;
+    case Statistics::AVX2_INSTRUCTIONS:
+      kernels.Words = &AVX2InvalidMasks<TNaN, TInfinity, T>;
+      break;
+    case Statistics::SSE2_INSTRUCTIONS:
+      kernels.Words = &SSE2InvalidMasks<TNaN, TInfinity, T>;
+      break;
+    default:
+      break;
+  }
+#endif
+
+  return kernels;
+}
+
+/** Get the kernels for the active instruction set. */
+template <typename T>
+MaskKernels<T> GetMaskKernels(const InvalidValueKind kind)
+{
+  switch(kind)
+  {
+    case INVALID_NAN:
+      return GetMaskKernels<true, false, T>();
+    case INVALID_INFINITY:
+      return GetMaskKernels<false, true, T>();
+    case INVALID_NON_FINITE:
+      return GetMaskKernels<true, true, T>();
+    default:
+      throw std::runtime_error("GetMaskKernels: unknown kind of invalid value!");
+  }
+}
+
+inline size_t CountSetBits(const uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(word);
+#else
+  size_t count = 0;
+  for(uint64_t remaining = word; remaining != 0; remaining &= remaining - 1)
+  {
+    ++count;
+  }
+  return count;
+#endif
+}
+
+/** Compute the masks of the GetNumberOfValidityWords(length) words of a buffer. */
+template <typename T>
+void ComputeInvalidMasks(const MaskKernels<T>& kernels, const T* data, const size_t length, uint64_t* const masks)
+{
+  const size_t numberOfWholeWords = length / 64;
+  kernels.Words(data, numberOfWholeWords, masks);
+  if(length % 64 != 0)
+  {
+    masks[numberOfWholeWords] = kernels.PartialWord(data + 64 * numberOfWholeWords, length % 64);
+  }
+}
+
+/** The serial scans work through a buffer this many words at a time, so that the masks stay in cache
+  * (and ContainsInvalid can stop after the first piece with an invalid value). */
+const size_t WordsPerPiece = 64;
+
+template <typename T>
+bool SerialContainsInvalid(const MaskKernels<T>& kernels, const T* data, const size_t length)
+{
+  uint64_t masks[WordsPerPiece];
+  for(size_t pieceBegin = 0; pieceBegin < length; pieceBegin += 64 * WordsPerPiece)
+  {
+    const size_t pieceLength = std::min(64 * WordsPerPiece, length - pieceBegin);
+    ComputeInvalidMasks(kernels, data + pieceBegin, pieceLength, masks);
+
+    uint64_t anyInvalid = 0;
+    for(size_t word = 0; word < GetNumberOfValidityWords(pieceLength); ++word)
+    {
+      anyInvalid |= masks[word];
+    }
+    if(anyInvalid != 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+size_t SerialCountInvalid(const MaskKernels<T>& kernels, const T* data, const size_t length)
+{
+  uint64_t masks[WordsPerPiece];
+  size_t count = 0;
+  for(size_t pieceBegin = 0; pieceBegin < length; pieceBegin += 64 * WordsPerPiece)
+  {
+    const size_t pieceLength = std::min(64 * WordsPerPiece, length - pieceBegin);
+    ComputeInvalidMasks(kernels, data + pieceBegin, pieceLength, masks);
+
+    for(size_t word = 0; word < GetNumberOfValidityWords(pieceLength); ++word)
+    {
+      count += CountSetBits(masks[word]);
+    }
+  }
+  return count;
+}
+
+/** Fill in the bitmap of [data, data + length) and return the number of valid elements. */
+template <typename T>
+size_t SerialValidityBitmap(const MaskKernels<T>& kernels, const T* data, const size_t length,
+                            uint64_t* const bitmap)
+{
+  ComputeInvalidMasks(kernels, data, length, bitmap);
+
+  const size_t numberOfWords = GetNumberOfValidityWords(length);
+  size_t numberOfValid = 0;
+  for(size_t word = 0; word < numberOfWords; ++word)
+  {
+    bitmap[word] = ~bitmap[word];
+    numberOfValid += CountSetBits(bitmap[word]);
+  }
+
+  // The bits past the end of the buffer were set by the inversion.
+  if(length % 64 != 0)
+  {
+    const uint64_t pastEnd = ~((static_cast<uint64_t>(1) << (length % 64)) - 1);
+    numberOfValid -= CountSetBits(bitmap[numberOfWords - 1] & pastEnd);
+    bitmap[numberOfWords - 1] &= ~pastEnd;
+  }
+
+  return numberOfValid;
+}
+
+template <typename T>
+bool ContainsInvalidImplementation(const T* data, const size_t length, const InvalidValueKind kind,
+                                   const unsigned int numberOfThreads)
+{
+  const MaskKernels<T> kernels = GetMaskKernels<T>(kind);
+  const unsigned int numberOfBlocks = GetNumberOfThreads(numberOfThreads);
+  if(length < MinimumParallelLength || numberOfBlocks == 1)
+  {
+    return SerialContainsInvalid(kernels, data, length);
+  }
+
+  return ParallelAnyOf(length, numberOfBlocks, [&](const size_t begin, const size_t end)
+  {
+    return SerialContainsInvalid(kernels, data + begin, end - begin);
+  });
+}
+
+template <typename T>
+size_t CountInvalidImplementation(const T* data, const size_t length, const InvalidValueKind kind,
+                                  const unsigned int numberOfThreads)
+{
+  const MaskKernels<T> kernels = GetMaskKernels<T>(kind);
+  const unsigned int numberOfBlocks = GetNumberOfThreads(numberOfThreads);
+  if(length < MinimumParallelLength || numberOfBlocks == 1)
+  {
+    return SerialCountInvalid(kernels, data, length);
+  }
+
+  std::vector<size_t> blockCounts(numberOfBlocks, 0);
+  ParallelForBlocks(length, numberOfBlocks,
+                    [&](const size_t blockBegin, const size_t blockEnd, const unsigned int blockId)
+  {
+    blockCounts[blockId] = SerialCountInvalid(kernels, data + blockBegin, blockEnd - blockBegin);
+  });
+
+  size_t count = 0;
+  for(unsigned int blockId = 0; blockId < numberOfBlocks; ++blockId)
+  {
+    count += blockCounts[blockId];
+  }
+  return count;
+}
+
+template <typename T>
+size_t ValidityBitmapImplementation(const T* data, const size_t length, const InvalidValueKind kind,
+                                    uint64_t* const bitmap, const unsigned int numberOfThreads)
+{
+  const MaskKernels<T> kernels = GetMaskKernels<T>(kind);
+  const unsigned int numberOfBlocks = GetNumberOfThreads(numberOfThreads);
+  if(length < MinimumParallelLength || numberOfBlocks == 1)
+  {
+    return SerialValidityBitmap(kernels, data, length, bitmap);
+  }
+
+  // Split the buffer at word boundaries, so that every word of the bitmap is written by one thread.
+  const size_t numberOfWords = GetNumberOfValidityWords(length);
+  std::vector<size_t> blockCounts(numberOfBlocks, 0);
+  ParallelForBlocks(numberOfWords, numberOfBlocks,
+                    [&](const size_t blockBegin, const size_t blockEnd, const unsigned int blockId)
+  {
+    const size_t elementBegin = 64 * blockBegin;
+    const size_t elementEnd = std::min(64 * blockEnd, length);
+    blockCounts[blockId] = SerialValidityBitmap(kernels, data + elementBegin, elementEnd - elementBegin,
+                                                bitmap + blockBegin);
+  });
+
+  size_t numberOfValid = 0;
+  for(unsigned int blockId = 0; blockId < numberOfBlocks; ++blockId)
+  {
+    numberOfValid += blockCounts[blockId];
+  }
+  return numberOfValid;
+}
+
+} // end anonymous namespace
+
+bool ContainsInvalid(const float* data, const size_t length, const InvalidValueKind kind,
+                     const unsigned int numberOfThreads)
+{
+  return ContainsInvalidImplementation(data, length, kind, numberOfThreads);
+}
+
+bool ContainsInvalid(const double* data, const size_t length, const InvalidValueKind kind,
+                     const unsigned int numberOfThreads)
+{
+  return ContainsInvalidImplementation(data, length, kind, numberOfThreads);
+}
+
+size_t CountInvalid(const float* data, const size_t length, const InvalidValueKind kind,
+                    const unsigned int numberOfThreads)
+{
+  return CountInvalidImplementation(data, length, kind, numberOfThreads);
+}
+
+size_t CountInvalid(const double* data, const size_t length, const InvalidValueKind kind,
+                    const unsigned int numberOfThreads)
+{
+  return CountInvalidImplementation(data, length, kind, numberOfThreads);
+}
+
+size_t ComputeValidityBitmap(const float* data, const size_t length, const InvalidValueKind kind,
+                             uint64_t* const bitmap, const unsigned int numberOfThreads)
+{
+  return ValidityBitmapImplementation(data, length, kind, bitmap, numberOfThreads);
+}
+
+size_t ComputeValidityBitmap(const double* data, const size_t length, const InvalidValueKind kind,
+                             uint64_t* const bitmap, const unsigned int numberOfThreads)
+{
+  return ValidityBitmapImplementation(data, length, kind, bitmap, numberOfThreads);
+}
+
+ValidityBitmap::ValidityBitmap() : Length(0), NumberOfValid(0)
+{
+}
+
+ValidityBitmap::ValidityBitmap(const float* data, const size_t length, const InvalidValueKind kind,
+                               const unsigned int numberOfThreads) :
+  Words(GetNumberOfValidityWords(length)), Length(length)
+{
+  this->NumberOfValid = ComputeValidityBitmap(data, length, kind, this->Words.data(), numberOfThreads);
+}
+
+ValidityBitmap::ValidityBitmap(const double* data, const size_t length, const InvalidValueKind kind,
+                               const unsigned int numberOfThreads) :
+  Words(GetNumberOfValidityWords(length)), Length(length)
+{
+  this->NumberOfValid = ComputeValidityBitmap(data, length, kind, this->Words.data(), numberOfThreads);
+}
+
+void ValidityBitmap::And(const ValidityBitmap& other)
+{
+  if(other.Length != this->Length)
+  {
+    throw std::runtime_error("ValidityBitmap::And: the bitmaps have different lengths!");
+  }
+
+  this->NumberOfValid = 0;
+  for(size_t word = 0; word < this->Words.size(); ++word)
+  {
+    this->Words[word] &= other.Words[word];
+    this->NumberOfValid += CountSetBits(this->Words[word]);
+  }
+}
+
+size_t ValidityBitmap::size() const
+{
+  return this->Length;
+}
+
+size_t ValidityBitmap::GetNumberOfValid() const
+{
+  return this->NumberOfValid;
+}
+
+size_t ValidityBitmap::GetNumberOfInvalid() const
+{
+  return this->Length - this->NumberOfValid;
+}
+
+const std::vector<uint64_t>& ValidityBitmap::GetWords() const
+{
+  return this->Words;
+}
+
+} // end namespace
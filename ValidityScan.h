@@ -0,0 +1,141 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef ValidityScan_H
+#define ValidityScan_H
+
+// STL
+#include <cstddef> // for size_t
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Custom
+#include "Summation.h"
+
+/** Vectorized (SSE2/AVX2/AVX-512) scans of float and double buffers for NaN and/or infinite values.
+  * A scan can stop at the first invalid value (ContainsInvalid), count them (CountInvalid), or record
+  * which elements are valid in a packed bitmap (ComputeValidityBitmap, ValidityBitmap), which can then be
+  * used as a mask by other reductions (ForEachValidIndex, SumOfValid). The kernels use the instruction set
+  * selected for the Statistics kernels (see Statistics::SetKernelInstructionSet()).
+  * Scans of at least MinimumParallelLength elements are split over 'numberOfThreads' threads
+  * (0 means one per core) on the shared thread pool.
+  * The scans do not work if the code is compiled with -ffast-math, which assumes there are no NaNs or infinities.
+  */
+namespace Helpers
+{
+
+/** The values that a scan treats as invalid. */
+enum InvalidValueKind
+{
+  INVALID_NAN = 1,
+  INVALID_INFINITY = 2,
+  INVALID_NON_FINITE = INVALID_NAN | INVALID_INFINITY
+};
+
+/** Determine if any element of a buffer is invalid. The threads stop as soon as one finds an invalid value. */
+bool ContainsInvalid(const float* data, const size_t length, const InvalidValueKind kind,
+                     const unsigned int numberOfThreads = 1);
+bool ContainsInvalid(const double* data, const size_t length, const InvalidValueKind kind,
+                     const unsigned int numberOfThreads = 1);
+
+/** Count the invalid elements of a buffer. */
+size_t CountInvalid(const float* data, const size_t length, const InvalidValueKind kind,
+                    const unsigned int numberOfThreads = 1);
+size_t CountInvalid(const double* data, const size_t length, const InvalidValueKind kind,
+                    const unsigned int numberOfThreads = 1);
+
+/** Set bit (i % 64) of bitmap[i / 64] if element i of the buffer is valid, and clear it if it is not.
+  * 'bitmap' must have room for GetNumberOfValidityWords(length) words; the bits past 'length' in the last
+  * word are cleared. Returns the number of valid elements. */
+size_t ComputeValidityBitmap(const float* data, const size_t length, const InvalidValueKind kind,
+                             uint64_t* const bitmap, const unsigned int numberOfThreads = 1);
+size_t ComputeValidityBitmap(const double* data, const size_t length, const InvalidValueKind kind,
+                             uint64_t* const bitmap, const unsigned int numberOfThreads = 1);
+
+/** The number of 64 bit words in the validity bitmap of 'length' elements. */
+inline size_t GetNumberOfValidityWords(const size_t length)
+{
+  return (length + 63) / 64;
+}
+
+/** Which elements of a buffer are valid, packed 64 to a word as described for ComputeValidityBitmap. */
+class ValidityBitmap
+{
+public:
+  /** An empty bitmap. */
+  ValidityBitmap();
+
+  /** Scan 'data' for 'kind' of invalid values. */
+  ValidityBitmap(const float* data, const size_t length, const InvalidValueKind kind,
+                 const unsigned int numberOfThreads = 1);
+  ValidityBitmap(const double* data, const size_t length, const InvalidValueKind kind,
+                 const unsigned int numberOfThreads = 1);
+
+  /** Determine if element 'index' is valid. */
+  bool IsValid(const size_t index) const
+  {
+    return (this->Words[index / 64] >> (index % 64)) & 1;
+  }
+
+  /** Mark only the elements that are valid in both this bitmap and 'other' as valid (e.g. to find the pairs of
+    * elements of two buffers that are both valid). Throws if the bitmaps have different lengths. */
+  void And(const ValidityBitmap& other);
+
+  /** The number of elements (valid or not). */
+  size_t size() const;
+
+  size_t GetNumberOfValid() const;
+
+  size_t GetNumberOfInvalid() const;
+
+  /** The packed bits, GetNumberOfValidityWords(size()) of them. */
+  const std::vector<uint64_t>& GetWords() const;
+
+private:
+  std::vector<uint64_t> Words;
+  size_t Length;
+  size_t NumberOfValid;
+};
+
+/** Call functor(index) for the index of every valid element, in increasing order. */
+template <typename TFunctor>
+void ForEachValidIndex(const ValidityBitmap& mask, TFunctor functor);
+
+/** Sum the elements of 'data' that are valid in 'mask' (which must have been computed for a buffer of the same
+  * length) with AccumulateSum, in double precision. The invalid elements are summed as 0. */
+template <typename T>
+double SumOfValid(const T* data, const ValidityBitmap& mask, const SummationMethod method = SUMMATION_PAIRWISE,
+                  const unsigned int numberOfThreads = 1);
+
+/** Determine if a container type has contiguous storage with a vectorized scan above.
+  * Helpers::ContainsNaN uses the scan for these types. */
+template <typename TVector>
+struct HasValidityKernel : std::false_type {};
+
+template <>
+struct HasValidityKernel<std::vector<float> > : std::true_type {};
+
+template <>
+struct HasValidityKernel<std::vector<double> > : std::true_type {};
+
+} // end namespace
+
+#include "ValidityScan.hpp"
+
+#endif
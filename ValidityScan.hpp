@@ -0,0 +1,72 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2012 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef ValidityScan_HPP
+#define ValidityScan_HPP
+
+#include "ValidityScan.h"
+
+namespace Helpers
+{
+
+/** The index of the lowest set bit of a non-zero 'word'. */
+inline unsigned int LowestSetBit(const uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(word);
+#else
+  unsigned int bit = 0;
+  while(!((word >> bit) & 1))
+  {
+    ++bit;
+  }
+  return bit;
+#endif
+}
+
+template <typename TFunctor>
+void ForEachValidIndex(const ValidityBitmap& mask, TFunctor functor)
+{
+  const std::vector<uint64_t>& words = mask.GetWords();
+  for(size_t wordId = 0; wordId < words.size(); ++wordId)
+  {
+    // Visit only the set bits, clearing each one once it is visited.
+    for(uint64_t word = words[wordId]; word != 0; word &= word - 1)
+    {
+      functor(wordId * 64 + LowestSetBit(word));
+    }
+  }
+}
+
+template <typename T>
+double SumOfValid(const T* data, const ValidityBitmap& mask, const SummationMethod method,
+                  const unsigned int numberOfThreads)
+{
+  auto validValue = [data, &mask](const size_t i)
+  {
+    return mask.IsValid(i) ? static_cast<double>(data[i]) : 0.0;
+  };
+  typedef FunctionIterator<decltype(validValue), double> ValidValueIterator;
+
+  return AccumulateSum<double>(ValidValueIterator(&validValue, 0), ValidValueIterator(&validValue, mask.size()),
+                               method, numberOfThreads);
+}
+
+} // end namespace
+
+#endif